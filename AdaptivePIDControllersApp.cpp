@@ -1,73 +1,444 @@
-// AdaptivePIDControllersApp.cpp : Defines the class behaviors for the application.
-//
-
-#include "stdafx.h"
-#include "AdaptivePIDControllersApp.h"
-#include "MainDlg.h"
-
-#ifdef _DEBUG
-#define new DEBUG_NEW
-#endif
-
-
-// CAdaptivePIDControllersApp
-
-BEGIN_MESSAGE_MAP(CAdaptivePIDControllersApp, CWinApp)
-    ON_COMMAND(ID_HELP, CWinApp::OnHelp)
-END_MESSAGE_MAP()
-
-
-// CAdaptivePIDControllersApp construction
-
-CAdaptivePIDControllersApp::CAdaptivePIDControllersApp()
-{
-    // TODO: add construction code here,
-    // Place all significant initialization in InitInstance
-}
-
-
-// The one and only CAdaptivePIDControllersApp object
-
-CAdaptivePIDControllersApp theApp;
-
-
-// CAdaptivePIDControllersApp initialization
-
-BOOL CAdaptivePIDControllersApp::InitInstance()
-{
-    // InitCommonControls() is required on Windows XP if an application
-    // manifest specifies use of ComCtl32.dll version 6 or later to enable
-    // visual styles.  Otherwise, any window creation will fail.
-    InitCommonControls();
-
-    CWinApp::InitInstance();
-
-    AfxEnableControlContainer();
-
-    // Standard initialization
-    // If you are not using these features and wish to reduce the size
-    // of your final executable, you should remove from the following
-    // the specific initialization routines you do not need
-    // Change the registry key under which our settings are stored
-    // TODO: You should modify this string to be something appropriate
-    // such as the name of your company or organization
-    SetRegistryKey(_T("Local AppWizard-Generated Applications"));
-
-    CMainDlg dlg;
-    m_pMainWnd = &dlg;
-    INT_PTR nResponse = dlg.DoModal();
-    if (nResponse == IDOK)
-    {
-        // TODO: Place code here to handle when the dialog is
-        //  dismissed with OK
-    }
-    else if (nResponse == IDCANCEL)
-    {
-        // TODO: Place code here to handle when the dialog is
-        //  dismissed with Cancel
-    }
-
-    // Since the dialog has been closed, return FALSE so that we exit the
-    //  application, rather than start the application's message pump.
-    return FALSE;
-}
+// AdaptivePIDControllersApp.cpp : Defines the class behaviors for the application.
+//
+
+#include "stdafx.h"
+#include "Mmsystem.h"
+#include "AdaptivePIDControllersApp.h"
+#include "MainDlg.h"
+#include "CTraceFile.h"
+#include "CJournal.h"
+#include "CBenchmark.h"
+#include "CScalingBenchmark.h"
+#include "CIntegratorBenchmark.h"
+#include "CGuidanceBenchmark.h"
+#include "CAdaptationBenchmark.h"
+#include "CAllocationCounter.h"
+#include "CTargetTrajectoryTable.h"
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// Tuning constants for /targettrajectories
+
+const int           TargetTrajectoriesDefaultNumTrajectories    = 256;
+const float         TargetTrajectoriesDefaultSeconds            = 60.0f;
+const float         TargetTrajectoriesTimestep                  = 1.0f / 60.0f;
+
+
+// CAdaptivePIDControllersApp
+
+BEGIN_MESSAGE_MAP(CAdaptivePIDControllersApp, CWinApp)
+    ON_COMMAND(ID_HELP, CWinApp::OnHelp)
+END_MESSAGE_MAP()
+
+
+// CAdaptivePIDControllersApp construction
+
+CAdaptivePIDControllersApp::CAdaptivePIDControllersApp()
+{
+    // TODO: add construction code here,
+    // Place all significant initialization in InitInstance
+
+    m_ExitCode = 0;
+}
+
+
+// The one and only CAdaptivePIDControllersApp object
+
+CAdaptivePIDControllersApp theApp;
+
+
+// CAdaptivePIDControllersApp initialization
+
+BOOL CAdaptivePIDControllersApp::InitInstance()
+{
+    // InitCommonControls() is required on Windows XP if an application
+    // manifest specifies use of ComCtl32.dll version 6 or later to enable
+    // visual styles.  Otherwise, any window creation will fail.
+    InitCommonControls();
+
+    CWinApp::InitInstance();
+
+    AfxEnableControlContainer();
+
+    // Count heap allocations from here on, so that our metrics and
+    // benchmarks can show that stepping the world doesn't make any
+    CAllocationCounter::Install();
+
+    // Standard initialization
+    // If you are not using these features and wish to reduce the size
+    // of your final executable, you should remove from the following
+    // the specific initialization routines you do not need
+    // Change the registry key under which our settings are stored
+    // TODO: You should modify this string to be something appropriate
+    // such as the name of your company or organization
+    SetRegistryKey(_T("Local AppWizard-Generated Applications"));
+
+    // If we were asked to run one of our command line tools, do that
+    // instead of showing the dialog
+
+    if (RunCommandLineTool())
+    {
+        return FALSE;
+    }
+
+    CMainDlg dlg;
+    m_pMainWnd = &dlg;
+    INT_PTR nResponse = dlg.DoModal();
+    if (nResponse == IDOK)
+    {
+        // TODO: Place code here to handle when the dialog is
+        //  dismissed with OK
+    }
+    else if (nResponse == IDCANCEL)
+    {
+        // TODO: Place code here to handle when the dialog is
+        //  dismissed with Cancel
+    }
+
+    // Since the dialog has been closed, return FALSE so that we exit the
+    //  application, rather than start the application's message pump.
+    return FALSE;
+}
+
+//
+// Exit with whatever code our command line tool left us, if it failed
+//
+
+int CAdaptivePIDControllersApp::ExitInstance()
+{
+    int exit_code = CWinApp::ExitInstance();
+
+    return (m_ExitCode != 0) ? m_ExitCode : exit_code;
+}
+
+//
+// Run the command line tool named by our first argument, if any. Returns
+// false if there wasn't one, so that we should show the dialog as normal.
+//
+//      /tracetocsv <trace file> <csv file>     Convert a trace file (such as
+//                                              telemetry) to CSV
+//
+//      /replay <journal file> [<results file>] [<trace file>]
+//                                              Re-run a journal without a window
+//                                              as fast as possible, write where
+//                                              it ended up, and optionally
+//                                              record telemetry. Exits with 1
+//                                              if the journal can't be read.
+//
+//      /benchmark [<results file>] [<name>]    Run every micro-benchmark whose
+//                                              name starts with <name>
+//
+//      /scalingbenchmark [<json file>] [<max pairs>]
+//                                              Time worlds of up to <max pairs>
+//                                              missiles and targets on more
+//                                              and more threads
+//
+//      /trigcheck [<results file>]             Measure the error of the fast
+//                                              trigonometry, and check that it
+//                                              keeps missiles on course
+//
+//      /integratorbenchmark [<results file>]   Compare the accuracy and speed
+//                                              of the missile's integrators
+//
+//      /guidancebenchmark [<results file>]     Compare how long each of the
+//                                              missile's guidance modes takes
+//                                              to hit its target
+//
+//      /adaptationbenchmark [<results file>]   Compare how long each adaptation
+//                                              schedule and rule takes to settle
+//                                              after the missile's drag changes
+//
+//      /targettrajectories [<trajectory file>] [<num trajectories>] [<seconds>]
+//                                              Precompute automatic target
+//                                              paths for CTargetTrajectoryTable
+//
+
+bool CAdaptivePIDControllersApp::RunCommandLineTool()
+{
+    if (__argc < 2)
+    {
+        return false;
+    }
+
+    if (_stricmp(__argv[1], "/tracetocsv") == 0)
+    {
+        if (__argc != 4)
+        {
+            TRACE("Usage: /tracetocsv <trace file> <csv file>\n");
+
+            return true;
+        }
+
+        CTraceReader trace_reader;
+
+        if (!trace_reader.Open(__argv[2]))
+        {
+            TRACE("Unable to read trace file %s\n", __argv[2]);
+
+            return true;
+        }
+
+        if (!trace_reader.ExportCSV(__argv[3]))
+        {
+            TRACE("Unable to write CSV file %s\n", __argv[3]);
+        }
+
+        return true;
+    }
+
+    if (_stricmp(__argv[1], "/replay") == 0)
+    {
+        if ((__argc < 3) || (__argc > 5))
+        {
+            TRACE("Usage: /replay <journal file> [<results file>] [<trace file>]\n");
+
+            m_ExitCode = 1;
+
+            return true;
+        }
+
+        CString results_filename;
+        results_filename.LoadString(IDS_REPLAY_FILENAME);
+
+        if (__argc >= 4)
+        {
+            results_filename = __argv[3];
+        }
+
+        if (!ReplayJournal(__argv[2], results_filename, (__argc == 5) ? __argv[4] : NULL))
+        {
+            m_ExitCode = 1;
+        }
+
+        return true;
+    }
+
+    if (_stricmp(__argv[1], "/benchmark") == 0)
+    {
+        CString results_filename;
+        results_filename.LoadString(IDS_BENCHMARK_FILENAME);
+
+        if (__argc >= 3)
+        {
+            results_filename = __argv[2];
+        }
+
+        CBenchmarkSuite::Run(results_filename, (__argc >= 4) ? __argv[3] : NULL);
+
+        return true;
+    }
+
+    if (_stricmp(__argv[1], "/scalingbenchmark") == 0)
+    {
+        CString results_filename;
+        results_filename.LoadString(IDS_SCALING_BENCHMARK_FILENAME);
+
+        if (__argc >= 3)
+        {
+            results_filename = __argv[2];
+        }
+
+        CScalingBenchmark::Run(results_filename, (__argc >= 4) ? atoi(__argv[3]) : INT_MAX);
+
+        return true;
+    }
+
+    if (_stricmp(__argv[1], "/trigcheck") == 0)
+    {
+        CString results_filename;
+        results_filename.LoadString(IDS_TRIG_CHECK_FILENAME);
+
+        if (__argc >= 3)
+        {
+            results_filename = __argv[2];
+        }
+
+        CBenchmarkSuite::CheckFastTrigonometry(results_filename);
+
+        return true;
+    }
+
+    if (_stricmp(__argv[1], "/integratorbenchmark") == 0)
+    {
+        CString results_filename;
+        results_filename.LoadString(IDS_INTEGRATOR_BENCHMARK_FILENAME);
+
+        if (__argc >= 3)
+        {
+            results_filename = __argv[2];
+        }
+
+        CIntegratorBenchmark::Run(results_filename);
+
+        return true;
+    }
+
+    if (_stricmp(__argv[1], "/guidancebenchmark") == 0)
+    {
+        CString results_filename;
+        results_filename.LoadString(IDS_GUIDANCE_BENCHMARK_FILENAME);
+
+        if (__argc >= 3)
+        {
+            results_filename = __argv[2];
+        }
+
+        CGuidanceBenchmark::Run(results_filename);
+
+        return true;
+    }
+
+    if (_stricmp(__argv[1], "/adaptationbenchmark") == 0)
+    {
+        CString results_filename;
+        results_filename.LoadString(IDS_ADAPTATION_BENCHMARK_FILENAME);
+
+        if (__argc >= 3)
+        {
+            results_filename = __argv[2];
+        }
+
+        CAdaptationBenchmark::Run(results_filename);
+
+        return true;
+    }
+
+    if (_stricmp(__argv[1], "/targettrajectories") == 0)
+    {
+        CString trajectory_filename;
+        trajectory_filename.LoadString(IDS_TARGET_TRAJECTORIES_FILENAME);
+
+        if (__argc >= 3)
+        {
+            trajectory_filename = __argv[2];
+        }
+
+        WriteTargetTrajectories(trajectory_filename,
+            (__argc >= 4) ? atoi(__argv[3])         : TargetTrajectoriesDefaultNumTrajectories,
+            (__argc >= 5) ? (float)atof(__argv[4])  : TargetTrajectoriesDefaultSeconds);
+
+        return true;
+    }
+
+    return false;
+}
+
+//
+// Play back every entry in journal_filename on a new world, as fast as we
+// can, and write how long that took and where the missile ended up to
+// results_filename. If telemetry_filename isn't NULL, record the missile's
+// telemetry to it without dropping any records. Returns false if the
+// journal couldn't be read or the results file couldn't be written.
+//
+
+bool CAdaptivePIDControllersApp::ReplayJournal(const char *journal_filename, const char *results_filename, const char *telemetry_filename)
+{
+    CJournalPlayer      journal_player;
+    CTelemetryRecorder  telemetry_recorder;
+    CWorld              world(false);
+    CTargetPath         target_path;
+    CString             target_path_filename;
+
+    if (!journal_player.Open(journal_filename))
+    {
+        return false;
+    }
+
+    FILE *results_file = fopen(results_filename, "w");
+
+    if (!results_file)
+    {
+        TRACE("Unable to open replay results file %s\n", results_filename);
+
+        return false;
+    }
+
+    // Give the target the same path that the dialog does, in case it was
+    // put under scripted control
+
+    target_path_filename.LoadString(IDS_TARGET_PATH_FILENAME);
+
+    if (target_path.Load(target_path_filename))
+    {
+        world.SetTargetPath(&target_path);
+    }
+
+    if (telemetry_filename)
+    {
+        const CConfig *config = world.GetConfig();
+
+        if (telemetry_recorder.Start(telemetry_filename, config->GetInt(eCONFIG_TELEMETRY_RING_BUFFER_SIZE), config->GetBool(eCONFIG_TELEMETRY_COMPRESS)))
+        {
+            telemetry_recorder.SetBlockWhenFull(true);
+
+            world.SetTelemetryRecorder(&telemetry_recorder);
+        }
+    }
+
+    DWORD start_time = timeGetTime();
+
+    while (journal_player.PlayNextEntry(&world))
+    {
+    }
+
+    DWORD end_time = timeGetTime();
+
+    world.SetTelemetryRecorder(NULL);
+    telemetry_recorder.Stop();
+
+    CMissile *missile = world.GetMissile();
+
+    // Enough digits that two replays which differ at all show it
+
+    fprintf(results_file, "Journal: %s\n", journal_filename);
+    fprintf(results_file, "Replayed %lu timesteps (%.3f simulated seconds) in %lu ms\n", journal_player.GetNumTimestepsPlayed(), world.GetTimeElapsed(), end_time - start_time);
+    fprintf(results_file, "Missile finished at (%.9g, %.9g) with coefficients P = %.9g, I = %.9g, D = %.9g\n",
+        missile->GetPosition()->x, missile->GetPosition()->y,
+        missile->GetSteeringCoefficient(eP_COEFFICIENT), missile->GetSteeringCoefficient(eI_COEFFICIENT), missile->GetSteeringCoefficient(eD_COEFFICIENT));
+
+    fclose(results_file);
+
+    TRACE("Replayed %lu timesteps in %lu ms\n", journal_player.GetNumTimestepsPlayed(), end_time - start_time);
+
+    return true;
+}
+
+//
+// Record num_trajectories target paths, seconds long, with our usual
+// tuning values, and save them to trajectory_filename
+//
+
+void CAdaptivePIDControllersApp::WriteTargetTrajectories(const char *trajectory_filename, int num_trajectories, float seconds)
+{
+    CConfig                 config;
+    CString                 config_filename;
+    CTargetTrajectoryTable  trajectories;
+    int                     num_steps = (int)((seconds / TargetTrajectoriesTimestep) + 0.5f);
+
+    if ((num_trajectories <= 0) || (num_steps <= 0))
+    {
+        TRACE("Usage: /targettrajectories [<trajectory file>] [<num trajectories>] [<seconds>]\n");
+
+        return;
+    }
+
+    config_filename.LoadString(IDS_CONFIG_FILENAME);
+    config.Load(config_filename);
+
+    DWORD start_time = timeGetTime();
+
+    trajectories.Generate(&config, config.Get(eCONFIG_INITIAL_TARGET_MAX_SPEED), BENCHMARK_WORLD_RANDOM_SEED, num_trajectories, TargetTrajectoriesTimestep, num_steps);
+
+    DWORD end_time = timeGetTime();
+
+    if (!trajectories.Save(trajectory_filename))
+    {
+        TRACE("Unable to write target trajectory file %s\n", trajectory_filename);
+
+        return;
+    }
+
+    TRACE("Generated %d target trajectories of %d timesteps in %lu ms\n", num_trajectories, num_steps, end_time - start_time);
+}
@@ -1,31 +1,39 @@
-// AdaptivePIDControllersApp.h : main header file for the PROJECT_NAME application
-//
-
-#pragma once
-
-#ifndef __AFXWIN_H__
-    #error include 'stdafx.h' before including this file for PCH
-#endif
-
-#include "resource.h"       // main symbols
-
-
-// CAdaptivePIDControllersApp:
-// See Intelligent Steering Using Adaptive PID Controllers.cpp for the implementation of this class
-//
-
-class CAdaptivePIDControllersApp : public CWinApp
-{
-public:
-    CAdaptivePIDControllersApp();
-
-// Overrides
-    public:
-    virtual BOOL InitInstance();
-
-// Implementation
-
-    DECLARE_MESSAGE_MAP()
-};
-
+// AdaptivePIDControllersApp.h : main header file for the PROJECT_NAME application
+//
+
+#pragma once
+
+#ifndef __AFXWIN_H__
+    #error include 'stdafx.h' before including this file for PCH
+#endif
+
+#include "resource.h"       // main symbols
+
+
+// CAdaptivePIDControllersApp:
+// See Intelligent Steering Using Adaptive PID Controllers.cpp for the implementation of this class
+//
+
+class CAdaptivePIDControllersApp : public CWinApp
+{
+public:
+    CAdaptivePIDControllersApp();
+
+// Overrides
+    public:
+    virtual BOOL InitInstance();
+    virtual int ExitInstance();
+
+// Implementation
+
+    DECLARE_MESSAGE_MAP()
+
+private:
+    bool RunCommandLineTool();
+    bool ReplayJournal(const char *journal_filename, const char *results_filename, const char *telemetry_filename);
+    void WriteTargetTrajectories(const char *trajectory_filename, int num_trajectories, float seconds);
+
+    int  m_ExitCode;        // Returned by ExitInstance(), so a command line tool can report that it failed
+};
+
 extern CAdaptivePIDControllersApp theApp;
\ No newline at end of file
@@ -0,0 +1,258 @@
+//
+// Benchmark of how quickly the adaptive controller settles on new
+// coefficients after the missile's handling changes.
+//
+// The missiles are set up just as the other benchmarks set them up, so
+// the adaptation schedule and rule are the only things that change
+// between runs. Each missile's coefficients are sampled every
+// AdaptationBenchmarkSamplePeriod after the change, and once the flight
+// is over we look back from the end for the last sample that was outside
+// the tolerance of where they ended up.
+//
+
+#include "stdafx.h"
+#include "math.h"
+#include "CAdaptationBenchmark.h"
+#include "CBenchmark.h"
+#include "CTargetTrajectoryTable.h"
+#include "CWorld.h"
+
+//
+// Tuning constants
+//
+
+const int       AdaptationBenchmarkNumPairs             = 64;
+const float     AdaptationBenchmarkTimestep             = 1.0f / 60.0f;
+const float     AdaptationBenchmarkSecondsBefore        = 30.0f;            // Simulated seconds flown before the drag changes
+const float     AdaptationBenchmarkSecondsAfter         = 150.0f;           // And after
+const float     AdaptationBenchmarkFinalSeconds         = 10.0f;            // Length of the stretch at each end that errors, and where the coefficients end up, are averaged over
+const float     AdaptationBenchmarkSamplePeriod         = 0.25f;            // Seconds between samples of each missile's coefficients
+const float     AdaptationBenchmarkDragFactor           = 10.0f;            // Rotational drag after the change, as a multiple of the initial drag in our config
+const float     AdaptationBenchmarkTolerance            = 0.05f;            // How close a settled coefficient stays to where it ends up, as a fraction of its clamp range
+
+// Names to report each schedule and rule by
+static const char *AdaptationScheduleName[NUM_ADAPTATION_SCHEDULES] =
+{
+    "RoundRobin",
+    "Simultaneous",
+};
+
+static const char *AdaptationRuleName[NUM_UPDATE_RULES] =
+{
+    "MIT",
+    "SignSign",
+    "SignData",
+    "SignError",
+    "NormalizedMIT",
+    "RLS",
+};
+
+//
+// Fly every missile in world with schedule and rule, at targets following
+// trajectories, raising the missiles' rotational drag part of the way
+// through, and work out how long each took to settle afterwards
+//
+
+void CAdaptationBenchmark::Fly(CWorld *world, const CConfig *config, eAdaptationSchedule schedule, eAdaptationRule rule, const CTargetTrajectoryTable *trajectories, SAdaptationBenchmarkResult *result)
+{
+    int         pair                = 0;
+    int         coefficient         = 0;
+    int         sample              = 0;
+    int         steps_before        = (int)((AdaptationBenchmarkSecondsBefore / AdaptationBenchmarkTimestep) + 0.5f);
+    int         steps_after         = (int)((AdaptationBenchmarkSecondsAfter / AdaptationBenchmarkTimestep) + 0.5f);
+    int         final_steps         = (int)((AdaptationBenchmarkFinalSeconds / AdaptationBenchmarkTimestep) + 0.5f);
+    int         steps_per_sample    = (int)((AdaptationBenchmarkSamplePeriod / AdaptationBenchmarkTimestep) + 0.5f);
+    int         num_samples         = steps_after / steps_per_sample;
+    int         num_final_samples   = final_steps / steps_per_sample;
+    float       tolerance[NUM_PID_COEFFICIENTS];
+    double      model_error_before  = 0.0;
+    double      model_error_after   = 0.0;
+    CConfig     adaptation_config   = *config;
+
+    adaptation_config.Set(eCONFIG_STEERING_ADAPTATION_SCHEDULE, (float)schedule);
+    adaptation_config.Set(eCONFIG_STEERING_ADAPTATION_RULE,     (float)rule);
+
+    tolerance[eP_COEFFICIENT] = AdaptationBenchmarkTolerance * (config->Get(eCONFIG_STEERING_MAX_P_COEFFICIENT) - config->Get(eCONFIG_STEERING_MIN_P_COEFFICIENT));
+    tolerance[eI_COEFFICIENT] = AdaptationBenchmarkTolerance * (config->Get(eCONFIG_STEERING_MAX_I_COEFFICIENT) - config->Get(eCONFIG_STEERING_MIN_I_COEFFICIENT));
+    tolerance[eD_COEFFICIENT] = AdaptationBenchmarkTolerance * (config->Get(eCONFIG_STEERING_MAX_D_COEFFICIENT) - config->Get(eCONFIG_STEERING_MIN_D_COEFFICIENT));
+
+    CBenchmarkSuite::SetupWorld(world, &adaptation_config);
+
+    world->SetTargetTrajectories(trajectories);
+
+    // Sample i of coefficient c of pair p is at ((p * NUM_PID_COEFFICIENTS) + c) * num_samples + i
+
+    float *coefficient_samples = new float[AdaptationBenchmarkNumPairs * NUM_PID_COEFFICIENTS * num_samples];
+
+    for (int step = 0; step < steps_before + steps_after; step++)
+    {
+        if (step == steps_before)
+        {
+            world->SetSetting(eWORLD_SETTING_MISSILE_ROTATIONAL_DRAG_FACTOR, config->Get(eCONFIG_INITIAL_MISSILE_ROTATIONAL_DRAG_FACTOR) * AdaptationBenchmarkDragFactor);
+        }
+
+        world->DoTimestep(AdaptationBenchmarkTimestep);
+
+        // Missiles that have hit their targets keep the model error of
+        // their last step until they wake up again, which is close enough
+
+        if ((step >= steps_before - final_steps) && (step < steps_before))
+        {
+            for (pair = 0; pair < AdaptationBenchmarkNumPairs; pair++)
+            {
+                model_error_before += fabs(world->GetMissile(pair)->GetSteeringModelError());
+            }
+        }
+        else if (step >= steps_before + steps_after - final_steps)
+        {
+            for (pair = 0; pair < AdaptationBenchmarkNumPairs; pair++)
+            {
+                model_error_after += fabs(world->GetMissile(pair)->GetSteeringModelError());
+            }
+        }
+
+        if ((step >= steps_before) && (((step - steps_before + 1) % steps_per_sample) == 0))
+        {
+            sample = (step - steps_before + 1) / steps_per_sample - 1;
+
+            for (pair = 0; pair < AdaptationBenchmarkNumPairs; pair++)
+            {
+                for (coefficient = 0; coefficient < NUM_PID_COEFFICIENTS; coefficient++)
+                {
+                    coefficient_samples[(((pair * NUM_PID_COEFFICIENTS) + coefficient) * num_samples) + sample] = world->GetMissile(pair)->GetSteeringCoefficient((ePIDCoefficient)coefficient);
+                }
+            }
+        }
+    }
+
+    result->m_Schedule          = schedule;
+    result->m_Rule              = rule;
+    result->m_NumSettled        = 0;
+    result->m_MeanTimeToSettle  = 0.0f;
+    result->m_MaxTimeToSettle   = 0.0f;
+    result->m_ModelErrorBefore  = (float)(model_error_before / ((double)final_steps * AdaptationBenchmarkNumPairs));
+    result->m_ModelErrorAfter   = (float)(model_error_after / ((double)final_steps * AdaptationBenchmarkNumPairs));
+
+    for (coefficient = 0; coefficient < NUM_PID_COEFFICIENTS; coefficient++)
+    {
+        result->m_FinalCoefficient[coefficient] = 0.0f;
+    }
+
+    for (pair = 0; pair < AdaptationBenchmarkNumPairs; pair++)
+    {
+        // A missile has settled at the first sample from which all of its
+        // coefficients stay within tolerance of their mean over the final
+        // stretch, as long as that's before the final stretch starts
+
+        int first_settled_sample = 0;
+
+        for (coefficient = 0; coefficient < NUM_PID_COEFFICIENTS; coefficient++)
+        {
+            const float*    samples         = &coefficient_samples[((pair * NUM_PID_COEFFICIENTS) + coefficient) * num_samples];
+            float           final_value     = 0.0f;
+
+            for (sample = num_samples - num_final_samples; sample < num_samples; sample++)
+            {
+                final_value += samples[sample];
+            }
+
+            final_value /= num_final_samples;
+
+            result->m_FinalCoefficient[coefficient] += final_value / AdaptationBenchmarkNumPairs;
+
+            for (sample = num_samples - 1; sample >= first_settled_sample; sample--)
+            {
+                if (fabs(samples[sample] - final_value) > tolerance[coefficient])
+                {
+                    first_settled_sample = sample + 1;
+
+                    break;
+                }
+            }
+        }
+
+        if (first_settled_sample <= num_samples - num_final_samples)
+        {
+            float time_to_settle = first_settled_sample * AdaptationBenchmarkSamplePeriod;
+
+            result->m_NumSettled++;
+            result->m_MeanTimeToSettle  += time_to_settle;
+            result->m_MaxTimeToSettle   = max(result->m_MaxTimeToSettle, time_to_settle);
+        }
+    }
+
+    delete [] coefficient_samples;
+
+    result->m_SettledFraction = (float)result->m_NumSettled / AdaptationBenchmarkNumPairs;
+
+    if (result->m_NumSettled > 0)
+    {
+        result->m_MeanTimeToSettle /= result->m_NumSettled;
+    }
+}
+
+//
+// Fly every adaptation schedule with every rule, and write the results to
+// results_filename. Returns false if the results file couldn't be written.
+//
+
+bool CAdaptationBenchmark::Run(const char *results_filename)
+{
+    CConfig                     config;
+    CWorld                      world(false);
+    CTargetTrajectoryTable      trajectories;
+    SAdaptationBenchmarkResult  result;
+    int                         num_steps = (int)(((AdaptationBenchmarkSecondsBefore + AdaptationBenchmarkSecondsAfter) / AdaptationBenchmarkTimestep) + 0.5f);
+
+    FILE *results_file = fopen(results_filename, "w");
+
+    if (!results_file)
+    {
+        TRACE("Unable to open adaptation benchmark results file %s\n", results_filename);
+
+        return false;
+    }
+
+    world.SetNumPairs(AdaptationBenchmarkNumPairs);
+
+    trajectories.Generate(&config, config.Get(eCONFIG_INITIAL_TARGET_MAX_SPEED), BENCHMARK_WORLD_RANDOM_SEED, AdaptationBenchmarkNumPairs, AdaptationBenchmarkTimestep, num_steps);
+
+    fprintf(results_file, "%d missiles flown for %g seconds, then for %g seconds more with %g times the rotational drag.\n",
+        AdaptationBenchmarkNumPairs, AdaptationBenchmarkSecondsBefore, AdaptationBenchmarkSecondsAfter, AdaptationBenchmarkDragFactor);
+    fprintf(results_file, "Settled means every coefficient stays within %g%% of its range of where it ends up. Model errors are the mean over %g seconds.\n\n",
+        AdaptationBenchmarkTolerance * 100.0f, AdaptationBenchmarkFinalSeconds);
+    fprintf(results_file, "%-14s %-14s %10s %14s %14s %8s %8s %8s %14s %14s\n",
+        "Schedule", "Rule", "Settled", "Mean time (s)", "Max time (s)", "P", "I", "D", "Error before", "Error after");
+
+    for (int schedule = 0; schedule < NUM_ADAPTATION_SCHEDULES; schedule++)
+    {
+        for (int rule = 0; rule < NUM_UPDATE_RULES; rule++)
+        {
+            // Recursive least squares adapts every coefficient at once
+            // whatever the schedule, so there's no need to fly it twice
+
+            bool        any_schedule    = (rule == eADAPT_RECURSIVE_LEAST_SQUARES_RULE);
+            const char* schedule_name   = any_schedule ? "Any" : AdaptationScheduleName[schedule];
+
+            if (any_schedule && (schedule != eADAPT_SIMULTANEOUS))
+            {
+                continue;
+            }
+
+            Fly(&world, &config, (eAdaptationSchedule)schedule, (eAdaptationRule)rule, &trajectories, &result);
+
+            fprintf(results_file, "%-14s %-14s %9.1f%% %14.2f %14.2f %8.3f %8.3f %8.3f %14.3f %14.3f\n",
+                schedule_name, AdaptationRuleName[rule], result.m_SettledFraction * 100.0f, result.m_MeanTimeToSettle, result.m_MaxTimeToSettle,
+                result.m_FinalCoefficient[eP_COEFFICIENT], result.m_FinalCoefficient[eI_COEFFICIENT], result.m_FinalCoefficient[eD_COEFFICIENT],
+                result.m_ModelErrorBefore, result.m_ModelErrorAfter);
+            fflush(results_file);
+
+            TRACE("%s with %s: %.1f%% settled, mean time to settle %.2f s\n",
+                schedule_name, AdaptationRuleName[rule], result.m_SettledFraction * 100.0f, result.m_MeanTimeToSettle);
+        }
+    }
+
+    fclose(results_file);
+
+    return true;
+}
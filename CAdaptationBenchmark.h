@@ -0,0 +1,57 @@
+//
+// Benchmark of how quickly the adaptive controller settles on new
+// coefficients after the missile's handling changes, with each adaptation
+// schedule and rule.
+//
+// We fly a squadron of missiles under adaptive PID control against
+// automatically moving targets until their coefficients have had time to
+// adapt to the missile as it starts, then suddenly raise its rotational
+// drag, as happens when the drag slider is dragged up in the demo, and
+// keep flying. Each missile has settled once its P, I and D coefficients
+// stay within AdaptationBenchmarkTolerance of where they end up for the
+// rest of the flight. The target paths are precomputed into a
+// CTargetTrajectoryTable, so every schedule and rule sees exactly the same
+// targets.
+//
+// We report the fraction of missiles that settled, the mean and longest
+// time they took in simulated seconds, the mean coefficients they ended
+// up with, and how far the missiles were from the behavior their model
+// asks for before the change and at the end.
+//
+// Run the demo with /adaptationbenchmark [<results file>]. Results go to
+// Adaptation.txt if no file is given.
+//
+
+#ifndef CADAPTATIONBENCHMARK_H
+#define CADAPTATIONBENCHMARK_H
+
+#include "CModelReferenceAdaptiveController.h"
+
+class CConfig;
+class CWorld;
+class CTargetTrajectoryTable;
+
+// Results of flying every missile with one adaptation schedule and rule
+struct SAdaptationBenchmarkResult
+{
+    eAdaptationSchedule     m_Schedule;
+    eAdaptationRule         m_Rule;
+    int                     m_NumSettled;
+    float                   m_SettledFraction;              // Of all of our missiles
+    float                   m_MeanTimeToSettle;             // In simulated seconds after the change, of those that settled
+    float                   m_MaxTimeToSettle;
+    float                   m_FinalCoefficient[NUM_PID_COEFFICIENTS];   // Mean over every missile
+    float                   m_ModelErrorBefore;             // Mean absolute model error just before the change
+    float                   m_ModelErrorAfter;              // And at the end
+};
+
+class CAdaptationBenchmark
+{
+public:
+    static bool             Run(const char *results_filename);
+
+private:
+    static void             Fly(CWorld *world, const CConfig *config, eAdaptationSchedule schedule, eAdaptationRule rule, const CTargetTrajectoryTable *trajectories, SAdaptationBenchmarkResult *result);
+};
+
+#endif
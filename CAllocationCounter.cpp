@@ -0,0 +1,69 @@
+//
+// Counts the heap allocations made through the C runtime
+//
+
+#include "stdafx.h"
+#include "crtdbg.h"
+#include "CAllocationCounter.h"
+
+volatile LONG CAllocationCounter::m_Count = 0;
+
+#ifdef _DEBUG
+
+_CRT_ALLOC_HOOK CAllocationCounter::m_PreviousHook = NULL;
+
+//
+// Start counting. Safe to call more than once.
+//
+
+void CAllocationCounter::Install()
+{
+    _CRT_ALLOC_HOOK previous_hook = _CrtSetAllocHook(AllocationHook);
+
+    if (previous_hook != AllocationHook)
+    {
+        m_PreviousHook = previous_hook;
+    }
+}
+
+bool CAllocationCounter::IsAvailable()
+{
+    return true;
+}
+
+//
+// Called by the CRT for every allocation, reallocation and free. Counts
+// the first two, then passes everything on to whichever hook was there
+// before us.
+//
+
+int __cdecl CAllocationCounter::AllocationHook(int allocation_type, void *user_data, size_t size, int block_type,
+    long request_number, const unsigned char *filename, int line_number)
+{
+    // The block type isn't filled in for frees
+
+    if (((allocation_type == _HOOK_ALLOC) || (allocation_type == _HOOK_REALLOC)) && (block_type != _CRT_BLOCK))
+    {
+        InterlockedIncrement(&m_Count);
+    }
+
+    if (m_PreviousHook)
+    {
+        return m_PreviousHook(allocation_type, user_data, size, block_type, request_number, filename, line_number);
+    }
+
+    return TRUE;
+}
+
+#else
+
+void CAllocationCounter::Install()
+{
+}
+
+bool CAllocationCounter::IsAvailable()
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,35 @@
+//
+// Counts the heap allocations made through the C runtime, so that we can
+// check that code that shouldn't allocate, such as stepping the world,
+// really doesn't.
+//
+// Counting needs the CRT's debug allocation hook, so it only works in
+// Debug builds; IsAvailable() says whether it does, and GetCount() stays
+// at zero when it doesn't. Call Install() once at startup. The count
+// covers every thread, and leaves out the CRT's own internal blocks, such
+// as stdio buffers.
+//
+
+#ifndef CALLOCATIONCOUNTER_H
+#define CALLOCATIONCOUNTER_H
+
+class CAllocationCounter
+{
+public:
+    static void             Install();
+    static bool             IsAvailable();
+
+    static LONG             GetCount()              { return m_Count; }
+
+private:
+#ifdef _DEBUG
+    static int __cdecl      AllocationHook(int allocation_type, void *user_data, size_t size, int block_type,
+                                long request_number, const unsigned char *filename, int line_number);
+
+    static _CRT_ALLOC_HOOK  m_PreviousHook;         // Whatever hook was installed before ours, such as MFC's
+#endif
+
+    static volatile LONG    m_Count;                // Allocations and reallocations since Install()
+};
+
+#endif
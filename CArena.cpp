@@ -0,0 +1,88 @@
+//
+// A bump allocator: one block of memory that's handed out front to back
+//
+
+#include "stdafx.h"
+#include "malloc.h"
+#include "CArena.h"
+
+//
+// Tuning constants
+//
+
+const size_t ArenaAlignment = 16;       // Every allocation starts on a multiple of this many bytes. Enough for SSE.
+
+//
+// Make sure we have room for capacity bytes of allocations. Everything
+// allocated so far is freed, so only call this before allocating again
+// from the front.
+//
+
+void CArena::Reserve(size_t capacity)
+{
+    m_Used = 0;
+
+    if (capacity <= m_Capacity)
+    {
+        return;
+    }
+
+    Free();
+
+    m_pBlock = (BYTE *)_aligned_malloc(capacity, ArenaAlignment);
+
+    if (!m_pBlock)
+    {
+        TRACE("Unable to allocate an arena of %lu bytes\n", (unsigned long)capacity);
+
+        AfxThrowMemoryException();
+    }
+
+    m_Capacity = capacity;
+}
+
+//
+// Hand out the next size bytes of our block, rounded up so that the
+// allocation after it stays aligned. Running out of room means whoever
+// reserved it got their sums wrong, so that throws.
+//
+
+void* CArena::Allocate(size_t size)
+{
+    size_t aligned_size = GetArraySize(size, 1);
+
+    if (aligned_size > (m_Capacity - m_Used))
+    {
+        TRACE("Arena of %lu bytes has no room for %lu more\n", (unsigned long)m_Capacity, (unsigned long)size);
+        ASSERT(FALSE);
+
+        AfxThrowMemoryException();
+    }
+
+    void *allocation = m_pBlock + m_Used;
+
+    m_Used += aligned_size;
+
+    return allocation;
+}
+
+//
+// Number of bytes of our block that an array of count elements of
+// element_size bytes takes up
+//
+
+size_t CArena::GetArraySize(size_t element_size, int count)
+{
+    ASSERT(count >= 0);
+
+    return (((element_size * count) + ArenaAlignment - 1) / ArenaAlignment) * ArenaAlignment;
+}
+
+void CArena::Free()
+{
+    _aligned_free(m_pBlock);
+
+    m_pBlock    = NULL;
+    m_Capacity  = 0;
+    m_Used      = 0;
+}
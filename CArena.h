@@ -0,0 +1,62 @@
+//
+// A bump allocator: one block of memory that's handed out front to back.
+//
+// Allocating is just moving a pointer along, and everything is freed at
+// once, by Reset() or when the arena is destroyed. That means nothing
+// allocated from an arena gets its destructor called, so only put things
+// in one that don't own anything outside of it.
+//
+// Reserve() makes sure the block is big enough for what's about to be
+// allocated, and is the only thing that goes to the heap, and then only
+// when the block has to grow. Work out how much to reserve with
+// GetArraySize(), so that the same sizes are used as Allocate().
+//
+
+#ifndef CARENA_H
+#define CARENA_H
+
+#include <new>
+
+class CArena
+{
+public:
+    CArena()                                        : m_pBlock(NULL), m_Capacity(0), m_Used(0) { }
+    ~CArena()                                       { Free(); }
+
+    void                Reserve(size_t capacity);
+    void                Reset()                     { m_Used = 0; }
+
+    void*               Allocate(size_t size);
+
+    // Allocate and default construct count objects of type T
+    template <class T>
+    T*                  AllocateArray(int count)
+    {
+        T *array = (T *)Allocate(sizeof(T) * count);
+
+        for (int i = 0; i < count; i++)
+        {
+            new (&array[i]) T;
+        }
+
+        return array;
+    }
+
+    size_t              GetCapacity() const         { return m_Capacity; }
+    size_t              GetUsed() const             { return m_Used; }
+
+    static size_t       GetArraySize(size_t element_size, int count);
+
+private:
+    // Not copyable, since we own our block
+    CArena(const CArena &arena);
+    CArena&             operator=(const CArena &arena);
+
+    void                Free();
+
+    BYTE*               m_pBlock;                   // Aligned to ArenaAlignment
+    size_t              m_Capacity;                 // Size of m_pBlock, in bytes
+    size_t              m_Used;                     // Bytes handed out so far, from the front of m_pBlock
+};
+
+#endif
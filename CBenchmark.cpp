@@ -0,0 +1,1009 @@
+//
+// Micro-benchmarks for the hot paths of our controllers, math and world,
+// so that the effect of a performance change can be measured.
+//
+// Each benchmark repeats one operation, such as a PID controller Record(),
+// some number of times. Before timing it, we warm it up by running it with
+// more and more operations until one run takes at least
+// BenchmarkMinRunSeconds, which also tells us how many operations to use.
+// We then time BenchmarkNumRepetitions runs of that many operations, and
+// report the median time per operation, along with the fastest and slowest
+// runs so that noisy results stand out.
+//
+
+#include "stdafx.h"
+#include "math.h"
+#include "CBenchmark.h"
+#include "CStopwatch.h"
+#include "CRandom.h"
+#include "CGraph.h"
+#include "CWorld.h"
+#include "CWorldPool.h"
+#include "CVector2Batch.h"
+#include "CTargetPath.h"
+#include "CAllocationCounter.h"
+
+//
+// Tuning constants
+//
+
+const double    BenchmarkMinRunSeconds      = 0.05;     // Shortest that one timed run of a benchmark can be
+const int       BenchmarkNumRepetitions     = 11;       // Number of timed runs of each benchmark. Odd, so that there's a middle one.
+const int       BenchmarkMaxNumOperations   = 1 << 30;  // Most operations we'll put in one run, in case something takes no time at all
+
+const int       BenchmarkNumInputs          = 1024;     // Number of precomputed inputs we cycle through. Must be a power of 2.
+const float     BenchmarkTimestep           = 1.0f / 60.0f;
+const int       BenchmarkWorldNumPairs      = 1000;     // Pairs in the world we make over and over again
+const int       BenchmarkPathNumKeyframes   = 17;       // Keyframes around the circle our target path follows, counting the start twice
+const float     BenchmarkPathSeconds        = 24.0f;    // Time taken to go around it once
+
+// Checking the fast trigonometry
+const int       TrigCheckNumSamples         = 1 << 20;  // Number of inputs to compare each function over
+const int       TrigCheckNumPairs           = 16;       // Number of missiles and targets to compare trajectories of
+const float     TrigCheckSeconds            = 30.0f;    // Simulated time to compare trajectories over
+const float     TrigCheckTolerance          = 20.0f;    // Furthest apart the same missile can be in the two worlds, in world units. About a pixel.
+
+//
+// Inputs and objects shared by our benchmarks. Inputs are precomputed so
+// that generating them isn't part of what we time.
+//
+
+struct SBenchmarkInput
+{
+    float   m_Error;                    // Heading error, in degrees
+    float   m_ModelBehaviorValue;
+    float   m_ActualBehaviorValue;
+    float   m_Angle;                    // In degrees
+    float   m_X;
+    float   m_Y;
+};
+
+static SBenchmarkInput                      BenchmarkInput[BenchmarkNumInputs];
+
+static CPidController                       BenchmarkPidController;
+static CModelReferenceAdaptiveController    BenchmarkAdaptiveController;
+static CRecursiveLeastSquares               BenchmarkEstimator;
+static float                                BenchmarkRegressors[BenchmarkNumInputs * RLS_NUM_PARAMETERS];
+static float                                BenchmarkObservations[BenchmarkNumInputs];
+static CConfig                              BenchmarkConfig;
+static CGraph*                              BenchmarkGraph      = NULL;
+static CWorld*                              BenchmarkWorld      = NULL;
+static CWorldPool*                          BenchmarkWorldPool  = NULL;
+static CVector2                             BenchmarkVector;
+static CVector2                             BenchmarkVectors[BenchmarkNumInputs];
+static float                                BenchmarkAngles[BenchmarkNumInputs];
+static CVector2Batch                        BenchmarkBatch;
+static CVector2Batch                        BenchmarkRotations;
+static float                                BenchmarkLengths[BenchmarkNumInputs];
+static CTargetPath                          BenchmarkTargetPath;
+static double                               BenchmarkPathTimes[BenchmarkNumInputs];
+
+// Results of our benchmarks are added into here, so that the compiler
+// can't throw away the work that produced them
+static volatile float                       BenchmarkSink   = 0.0f;
+
+//
+// Fill in BenchmarkInput with values that look like a missile chasing
+// its target: a heading error that swings back and forth, with some noise
+//
+
+static void SetupInputs()
+{
+    CRandom random(12345);
+
+    for (int i = 0; i < BenchmarkNumInputs; i++)
+    {
+        float noise                                 = random.GetFloat() - 0.5f;
+
+        BenchmarkInput[i].m_Error                   = 90.0f * (float)sin(i * 0.05f) + noise;
+        BenchmarkInput[i].m_ModelBehaviorValue      = 40.0f * (float)cos(i * 0.05f);
+        BenchmarkInput[i].m_ActualBehaviorValue     = 45.0f * (float)cos(i * 0.05f) + noise;
+        BenchmarkInput[i].m_Angle                   = (random.GetFloat() * 360.0f) - 180.0f;
+        BenchmarkInput[i].m_X                       = (random.GetFloat() * 2.0f) - 1.0f;
+        BenchmarkInput[i].m_Y                       = (random.GetFloat() * 2.0f) - 1.0f;
+    }
+}
+
+//
+// CPidController, with the derivative estimator given by parameter
+//
+
+static void SetupPidController(int parameter)
+{
+    BenchmarkPidController.Clear();
+    BenchmarkPidController.SetCoefficients(BenchmarkConfig.Get(eCONFIG_INITIAL_STEERING_P_COEFFICIENT), BenchmarkConfig.Get(eCONFIG_INITIAL_STEERING_I_COEFFICIENT), BenchmarkConfig.Get(eCONFIG_INITIAL_STEERING_D_COEFFICIENT));
+    BenchmarkPidController.SetDerivativeEstimator((eDerivativeEstimator)parameter, BenchmarkConfig.Get(eCONFIG_STEERING_DERIVATIVE_TIME_CONSTANT));
+
+    // Fill up the controller's history so that every operation does the same work
+
+    for (int i = 0; i < NUM_ERROR_SLOTS; i++)
+    {
+        BenchmarkPidController.Record(BenchmarkInput[i].m_Error, BenchmarkTimestep);
+    }
+}
+
+static void RunPidRecord(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkPidController.Record(BenchmarkInput[i & (BenchmarkNumInputs - 1)].m_Error, BenchmarkTimestep);
+    }
+
+    BenchmarkSink += BenchmarkPidController.GetErrorIntegral();
+}
+
+static void RunPidGetOutput(int num_operations)
+{
+    float total = 0.0f;
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        total += BenchmarkPidController.GetOutput();
+    }
+
+    BenchmarkSink += total;
+}
+
+static void RunPidRecordAndGetOutput(int num_operations)
+{
+    float total = 0.0f;
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkPidController.Record(BenchmarkInput[i & (BenchmarkNumInputs - 1)].m_Error, BenchmarkTimestep);
+
+        total += BenchmarkPidController.GetOutput();
+    }
+
+    BenchmarkSink += total;
+}
+
+//
+// CPidController with the integral mode given by parameter, steering a
+// missile whose angular acceleration is clamped, so that the integral has
+// something to wind up against
+//
+
+static void SetupPidIntegral(int parameter)
+{
+    SetupPidController(eDERIVATIVE_DIFFERENCE);
+
+    BenchmarkPidController.SetIntegralMode((eIntegralMode)parameter, BenchmarkConfig.Get(eCONFIG_STEERING_INTEGRAL_TIME_CONSTANT), BenchmarkConfig.Get(eCONFIG_STEERING_TRACKING_TIME_CONSTANT));
+}
+
+static void RunPidRecordAndClampOutput(int num_operations)
+{
+    float total         = 0.0f;
+    float max_output    = BenchmarkConfig.Get(eCONFIG_INITIAL_MISSILE_MAX_ANGULAR_ACCELERATION);
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkPidController.Record(BenchmarkInput[i & (BenchmarkNumInputs - 1)].m_Error, BenchmarkTimestep);
+
+        float output            = BenchmarkPidController.GetOutput();
+        float clamped_output    = Clamp(output, -max_output, max_output);
+
+        BenchmarkPidController.SetUnappliedOutput(output - clamped_output);
+
+        total += clamped_output;
+    }
+
+    BenchmarkSink += total;
+}
+
+static void RunPidRecordAndGetDerivative(int num_operations)
+{
+    float total = 0.0f;
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkPidController.Record(BenchmarkInput[i & (BenchmarkNumInputs - 1)].m_Error, BenchmarkTimestep);
+
+        total += BenchmarkPidController.GetErrorDerivative();
+    }
+
+    BenchmarkSink += total;
+}
+
+//
+// CModelReferenceAdaptiveController, set up the same way as our missile's
+// steering controller but with the adaptation rule given by parameter
+//
+
+static void SetupAdaptiveController(int parameter)
+{
+    BenchmarkAdaptiveController.Reset();
+
+    BenchmarkAdaptiveController.SetAdaptationRule((eAdaptationRule)parameter);
+    BenchmarkAdaptiveController.SetTimeslice(BenchmarkConfig.Get(eCONFIG_STEERING_TIMESLICE));
+    BenchmarkAdaptiveController.SetAdaptationSchedule((eAdaptationSchedule)BenchmarkConfig.GetInt(eCONFIG_STEERING_ADAPTATION_SCHEDULE), BenchmarkConfig.Get(eCONFIG_STEERING_SENSITIVITY_TIME_CONSTANT));
+    BenchmarkAdaptiveController.SetRecursiveLeastSquares(BenchmarkConfig.Get(eCONFIG_STEERING_RLS_FORGETTING_FACTOR), BenchmarkConfig.Get(eCONFIG_STEERING_RLS_INITIAL_COVARIANCE), BenchmarkConfig.Get(eCONFIG_STEERING_RLS_COVARIANCE_RESET_FRACTION));
+
+    for (int i = 0; i < NUM_PID_COEFFICIENTS; i++)
+    {
+        ePIDCoefficient coefficient = (ePIDCoefficient)i;
+
+        BenchmarkAdaptiveController.SetCoefficientClamp(coefficient,    BenchmarkConfig.Get((eConfigValue)(eCONFIG_STEERING_MIN_P_COEFFICIENT + (i * 2))), BenchmarkConfig.Get((eConfigValue)(eCONFIG_STEERING_MAX_P_COEFFICIENT + (i * 2))));
+        BenchmarkAdaptiveController.SetUpdateThreshold(coefficient,     BenchmarkConfig.Get((eConfigValue)(eCONFIG_STEERING_P_UPDATE_THRESHOLD + i)));
+        BenchmarkAdaptiveController.SetAdaptationGain(coefficient,      BenchmarkConfig.Get((eConfigValue)(eCONFIG_STEERING_P_ADAPTATION_GAIN + i)));
+        BenchmarkAdaptiveController.SetAlpha(coefficient,               BenchmarkConfig.Get((eConfigValue)(eCONFIG_STEERING_P_ALPHA + i)));
+    }
+
+    BenchmarkAdaptiveController.SetCoefficients(BenchmarkConfig.Get(eCONFIG_INITIAL_STEERING_P_COEFFICIENT), BenchmarkConfig.Get(eCONFIG_INITIAL_STEERING_I_COEFFICIENT), BenchmarkConfig.Get(eCONFIG_INITIAL_STEERING_D_COEFFICIENT));
+}
+
+static void RunAdaptiveControllerUpdate(int num_operations)
+{
+    float total = 0.0f;
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        const SBenchmarkInput *input = &BenchmarkInput[i & (BenchmarkNumInputs - 1)];
+
+        BenchmarkAdaptiveController.Update(BenchmarkTimestep, input->m_Error, input->m_ModelBehaviorValue, input->m_ActualBehaviorValue);
+
+        total += BenchmarkAdaptiveController.GetOutput();
+    }
+
+    BenchmarkSink += total;
+}
+
+//
+// CRecursiveLeastSquares, set up the same way as our missile's steering
+// controller sets up its own. Each input's regressor and observation are
+// made from its values the way the controller makes them from its terms
+// and model error.
+//
+
+static void SetupRecursiveLeastSquares(int parameter)
+{
+    float initial_coefficients[RLS_NUM_PARAMETERS] =
+    {
+        BenchmarkConfig.Get(eCONFIG_INITIAL_STEERING_P_COEFFICIENT),
+        BenchmarkConfig.Get(eCONFIG_INITIAL_STEERING_I_COEFFICIENT),
+        BenchmarkConfig.Get(eCONFIG_INITIAL_STEERING_D_COEFFICIENT),
+    };
+
+    float time_constant = BenchmarkConfig.Get(eCONFIG_STEERING_SENSITIVITY_TIME_CONSTANT);
+
+    BenchmarkEstimator.SetInitialCovariance(BenchmarkConfig.Get(eCONFIG_STEERING_RLS_INITIAL_COVARIANCE), BenchmarkConfig.Get(eCONFIG_STEERING_RLS_COVARIANCE_RESET_FRACTION));
+    BenchmarkEstimator.ResetCovariance();
+    BenchmarkEstimator.SetEstimate(initial_coefficients);
+
+    for (int i = 0; i < BenchmarkNumInputs; i++)
+    {
+        const SBenchmarkInput*  input       = &BenchmarkInput[i];
+        float*                  regressor   = &BenchmarkRegressors[i * RLS_NUM_PARAMETERS];
+
+        regressor[0] = -time_constant * (float)fabs(input->m_Error);
+        regressor[1] = -time_constant * input->m_ModelBehaviorValue * Sign(input->m_Error);
+        regressor[2] = -time_constant * input->m_ActualBehaviorValue * Sign(input->m_Error);
+
+        BenchmarkObservations[i] = (input->m_ModelBehaviorValue - input->m_ActualBehaviorValue) +
+            (regressor[0] * initial_coefficients[0]) + (regressor[1] * initial_coefficients[1]) + (regressor[2] * initial_coefficients[2]);
+    }
+}
+
+//
+// One estimator updated over and over. The forgetting factor for our
+// timestep is worked out once beforehand, as each missile's steering
+// controller keeps it from one step to the next.
+//
+
+static void RunRecursiveLeastSquaresUpdate(int num_operations)
+{
+    float total                     = 0.0f;
+    float step_forgetting_factor    = CRecursiveLeastSquares::GetStepForgettingFactor(BenchmarkConfig.Get(eCONFIG_STEERING_RLS_FORGETTING_FACTOR), BenchmarkTimestep);
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        int input = i & (BenchmarkNumInputs - 1);
+
+        total += BenchmarkEstimator.Update(&BenchmarkRegressors[input * RLS_NUM_PARAMETERS], BenchmarkObservations[input], step_forgetting_factor);
+    }
+
+    BenchmarkSink += total;
+}
+
+//
+// CGraph and CMissile::GetModelBehaviorValue(), set up with our missile's
+// steering model
+//
+
+static void SetupGraph(int parameter)
+{
+    delete BenchmarkGraph;
+
+    BenchmarkGraph = new CGraph(MISSILE_STEERING_MODEL_NUM_CONTROL_POINTS, BenchmarkConfig.Get(eCONFIG_MISSILE_STEERING_MODEL_MIN_X_VALUE), BenchmarkConfig.Get(eCONFIG_MISSILE_STEERING_MODEL_MAX_X_VALUE));
+
+    for (int i = 0; i < MISSILE_STEERING_MODEL_NUM_CONTROL_POINTS; i++)
+    {
+        BenchmarkGraph->SetControlPoint(i, BenchmarkConfig.Get((eConfigValue)(eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_0 + i)));
+    }
+}
+
+static void RunGraphGetValue(int num_operations)
+{
+    float total = 0.0f;
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        total += BenchmarkGraph->GetValue((float)fabs(BenchmarkInput[i & (BenchmarkNumInputs - 1)].m_Error));
+    }
+
+    BenchmarkSink += total;
+}
+
+static void RunMissileGetModelBehaviorValue(int num_operations)
+{
+    CMissile    *missile    = BenchmarkWorld->GetMissile();
+    float       total       = 0.0f;
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        total += missile->GetModelBehaviorValue(BenchmarkInput[i & (BenchmarkNumInputs - 1)].m_Error);
+    }
+
+    BenchmarkSink += total;
+}
+
+//
+// CVector2
+//
+
+static void SetupTrigonometry(int parameter)
+{
+    SetFastTrigonometry(parameter != 0);
+}
+
+static void SetupVector(int parameter)
+{
+    SetupTrigonometry(parameter);
+
+    BenchmarkVector.x = 0.0f;
+    BenchmarkVector.y = 1.0f;
+}
+
+static void SetupVectorBatch(int parameter)
+{
+    SetupTrigonometry(parameter);
+
+    for (int i = 0; i < BenchmarkNumInputs; i++)
+    {
+        BenchmarkVectors[i].x   = BenchmarkInput[i].m_X;
+        BenchmarkVectors[i].y   = BenchmarkInput[i].m_Y;
+        BenchmarkAngles[i]      = BenchmarkInput[i].m_Angle;
+    }
+}
+
+static void RunVectorRotate(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkVector.Rotate(BenchmarkInput[i & (BenchmarkNumInputs - 1)].m_Angle);
+    }
+
+    BenchmarkSink += BenchmarkVector.x;
+}
+
+static void RunVectorNormalize(int num_operations)
+{
+    float total = 0.0f;
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        const SBenchmarkInput *input = &BenchmarkInput[i & (BenchmarkNumInputs - 1)];
+
+        CVector2 vector(input->m_X, input->m_Y);
+
+        vector.Normalize();
+
+        total += vector.x;
+    }
+
+    BenchmarkSink += total;
+}
+
+static void RunVectorGetAngle(int num_operations)
+{
+    float total = 0.0f;
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        const SBenchmarkInput *input = &BenchmarkInput[i & (BenchmarkNumInputs - 1)];
+
+        CVector2 vector(input->m_X, input->m_Y);
+
+        total += vector.GetAngle();
+    }
+
+    BenchmarkSink += total;
+}
+
+static void RunVectorGetAngles(int num_operations)
+{
+    float total = 0.0f;
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        GetAngles(BenchmarkVectors, BenchmarkAngles, BenchmarkNumInputs);
+
+        total += BenchmarkAngles[i & (BenchmarkNumInputs - 1)];
+    }
+
+    BenchmarkSink += total;
+}
+
+static void RunVectorRotateVectors(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        RotateVectors(BenchmarkVectors, BenchmarkAngles, BenchmarkNumInputs);
+    }
+
+    BenchmarkSink += BenchmarkVectors[0].x;
+}
+
+//
+// CVector2Batch, with the same vectors as above, and a rotation each of
+// up to a couple of degrees
+//
+
+static void SetupBatch(int parameter)
+{
+    BenchmarkBatch.SetSize(BenchmarkNumInputs);
+    BenchmarkRotations.SetSize(BenchmarkNumInputs);
+
+    for (int i = 0; i < BenchmarkNumInputs; i++)
+    {
+        BenchmarkBatch.Set(i, CVector2(BenchmarkInput[i].m_X, BenchmarkInput[i].m_Y));
+        BenchmarkRotations.Set(i, GetRotation(BenchmarkInput[i].m_Angle * 0.01f));
+    }
+}
+
+static void RunBatchAdd(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkBatch.Add(BenchmarkRotations);
+    }
+
+    BenchmarkSink += BenchmarkBatch.GetX()[0];
+}
+
+static void RunBatchScale(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        // Alternate so that we never overflow
+        BenchmarkBatch.Scale((i & 1) ? 2.0f : 0.5f);
+    }
+
+    BenchmarkSink += BenchmarkBatch.GetX()[0];
+}
+
+static void RunBatchNormalize(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkBatch.Normalize();
+    }
+
+    BenchmarkSink += BenchmarkBatch.GetX()[0];
+}
+
+static void RunBatchRotateBy(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkBatch.RotateBy(BenchmarkRotations);
+    }
+
+    BenchmarkSink += BenchmarkBatch.GetX()[0];
+}
+
+static void RunBatchGetLengths(int num_operations)
+{
+    float total = 0.0f;
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkBatch.GetLengths(BenchmarkLengths);
+
+        total += BenchmarkLengths[i & (BenchmarkNumInputs - 1)];
+    }
+
+    BenchmarkSink += total;
+}
+
+//
+// CTargetPath around a circle, and times spread over several laps of it
+//
+
+static void SetupTargetPath(int parameter)
+{
+    double      time[BenchmarkPathNumKeyframes];
+    CVector2    position[BenchmarkPathNumKeyframes];
+    int         i = 0;
+
+    for (i = 0; i < BenchmarkPathNumKeyframes; i++)
+    {
+        float fraction = (float)i / (BenchmarkPathNumKeyframes - 1);
+
+        time[i]     = fraction * BenchmarkPathSeconds;
+        position[i] = CVector2(2500.0f, 0.0f);
+
+        position[i].Rotate(fraction * 360.0f);
+    }
+
+    BenchmarkTargetPath.SetKeyframes(BenchmarkPathNumKeyframes, time, position);
+
+    for (i = 0; i < BenchmarkNumInputs; i++)
+    {
+        BenchmarkPathTimes[i] = (BenchmarkInput[i].m_Angle / 360.0f) * 4.0f * BenchmarkPathSeconds;
+    }
+}
+
+static void RunTargetPathGetPosition(int num_operations)
+{
+    float total = 0.0f;
+
+    for (int i = 0; i < num_operations; i++)
+    {
+        total += BenchmarkTargetPath.GetPosition(BenchmarkPathTimes[i & (BenchmarkNumInputs - 1)]).x;
+    }
+
+    BenchmarkSink += total;
+}
+
+static void RunTargetPathGetPositions(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkTargetPath.GetPositions(BenchmarkPathTimes, BenchmarkNumInputs, &BenchmarkBatch);
+    }
+
+    BenchmarkSink += BenchmarkBatch.GetX()[0];
+}
+
+//
+// CWorld with parameter pairs (or one, if it's 0), with the missiles under
+// adaptive control chasing automatic targets, set up from the initial
+// values in our config
+//
+
+static void SetupWorld(int parameter)
+{
+    if (!BenchmarkWorld)
+    {
+        BenchmarkWorld = new CWorld(false);
+    }
+
+    BenchmarkWorld->SetNumPairs(max(parameter, 1));
+
+    CBenchmarkSuite::SetupWorld(BenchmarkWorld, &BenchmarkConfig);
+}
+
+static void RunWorldSetNumPairs(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkWorld->SetNumPairs(BenchmarkWorldNumPairs);
+    }
+
+    BenchmarkSink += BenchmarkWorld->GetMissile()->GetPosition()->x;
+}
+
+//
+// Getting a world with one pair ready for a sweep evaluation, either by
+// building a new one or by checking one out of a pool
+//
+
+static void RunWorldConstruct(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        CWorld *world = new CWorld(false);
+
+        world->SetConfig(&BenchmarkConfig);
+        world->Restart(i);
+
+        BenchmarkSink += world->GetMissile()->GetPosition()->x;
+
+        delete world;
+    }
+}
+
+static void SetupWorldPool(int parameter)
+{
+    if (!BenchmarkWorldPool)
+    {
+        BenchmarkWorldPool = new CWorldPool;
+
+        BenchmarkWorldPool->Create(1);
+    }
+}
+
+static void RunWorldPoolCheckOut(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        CWorld *world = BenchmarkWorldPool->CheckOut(1, &BenchmarkConfig, i);
+
+        BenchmarkSink += world->GetMissile()->GetPosition()->x;
+
+        BenchmarkWorldPool->CheckIn(world);
+    }
+}
+
+static void RunWorldDoTimestep(int num_operations)
+{
+    for (int i = 0; i < num_operations; i++)
+    {
+        BenchmarkWorld->DoTimestep(BenchmarkTimestep);
+    }
+
+    BenchmarkSink += BenchmarkWorld->GetMissile()->GetPosition()->x;
+}
+
+//
+// All of our benchmarks
+//
+
+static const SBenchmarkDescription BenchmarkDescription[] =
+{
+    { "PidController.Record",                   SetupPidController,         RunPidRecord,                       0,                              1 },
+    { "PidController.GetOutput",                SetupPidController,         RunPidGetOutput,                    0,                              1 },
+    { "PidController.RecordAndGetOutput",       SetupPidController,         RunPidRecordAndGetOutput,           0,                              1 },
+    { "PidController.Derivative",               SetupPidController,         RunPidRecordAndGetDerivative,       eDERIVATIVE_DIFFERENCE,         1 },
+    { "PidController.Derivative.LowPass",       SetupPidController,         RunPidRecordAndGetDerivative,       eDERIVATIVE_LOW_PASS,           1 },
+    { "PidController.Derivative.LeastSquares",  SetupPidController,         RunPidRecordAndGetDerivative,       eDERIVATIVE_LEAST_SQUARES,      1 },
+    { "PidController.Derivative.SavitzkyGolay", SetupPidController,         RunPidRecordAndGetDerivative,       eDERIVATIVE_SAVITZKY_GOLAY,     1 },
+    { "PidController.Integral",                 SetupPidIntegral,           RunPidRecordAndClampOutput,         eINTEGRAL_WINDOW,               1 },
+    { "PidController.Integral.Exponential",     SetupPidIntegral,           RunPidRecordAndClampOutput,         eINTEGRAL_EXPONENTIAL,          1 },
+    { "PidController.Integral.Conditional",     SetupPidIntegral,           RunPidRecordAndClampOutput,         eINTEGRAL_CONDITIONAL,          1 },
+    { "PidController.Integral.BackCalculation", SetupPidIntegral,           RunPidRecordAndClampOutput,         eINTEGRAL_BACK_CALCULATION,     1 },
+
+    { "AdaptiveController.Update.MIT",          SetupAdaptiveController,    RunAdaptiveControllerUpdate,        eADAPT_MIT_RULE,                1 },
+    { "AdaptiveController.Update.SignSign",     SetupAdaptiveController,    RunAdaptiveControllerUpdate,        eADAPT_SIGN_SIGN_RULE,          1 },
+    { "AdaptiveController.Update.SignData",     SetupAdaptiveController,    RunAdaptiveControllerUpdate,        eADAPT_SIGN_DATA_RULE,          1 },
+    { "AdaptiveController.Update.SignError",    SetupAdaptiveController,    RunAdaptiveControllerUpdate,        eADAPT_SIGN_ERROR_RULE,         1 },
+    { "AdaptiveController.Update.NormalizedMIT",SetupAdaptiveController,    RunAdaptiveControllerUpdate,        eADAPT_NORMALIZED_MIT_RULE,     1 },
+    { "AdaptiveController.Update.RLS",          SetupAdaptiveController,    RunAdaptiveControllerUpdate,        eADAPT_RECURSIVE_LEAST_SQUARES_RULE, 1 },
+
+    { "RecursiveLeastSquares.Update",           SetupRecursiveLeastSquares, RunRecursiveLeastSquaresUpdate,     0,                              1 },
+
+    { "Graph.GetValue",                         SetupGraph,                 RunGraphGetValue,                   0,                              1 },
+    { "Missile.GetModelBehaviorValue",          SetupWorld,                 RunMissileGetModelBehaviorValue,    0,                              1 },
+
+    { "Vector2.Rotate",                         SetupVector,                RunVectorRotate,                    0,                              1 },
+    { "Vector2.Rotate.Fast",                    SetupVector,                RunVectorRotate,                    1,                              1 },
+    { "Vector2.Normalize",                      NULL,                       RunVectorNormalize,                 0,                              1 },
+    { "Vector2.GetAngle",                       SetupTrigonometry,          RunVectorGetAngle,                  0,                              1 },
+    { "Vector2.GetAngle.Fast",                  SetupTrigonometry,          RunVectorGetAngle,                  1,                              1 },
+    { "Vector2.GetAngles",                      SetupVectorBatch,           RunVectorGetAngles,                 0,                              BenchmarkNumInputs },
+    { "Vector2.GetAngles.Fast",                 SetupVectorBatch,           RunVectorGetAngles,                 1,                              BenchmarkNumInputs },
+    { "Vector2.RotateVectors",                  SetupVectorBatch,           RunVectorRotateVectors,             0,                              BenchmarkNumInputs },
+    { "Vector2.RotateVectors.Fast",             SetupVectorBatch,           RunVectorRotateVectors,             1,                              BenchmarkNumInputs },
+
+    { "Vector2Batch.Add",                       SetupBatch,                 RunBatchAdd,                        0,                              BenchmarkNumInputs },
+    { "Vector2Batch.Scale",                     SetupBatch,                 RunBatchScale,                      0,                              BenchmarkNumInputs },
+    { "Vector2Batch.Normalize",                 SetupBatch,                 RunBatchNormalize,                  0,                              BenchmarkNumInputs },
+    { "Vector2Batch.RotateBy",                  SetupBatch,                 RunBatchRotateBy,                   0,                              BenchmarkNumInputs },
+    { "Vector2Batch.GetLengths",                SetupBatch,                 RunBatchGetLengths,                 0,                              BenchmarkNumInputs },
+
+    { "TargetPath.GetPosition",                 SetupTargetPath,            RunTargetPathGetPosition,           0,                              1 },
+    { "TargetPath.GetPositions",                SetupTargetPath,            RunTargetPathGetPositions,          0,                              BenchmarkNumInputs },
+
+    { "World.DoTimestep",                       SetupWorld,                 RunWorldDoTimestep,                 0,                              1 },
+    { "World.SetNumPairs",                      SetupWorld,                 RunWorldSetNumPairs,                BenchmarkWorldNumPairs,         BenchmarkWorldNumPairs },
+    { "World.Construct",                        NULL,                       RunWorldConstruct,                  0,                              1 },
+    { "WorldPool.CheckOut",                     SetupWorldPool,             RunWorldPoolCheckOut,               0,                              1 },
+};
+
+const int NumBenchmarks = sizeof(BenchmarkDescription) / sizeof(BenchmarkDescription[0]);
+
+//
+// Comparison function for qsort(), to sort doubles into increasing order
+//
+
+static int CompareDoubles(const void *value_1, const void *value_2)
+{
+    double difference = *(const double *)value_1 - *(const double *)value_2;
+
+    return (difference < 0.0) ? -1 : ((difference > 0.0) ? 1 : 0);
+}
+
+//
+// Warm up, then time, one benchmark
+//
+
+void CBenchmarkSuite::RunBenchmark(const SBenchmarkDescription *benchmark, SBenchmarkResult *result)
+{
+    int         i                   = 0;
+    int         num_operations      = 1;
+    double      seconds             = 0.0;
+    double      nanoseconds_per_operation[BenchmarkNumRepetitions];
+    CStopwatch  stopwatch;
+
+    if (benchmark->m_Setup)
+    {
+        benchmark->m_Setup(benchmark->m_Parameter);
+    }
+
+    // Warm up, and find out how many operations we need for one run to
+    // take long enough to time accurately
+
+    for (;;)
+    {
+        stopwatch.Start();
+
+        benchmark->m_Run(num_operations);
+
+        seconds = stopwatch.GetElapsedSeconds();
+
+        if ((seconds >= BenchmarkMinRunSeconds) || (num_operations >= BenchmarkMaxNumOperations))
+        {
+            break;
+        }
+
+        // Jump most of the way there if we can tell how far off we are,
+        // otherwise just try twice as many
+
+        if (seconds > (BenchmarkMinRunSeconds / 100.0))
+        {
+            num_operations = (int)min((double)BenchmarkMaxNumOperations, num_operations * (BenchmarkMinRunSeconds * 1.2 / seconds));
+        }
+        else
+        {
+            num_operations = min(BenchmarkMaxNumOperations, num_operations * 2);
+        }
+    }
+
+    // Now time it for real
+
+    LONG num_allocations = CAllocationCounter::GetCount();
+
+    for (i = 0; i < BenchmarkNumRepetitions; i++)
+    {
+        stopwatch.Start();
+
+        benchmark->m_Run(num_operations);
+
+        nanoseconds_per_operation[i] = (stopwatch.GetElapsedSeconds() * 1.0e9) / (double)num_operations;
+    }
+
+    num_allocations = CAllocationCounter::GetCount() - num_allocations;
+
+    qsort(nanoseconds_per_operation, BenchmarkNumRepetitions, sizeof(double), CompareDoubles);
+
+    result->m_MinNanosecondsPerOperation    = nanoseconds_per_operation[0];
+    result->m_MedianNanosecondsPerOperation = nanoseconds_per_operation[BenchmarkNumRepetitions / 2];
+    result->m_MaxNanosecondsPerOperation    = nanoseconds_per_operation[BenchmarkNumRepetitions - 1];
+    result->m_NumOperations                 = num_operations;
+    result->m_AllocationsPerOperation       = num_allocations / ((double)num_operations * BenchmarkNumRepetitions);
+
+    if (result->m_MedianNanosecondsPerOperation > 0.0)
+    {
+        result->m_ItemsPerSecond            = (benchmark->m_ItemsPerOperation * 1.0e9) / result->m_MedianNanosecondsPerOperation;
+    }
+    else
+    {
+        result->m_ItemsPerSecond            = 0.0;
+    }
+}
+
+//
+// Run every benchmark whose name starts with name_prefix (or every
+// benchmark, if it's NULL), and write the results to results_filename.
+// Returns false if the results file couldn't be written.
+//
+
+bool CBenchmarkSuite::Run(const char *results_filename, const char *name_prefix)
+{
+    FILE *results_file = fopen(results_filename, "w");
+
+    if (!results_file)
+    {
+        TRACE("Unable to open benchmark results file %s\n", results_filename);
+
+        return false;
+    }
+
+    SetupInputs();
+
+    // Some benchmarks choose which trigonometry to use, so put it back to
+    // this build's choice after each one
+
+    bool fast_trigonometry = GetFastTrigonometry();
+
+    fprintf(results_file, "%-45s %12s %16s %12s %12s %12s %12s\n", "Benchmark", "ns/op", "items/s", "min ns/op", "max ns/op", "ops/run", "allocs/op");
+
+    for (int i = 0; i < NumBenchmarks; i++)
+    {
+        const SBenchmarkDescription *benchmark = &BenchmarkDescription[i];
+
+        if (name_prefix && (strncmp(benchmark->m_Name, name_prefix, strlen(name_prefix)) != 0))
+        {
+            continue;
+        }
+
+        SBenchmarkResult result;
+
+        RunBenchmark(benchmark, &result);
+
+        SetFastTrigonometry(fast_trigonometry);
+
+        fprintf(results_file, "%-45s %12.2f %16.0f %12.2f %12.2f %12d ", benchmark->m_Name,
+            result.m_MedianNanosecondsPerOperation, result.m_ItemsPerSecond,
+            result.m_MinNanosecondsPerOperation, result.m_MaxNanosecondsPerOperation, result.m_NumOperations);
+
+        // Allocations can only be counted in Debug builds
+
+        if (CAllocationCounter::IsAvailable())
+        {
+            fprintf(results_file, "%12.4f\n", result.m_AllocationsPerOperation);
+        }
+        else
+        {
+            fprintf(results_file, "%12s\n", "-");
+        }
+
+        fflush(results_file);
+
+        TRACE("%s: %.2f ns/op\n", benchmark->m_Name, result.m_MedianNanosecondsPerOperation);
+    }
+
+    fclose(results_file);
+
+    delete BenchmarkGraph;
+    delete BenchmarkWorld;
+    delete BenchmarkWorldPool;
+
+    BenchmarkGraph      = NULL;
+    BenchmarkWorld      = NULL;
+    BenchmarkWorldPool  = NULL;
+
+    return true;
+}
+
+//
+// Restart world from config, with every missile under adaptive control
+// chasing an automatic target, set up from the initial values in config.
+// Also used by our scaling benchmark, so that both time the same thing.
+//
+
+void CBenchmarkSuite::SetupWorld(CWorld *world, const CConfig *config)
+{
+    world->SetConfig(config);
+    world->Restart(BENCHMARK_WORLD_RANDOM_SEED);
+
+    world->SetSetting(eWORLD_SETTING_MISSILE_CONTROL_MODE,             (float)eMISSILE_CONTROL_ADAPTIVE_PID);
+    world->SetSetting(eWORLD_SETTING_TARGET_CONTROL_MODE,              (float)eTARGET_CONTROL_AUTOMATIC);
+    world->SetSetting(eWORLD_SETTING_MISSILE_STEERING_P_COEFFICIENT,   config->Get(eCONFIG_INITIAL_STEERING_P_COEFFICIENT));
+    world->SetSetting(eWORLD_SETTING_MISSILE_STEERING_I_COEFFICIENT,   config->Get(eCONFIG_INITIAL_STEERING_I_COEFFICIENT));
+    world->SetSetting(eWORLD_SETTING_MISSILE_STEERING_D_COEFFICIENT,   config->Get(eCONFIG_INITIAL_STEERING_D_COEFFICIENT));
+    world->SetSetting(eWORLD_SETTING_MISSILE_MAX_ACCELERATION,         config->Get(eCONFIG_INITIAL_MISSILE_MAX_ACCELERATION));
+    world->SetSetting(eWORLD_SETTING_MISSILE_MAX_ANGULAR_ACCELERATION, config->Get(eCONFIG_INITIAL_MISSILE_MAX_ANGULAR_ACCELERATION));
+    world->SetSetting(eWORLD_SETTING_MISSILE_ROTATIONAL_DRAG_FACTOR,   config->Get(eCONFIG_INITIAL_MISSILE_ROTATIONAL_DRAG_FACTOR));
+    world->SetSetting(eWORLD_SETTING_MISSILE_PID_OUTPUT_SCALE,         config->Get(eCONFIG_INITIAL_MISSILE_PID_OUTPUT_SCALE));
+    world->SetSetting(eWORLD_SETTING_TARGET_MAX_SPEED,                 config->Get(eCONFIG_INITIAL_TARGET_MAX_SPEED));
+}
+
+//
+// Check that the fast trigonometry in CVector2 is accurate enough: compare
+// each function against the C library over a sweep of inputs, then step
+// two worlds side by side, one with each, and see how far apart their
+// missiles get. Writes the results to results_filename. Returns false if
+// the trajectories didn't stay within TrigCheckTolerance, or the results
+// file couldn't be written.
+//
+
+bool CBenchmarkSuite::CheckFastTrigonometry(const char *results_filename)
+{
+    int     i                       = 0;
+    bool    fast_trigonometry       = GetFastTrigonometry();
+    double  max_atan2_error         = 0.0;
+    double  max_sine_error          = 0.0;
+    double  max_cosine_error        = 0.0;
+    float   max_deviation           = 0.0f;
+    float   first_out_of_tolerance  = -1.0f;
+
+    FILE *results_file = fopen(results_filename, "w");
+
+    if (!results_file)
+    {
+        TRACE("Unable to open trigonometry check results file %s\n", results_filename);
+
+        return false;
+    }
+
+    // The functions themselves, over a few turns in each direction, and
+    // at points on an ellipse so that every octant gets ratios of all sizes
+
+    for (i = 0; i < TrigCheckNumSamples; i++)
+    {
+        double  angle       = ((double)i / TrigCheckNumSamples) * (8.0 * 3.14159265358979) - (4.0 * 3.14159265358979);
+        float   x           = (float)cos(angle) * 3.0f;
+        float   y           = (float)sin(angle) * 2.0f;
+        double  atan2_error = fabs(FastAtan2(y, x) - atan2((double)y, (double)x));
+        float   sine;
+        float   cosine;
+
+        FastSinCos((float)angle, &sine, &cosine);
+
+        // atan2() can come out as -pi on one side and pi on the other
+
+        if (atan2_error > 3.14159265358979)
+        {
+            atan2_error = (2.0 * 3.14159265358979) - atan2_error;
+        }
+
+        max_atan2_error     = max(max_atan2_error, atan2_error);
+        max_sine_error      = max(max_sine_error,   fabs(sine   - sin((double)(float)angle)));
+        max_cosine_error    = max(max_cosine_error, fabs(cosine - cos((double)(float)angle)));
+    }
+
+    // And whole trajectories
+
+    CWorld *libm_world = new CWorld(false);
+    CWorld *fast_world = new CWorld(false);
+
+    libm_world->SetNumPairs(TrigCheckNumPairs);
+    fast_world->SetNumPairs(TrigCheckNumPairs);
+
+    SetupWorld(libm_world, &BenchmarkConfig);
+    SetupWorld(fast_world, &BenchmarkConfig);
+
+    int             num_steps = (int)(TrigCheckSeconds / BenchmarkTimestep);
+    CVector2Batch   libm_positions;
+    CVector2Batch   fast_positions;
+    float           deviation[TrigCheckNumPairs];
+
+    for (i = 0; i < num_steps; i++)
+    {
+        SetFastTrigonometry(false);
+        libm_world->DoTimestep(BenchmarkTimestep);
+
+        SetFastTrigonometry(true);
+        fast_world->DoTimestep(BenchmarkTimestep);
+
+        libm_world->GetMissilePositions(&libm_positions);
+        fast_world->GetMissilePositions(&fast_positions);
+
+        fast_positions.Subtract(libm_positions);
+        fast_positions.GetLengths(deviation);
+
+        for (int pair = 0; pair < TrigCheckNumPairs; pair++)
+        {
+            max_deviation = max(max_deviation, deviation[pair]);
+
+            if ((deviation[pair] > TrigCheckTolerance) && (first_out_of_tolerance < 0.0f))
+            {
+                first_out_of_tolerance = libm_world->GetTimeElapsed();
+            }
+        }
+    }
+
+    delete libm_world;
+    delete fast_world;
+
+    SetFastTrigonometry(fast_trigonometry);
+
+    fprintf(results_file, "FastAtan2 max error:     %g radians\n", max_atan2_error);
+    fprintf(results_file, "FastSinCos max error:    %g (sine), %g (cosine)\n", max_sine_error, max_cosine_error);
+    fprintf(results_file, "Max missile deviation:   %g world units over %g seconds of %d missiles\n", max_deviation, TrigCheckSeconds, TrigCheckNumPairs);
+
+    if (first_out_of_tolerance < 0.0f)
+    {
+        fprintf(results_file, "Trajectories stayed within %g world units\n", TrigCheckTolerance);
+    }
+    else
+    {
+        fprintf(results_file, "Trajectories first differed by more than %g world units after %g seconds\n", TrigCheckTolerance, first_out_of_tolerance);
+    }
+
+    fclose(results_file);
+
+    return (first_out_of_tolerance < 0.0f);
+}
@@ -0,0 +1,66 @@
+//
+// Micro-benchmarks for the hot paths of our controllers, math and world,
+// so that the effect of a performance change can be measured.
+//
+// Each benchmark repeats one operation, such as a PID controller Record(),
+// some number of times. Before timing it, we warm it up by running it with
+// more and more operations until one run takes at least
+// BenchmarkMinRunSeconds, which also tells us how many operations to use.
+// We then time BenchmarkNumRepetitions runs of that many operations, and
+// report the median time per operation, along with the fastest and slowest
+// runs so that noisy results stand out. In Debug builds, we also report
+// how many heap allocations each operation makes.
+//
+// Run the demo with /benchmark [<results file>] [<name>] to run every
+// benchmark whose name starts with <name>. Results go to Benchmark.txt if no
+// results file is given.
+//
+
+#ifndef CBENCHMARK_H
+#define CBENCHMARK_H
+
+class CWorld;
+class CConfig;
+
+// Random seed that CBenchmarkSuite::SetupWorld() restarts worlds from.
+// Generate a CTargetTrajectoryTable from it for targets that start where
+// the trajectories do.
+#define BENCHMARK_WORLD_RANDOM_SEED     12345
+
+typedef void (*BenchmarkSetupFunction)(int parameter);
+typedef void (*BenchmarkRunFunction)(int num_operations);
+
+// Describes one benchmark
+struct SBenchmarkDescription
+{
+    const char*             m_Name;
+    BenchmarkSetupFunction  m_Setup;                // Called once before the benchmark is warmed up. Can be NULL.
+    BenchmarkRunFunction    m_Run;                  // Performs num_operations operations
+    int                     m_Parameter;            // Passed to m_Setup, to share code between similar benchmarks
+    int                     m_ItemsPerOperation;    // Number of items processed by each operation
+};
+
+// Results of one benchmark
+struct SBenchmarkResult
+{
+    double                  m_MedianNanosecondsPerOperation;
+    double                  m_MinNanosecondsPerOperation;
+    double                  m_MaxNanosecondsPerOperation;
+    double                  m_ItemsPerSecond;   // Based on the median
+    int                     m_NumOperations;    // Number of operations in each repetition
+    double                  m_AllocationsPerOperation;  // Heap allocations, while timing. Always 0 unless CAllocationCounter::IsAvailable().
+};
+
+class CBenchmarkSuite
+{
+public:
+    static bool             Run(const char *results_filename, const char *name_prefix);
+
+    static void             RunBenchmark(const SBenchmarkDescription *benchmark, SBenchmarkResult *result);
+
+    static void             SetupWorld(CWorld *world, const CConfig *config);
+
+    static bool             CheckFastTrigonometry(const char *results_filename);
+};
+
+#endif
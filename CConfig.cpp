@@ -0,0 +1,260 @@
+//
+// Class to hold all of our tuning values.
+//
+// Every value has a compiled-in default, which can be overridden by an
+// INI-style file with the same sections and keys as listed below.
+// Call Load() once at startup with the name of the file, then pass the
+// CConfig into the world with CWorld::SetConfig(). Values that are missing
+// from the file keep their defaults.
+//
+// Call HasFileChanged() periodically to see if the file has been edited since
+// it was last loaded, and Reload() it if so.
+//
+
+#include "stdafx.h"
+#include "CConfig.h"
+
+//
+// Where each value lives in the file, and its default value. The order here
+// must match the order of eConfigValue.
+//
+
+struct SConfigValueDescription
+{
+    eConfigValue    m_Value;
+    const char*     m_Section;
+    const char*     m_Key;
+    float           m_DefaultValue;
+};
+
+static const SConfigValueDescription ConfigValueDescription[NUM_CONFIG_VALUES] =
+{
+    { eCONFIG_WORLD_SIZE,                               "World",                "WorldSize",                        7500.0f         },  // World units
+    { eCONFIG_WORLD_MAX_TIMESTEP,                       "World",                "MaxTimestep",                      0.25f           },  // Seconds
+    { eCONFIG_MISSILE_START_POSITION_FACTOR,            "World",                "MissileStartPositionFactor",       0.25f           },  // Fraction along our y axis
+    { eCONFIG_TARGET_START_POSITION_FACTOR,             "World",                "TargetStartPositionFactor",        -0.25f          },  // Fraction along our y axis
+
+    { eCONFIG_MISSILE_HEIGHT,                           "Missile",              "Height",                           400.0f          },  // World units
+    { eCONFIG_MISSILE_WIDTH,                            "Missile",              "Width",                            200.0f          },  // World units
+    { eCONFIG_MISSILE_DRAG_FACTOR,                      "Missile",              "DragFactor",                       0.001f          },
+    { eCONFIG_MISSILE_NUM_SECONDS_TO_EXPLODE,           "Missile",              "NumSecondsToExplode",              0.5f            },
+    { eCONFIG_MISSILE_EXPLOSION_SIZE_FACTOR,            "Missile",              "ExplosionSizeFactor",              1.5f            },
+
+    { eCONFIG_MISSILE_STEERING_MODEL_MIN_X_VALUE,       "MissileSteeringModel", "MinXValue",                        0.0f            },  // Degrees of process error
+    { eCONFIG_MISSILE_STEERING_MODEL_MAX_X_VALUE,       "MissileSteeringModel", "MaxXValue",                        90.0f           },  // Degrees of process error
+    { eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_0,   "MissileSteeringModel", "ControlPoint0",                    0.0f            },  // Desired derivative of process error
+    { eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_1,   "MissileSteeringModel", "ControlPoint1",                    -2.0f           },  // (degrees per second)
+    { eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_2,   "MissileSteeringModel", "ControlPoint2",                    -10.0f          },
+    { eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_3,   "MissileSteeringModel", "ControlPoint3",                    -20.0f          },
+    { eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_4,   "MissileSteeringModel", "ControlPoint4",                    -20.0f          },
+    { eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_5,   "MissileSteeringModel", "ControlPoint5",                    -20.0f          },
+    { eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_6,   "MissileSteeringModel", "ControlPoint6",                    -20.0f          },
+    { eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_7,   "MissileSteeringModel", "ControlPoint7",                    -20.0f          },
+    { eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_8,   "MissileSteeringModel", "ControlPoint8",                    -20.0f          },
+    { eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_9,   "MissileSteeringModel", "ControlPoint9",                    -20.0f          },
+
+    { eCONFIG_STEERING_ADAPTATION_RULE,                 "MissileSteering",      "AdaptationRule",                   0.0f            },  // See eAdaptationRule
+    { eCONFIG_STEERING_TIMESLICE,                       "MissileSteering",      "Timeslice",                        0.33f           },  // Seconds
+    { eCONFIG_STEERING_P_UPDATE_THRESHOLD,              "MissileSteering",      "PTermUpdateThreshold",             1.0f            },
+    { eCONFIG_STEERING_I_UPDATE_THRESHOLD,              "MissileSteering",      "ITermUpdateThreshold",             1.0f            },
+    { eCONFIG_STEERING_D_UPDATE_THRESHOLD,              "MissileSteering",      "DTermUpdateThreshold",             1.0f            },
+    { eCONFIG_STEERING_P_ADAPTATION_GAIN,               "MissileSteering",      "PTermAdaptationGain",              0.0005f         },
+    { eCONFIG_STEERING_I_ADAPTATION_GAIN,               "MissileSteering",      "ITermAdaptationGain",              0.0005f         },
+    { eCONFIG_STEERING_D_ADAPTATION_GAIN,               "MissileSteering",      "DTermAdaptationGain",              0.0001f         },
+    { eCONFIG_STEERING_P_ALPHA,                         "MissileSteering",      "PTermAlpha",                       0.0f            },
+    { eCONFIG_STEERING_I_ALPHA,                         "MissileSteering",      "ITermAlpha",                       0.0f            },
+    { eCONFIG_STEERING_D_ALPHA,                         "MissileSteering",      "DTermAlpha",                       0.0f            },
+    { eCONFIG_STEERING_MIN_P_COEFFICIENT,               "MissileSteering",      "MinPCoefficient",                  1.0f            },
+    { eCONFIG_STEERING_MAX_P_COEFFICIENT,               "MissileSteering",      "MaxPCoefficient",                  30.0f           },
+    { eCONFIG_STEERING_MIN_I_COEFFICIENT,               "MissileSteering",      "MinICoefficient",                  0.0f            },
+    { eCONFIG_STEERING_MAX_I_COEFFICIENT,               "MissileSteering",      "MaxICoefficient",                  7.0f            },
+    { eCONFIG_STEERING_MIN_D_COEFFICIENT,               "MissileSteering",      "MinDCoefficient",                  0.0f            },
+    { eCONFIG_STEERING_MAX_D_COEFFICIENT,               "MissileSteering",      "MaxDCoefficient",                  6.0f            },
+
+    { eCONFIG_TARGET_SIZE,                              "Target",               "Size",                             100.0f          },  // World units
+    { eCONFIG_TARGET_MAX_ANGULAR_VELOCITY,              "Target",               "MaxAngularVelocity",               90.0f           },  // Degrees / second
+    { eCONFIG_TARGET_STEER_TO_CENTER_OF_WORLD_FACTOR,   "Target",               "SteerToCenterOfWorldFactor",       0.00000008f     },
+    { eCONFIG_TARGET_NUM_SECONDS_TO_EXPLODE,            "Target",               "NumSecondsToExplode",              1.0f            },
+    { eCONFIG_TARGET_EXPLOSION_SIZE_FACTOR,             "Target",               "ExplosionSizeFactor",              15.0f           },
+
+    { eCONFIG_INITIAL_STEERING_P_COEFFICIENT,           "InitialValues",        "MissileSteeringPCoefficient",      2.0f            },
+    { eCONFIG_INITIAL_STEERING_I_COEFFICIENT,           "InitialValues",        "MissileSteeringICoefficient",      0.5f            },
+    { eCONFIG_INITIAL_STEERING_D_COEFFICIENT,           "InitialValues",        "MissileSteeringDCoefficient",      2.9f            },
+    { eCONFIG_INITIAL_MISSILE_MAX_ACCELERATION,         "InitialValues",        "MissileMaxAcceleration",           1000.0f         },  // World units / second^2
+    { eCONFIG_INITIAL_MISSILE_MAX_ANGULAR_ACCELERATION, "InitialValues",        "MissileMaxAngularAcceleration",    180.0f          },  // Degrees / second^2
+    { eCONFIG_INITIAL_MISSILE_PID_OUTPUT_SCALE,         "InitialValues",        "MissilePIDOutputScale",            1.0f            },
+    { eCONFIG_INITIAL_MISSILE_ROTATIONAL_DRAG_FACTOR,   "InitialValues",        "MissileRotationalDragFactor",      0.005f          },
+    { eCONFIG_INITIAL_TARGET_MAX_SPEED,                 "InitialValues",        "TargetMaxSpeed",                   1250.0f         },  // World units / second
+
+    { eCONFIG_TELEMETRY_ENABLED,                        "Telemetry",            "Enabled",                          0.0f            },
+    { eCONFIG_TELEMETRY_RING_BUFFER_SIZE,               "Telemetry",            "RingBufferSize",                   4096.0f         },  // Records
+    { eCONFIG_TELEMETRY_COMPRESS,                       "Telemetry",            "Compress",                         1.0f            },
+
+    { eCONFIG_JOURNAL_ENABLED,                          "Journal",              "Enabled",                          1.0f            },
+
+    { eCONFIG_METRICS_DUMP_INTERVAL,                    "Metrics",              "DumpInterval",                     5.0f            },  // Seconds. 0 to never write them out.
+
+    { eCONFIG_MISSILE_INTEGRATOR,                       "Missile",              "Integrator",                       0.0f            },  // eMissileIntegrator
+    { eCONFIG_MISSILE_MAX_SUBSTEPS,                     "Missile",              "MaxSubsteps",                      1.0f            },  // 1 to never split a timestep
+    { eCONFIG_MISSILE_GUIDANCE,                         "Missile",              "Guidance",                         0.0f            },  // eMissileGuidanceMode
+
+    { eCONFIG_STEERING_DERIVATIVE_ESTIMATOR,            "MissileSteering",      "DerivativeEstimator",              0.0f            },  // eDerivativeEstimator
+    { eCONFIG_STEERING_DERIVATIVE_TIME_CONSTANT,        "MissileSteering",      "DerivativeTimeConstant",           0.05f           },  // Seconds
+    { eCONFIG_STEERING_INTEGRAL_MODE,                   "MissileSteering",      "IntegralMode",                     0.0f            },  // eIntegralMode
+    { eCONFIG_STEERING_INTEGRAL_TIME_CONSTANT,          "MissileSteering",      "IntegralTimeConstant",             0.25f           },  // Seconds, for IntegralMode 1
+    { eCONFIG_STEERING_ADAPTATION_SCHEDULE,             "MissileSteering",      "AdaptationSchedule",               0.0f            },  // eAdaptationSchedule
+    { eCONFIG_STEERING_SENSITIVITY_TIME_CONSTANT,       "MissileSteering",      "SensitivityTimeConstant",          0.25f           },  // Seconds
+    { eCONFIG_STEERING_RLS_FORGETTING_FACTOR,           "MissileSteering",      "RlsForgettingFactor",              0.5f            },  // Weight left after a second
+    { eCONFIG_STEERING_RLS_INITIAL_COVARIANCE,          "MissileSteering",      "RlsInitialCovariance",             0.001f          },
+    { eCONFIG_STEERING_RLS_COVARIANCE_RESET_FRACTION,   "MissileSteering",      "RlsCovarianceResetFraction",       0.1f            },  // 0 to never reset it
+    { eCONFIG_STEERING_TRACKING_TIME_CONSTANT,          "MissileSteering",      "TrackingTimeConstant",             16.0f           },  // Seconds, for IntegralMode 3
+};
+
+//
+// Set every value back to its compiled-in default
+//
+
+void CConfig::SetDefaults()
+{
+    for (int i = 0; i < NUM_CONFIG_VALUES; i++)
+    {
+        ASSERT(ConfigValueDescription[i].m_Value == i);
+
+        m_Value[i] = ConfigValueDescription[i].m_DefaultValue;
+    }
+
+    m_FileName      = "";
+    m_FileExisted   = false;
+
+    m_LastWriteTime.dwLowDateTime   = 0;
+    m_LastWriteTime.dwHighDateTime  = 0;
+}
+
+//
+// Read all of our values from the specified file. Returns false if the
+// file doesn't exist, in which case every value is left at its default.
+//
+
+bool CConfig::Load(const char *filename)
+{
+    // GetPrivateProfileString() looks in the Windows directory unless
+    // it's given a full path, so make sure that we have one
+
+    char    full_path[MAX_PATH];
+    CString requested_filename = filename;
+
+    if (GetFullPathName(requested_filename, MAX_PATH, full_path, NULL) == 0)
+    {
+        TRACE("Unable to get the full path of config file %s\n", (const char *)requested_filename);
+
+        return false;
+    }
+
+    SetDefaults();
+
+    m_FileName      = full_path;
+    m_FileExisted   = GetLastWriteTime(&m_LastWriteTime);
+
+    if (!m_FileExisted)
+    {
+        TRACE("Config file %s not found: using default values\n", (const char *)m_FileName);
+
+        return false;
+    }
+
+    for (int i = 0; i < NUM_CONFIG_VALUES; i++)
+    {
+        char value_text[64];
+
+        GetPrivateProfileString(ConfigValueDescription[i].m_Section, ConfigValueDescription[i].m_Key, "", value_text, sizeof(value_text), m_FileName);
+
+        if (value_text[0] != '\0')
+        {
+            m_Value[i] = (float)atof(value_text);
+        }
+    }
+
+    TRACE("Loaded config file %s\n", (const char *)m_FileName);
+
+    return true;
+}
+
+//
+// Returns true if our file has been created, deleted or written to
+// since we last loaded it
+//
+
+bool CConfig::HasFileChanged()
+{
+    if (m_FileName.IsEmpty())
+    {
+        return false;
+    }
+
+    FILETIME    last_write_time;
+    bool        file_exists     = GetLastWriteTime(&last_write_time);
+
+    if (file_exists != m_FileExisted)
+    {
+        return true;
+    }
+
+    return (file_exists && (CompareFileTime(&last_write_time, &m_LastWriteTime) != 0));
+}
+
+//
+// Gets the time our file was last written to. Returns false if it doesn't exist.
+//
+
+bool CConfig::GetLastWriteTime(FILETIME *last_write_time)
+{
+    WIN32_FILE_ATTRIBUTE_DATA file_attributes;
+
+    if (!GetFileAttributesEx(m_FileName, GetFileExInfoStandard, &file_attributes))
+    {
+        return false;
+    }
+
+    *last_write_time = file_attributes.ftLastWriteTime;
+
+    return true;
+}
+
+//
+// Save or load our values, but not where they came from. Values that are
+// missing when loading, because they were added after the archive was
+// saved, keep their current values.
+//
+
+void CConfig::Serialize(CArchive &archive)
+{
+    int i = 0;
+
+    if (archive.IsStoring())
+    {
+        archive << (int)NUM_CONFIG_VALUES;
+
+        for (i = 0; i < NUM_CONFIG_VALUES; i++)
+        {
+            archive << m_Value[i];
+        }
+    }
+    else
+    {
+        int num_values;
+
+        archive >> num_values;
+
+        for (i = 0; i < num_values; i++)
+        {
+            float value;
+
+            archive >> value;
+
+            if (i < NUM_CONFIG_VALUES)
+            {
+                m_Value[i] = value;
+            }
+        }
+    }
+}
@@ -0,0 +1,147 @@
+//
+// Class to hold all of our tuning values.
+//
+// Every value has a compiled-in default, which can be overridden by an
+// INI-style file with the same sections and keys as listed in CConfig.cpp.
+// Call Load() once at startup with the name of the file, then pass the
+// CConfig into the world with CWorld::SetConfig(). Values that are missing
+// from the file keep their defaults.
+//
+// Call HasFileChanged() periodically to see if the file has been edited since
+// it was last loaded, and Reload() it if so.
+//
+
+#ifndef CCONFIG_H
+#define CCONFIG_H
+
+// All of the tuning values that can be read from our config file
+enum eConfigValue
+{
+    // World
+    eCONFIG_WORLD_SIZE = 0,
+    eCONFIG_WORLD_MAX_TIMESTEP,
+    eCONFIG_MISSILE_START_POSITION_FACTOR,
+    eCONFIG_TARGET_START_POSITION_FACTOR,
+
+    // Missile
+    eCONFIG_MISSILE_HEIGHT,
+    eCONFIG_MISSILE_WIDTH,
+    eCONFIG_MISSILE_DRAG_FACTOR,
+    eCONFIG_MISSILE_NUM_SECONDS_TO_EXPLODE,
+    eCONFIG_MISSILE_EXPLOSION_SIZE_FACTOR,
+
+    // Missile steering model
+    eCONFIG_MISSILE_STEERING_MODEL_MIN_X_VALUE,
+    eCONFIG_MISSILE_STEERING_MODEL_MAX_X_VALUE,
+    eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_0,
+    eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_1,
+    eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_2,
+    eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_3,
+    eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_4,
+    eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_5,
+    eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_6,
+    eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_7,
+    eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_8,
+    eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_9,
+
+    // Missile steering adaptive controller
+    eCONFIG_STEERING_ADAPTATION_RULE,
+    eCONFIG_STEERING_TIMESLICE,
+    eCONFIG_STEERING_P_UPDATE_THRESHOLD,
+    eCONFIG_STEERING_I_UPDATE_THRESHOLD,
+    eCONFIG_STEERING_D_UPDATE_THRESHOLD,
+    eCONFIG_STEERING_P_ADAPTATION_GAIN,
+    eCONFIG_STEERING_I_ADAPTATION_GAIN,
+    eCONFIG_STEERING_D_ADAPTATION_GAIN,
+    eCONFIG_STEERING_P_ALPHA,
+    eCONFIG_STEERING_I_ALPHA,
+    eCONFIG_STEERING_D_ALPHA,
+    eCONFIG_STEERING_MIN_P_COEFFICIENT,
+    eCONFIG_STEERING_MAX_P_COEFFICIENT,
+    eCONFIG_STEERING_MIN_I_COEFFICIENT,
+    eCONFIG_STEERING_MAX_I_COEFFICIENT,
+    eCONFIG_STEERING_MIN_D_COEFFICIENT,
+    eCONFIG_STEERING_MAX_D_COEFFICIENT,
+
+    // Target
+    eCONFIG_TARGET_SIZE,
+    eCONFIG_TARGET_MAX_ANGULAR_VELOCITY,
+    eCONFIG_TARGET_STEER_TO_CENTER_OF_WORLD_FACTOR,
+    eCONFIG_TARGET_NUM_SECONDS_TO_EXPLODE,
+    eCONFIG_TARGET_EXPLOSION_SIZE_FACTOR,
+
+    // Initial values for the sliders
+    eCONFIG_INITIAL_STEERING_P_COEFFICIENT,
+    eCONFIG_INITIAL_STEERING_I_COEFFICIENT,
+    eCONFIG_INITIAL_STEERING_D_COEFFICIENT,
+    eCONFIG_INITIAL_MISSILE_MAX_ACCELERATION,
+    eCONFIG_INITIAL_MISSILE_MAX_ANGULAR_ACCELERATION,
+    eCONFIG_INITIAL_MISSILE_PID_OUTPUT_SCALE,
+    eCONFIG_INITIAL_MISSILE_ROTATIONAL_DRAG_FACTOR,
+    eCONFIG_INITIAL_TARGET_MAX_SPEED,
+
+    // Telemetry
+    eCONFIG_TELEMETRY_ENABLED,
+    eCONFIG_TELEMETRY_RING_BUFFER_SIZE,
+    eCONFIG_TELEMETRY_COMPRESS,
+
+    // Journal
+    eCONFIG_JOURNAL_ENABLED,
+
+    // Metrics
+    eCONFIG_METRICS_DUMP_INTERVAL,
+
+    // Missile, added after the rest so that older snapshots and journals
+    // still load
+    eCONFIG_MISSILE_INTEGRATOR,
+    eCONFIG_MISSILE_MAX_SUBSTEPS,
+    eCONFIG_MISSILE_GUIDANCE,
+
+    // Missile steering adaptive controller, added after the rest for the
+    // same reason
+    eCONFIG_STEERING_DERIVATIVE_ESTIMATOR,
+    eCONFIG_STEERING_DERIVATIVE_TIME_CONSTANT,
+    eCONFIG_STEERING_INTEGRAL_MODE,
+    eCONFIG_STEERING_INTEGRAL_TIME_CONSTANT,
+    eCONFIG_STEERING_ADAPTATION_SCHEDULE,
+    eCONFIG_STEERING_SENSITIVITY_TIME_CONSTANT,
+    eCONFIG_STEERING_RLS_FORGETTING_FACTOR,
+    eCONFIG_STEERING_RLS_INITIAL_COVARIANCE,
+    eCONFIG_STEERING_RLS_COVARIANCE_RESET_FRACTION,
+    eCONFIG_STEERING_TRACKING_TIME_CONSTANT,
+
+    NUM_CONFIG_VALUES,
+};
+
+#define MISSILE_STEERING_MODEL_NUM_CONTROL_POINTS 10
+
+class CConfig
+{
+public:
+    CConfig()                                           { SetDefaults(); }
+    ~CConfig()                                          { }
+
+    void            SetDefaults();
+
+    bool            Load(const char *filename);
+    bool            Reload()                            { return Load(m_FileName); }
+    bool            HasFileChanged();
+
+    float           Get(eConfigValue value) const       { ASSERT((value >= 0) && (value < NUM_CONFIG_VALUES)); return m_Value[value]; }
+    int             GetInt(eConfigValue value) const    { return (int)(Get(value) + ((Get(value) < 0.0f) ? -0.5f : 0.5f)); }
+    bool            GetBool(eConfigValue value) const   { return (GetInt(value) != 0); }
+    void            Set(eConfigValue value, float new_value)    { ASSERT((value >= 0) && (value < NUM_CONFIG_VALUES)); m_Value[value] = new_value; }
+
+    void            Serialize(CArchive &archive);
+
+private:
+    bool            GetLastWriteTime(FILETIME *last_write_time);
+
+    float           m_Value[NUM_CONFIG_VALUES];     // Current value of each tuning value
+
+    CString         m_FileName;                     // Full path of the file we were loaded from
+    FILETIME        m_LastWriteTime;                // Time the file was last written when we loaded it
+    bool            m_FileExisted;                  // Did the file exist when we loaded it?
+};
+
+#endif
@@ -0,0 +1,145 @@
+//
+// Benchmark of how quickly each of the missile's guidance modes gets it
+// to its target.
+//
+// The missiles fly under adaptive PID control, set up just as the other
+// benchmarks set them up, so the guidance mode and target speed are the
+// only things that change between runs. The targets' paths at each speed
+// are generated once and played back for every guidance mode.
+//
+
+#include "stdafx.h"
+#include "CGuidanceBenchmark.h"
+#include "CBenchmark.h"
+#include "CTargetTrajectoryTable.h"
+#include "CWorld.h"
+
+//
+// Tuning constants
+//
+
+const int       GuidanceBenchmarkNumPairs           = 256;
+const float     GuidanceBenchmarkMaxSeconds         = 60.0f;            // Longest we'll wait for every missile to hit, in simulated seconds
+const float     GuidanceBenchmarkTimestep           = 1.0f / 60.0f;
+
+// Target speeds to try, as multiples of the initial speed in our config
+static const float GuidanceBenchmarkTargetSpeedFactor[] = { 1.0f, 1.5f, 2.0f };
+
+const int NumGuidanceBenchmarkTargetSpeeds = sizeof(GuidanceBenchmarkTargetSpeedFactor) / sizeof(GuidanceBenchmarkTargetSpeedFactor[0]);
+
+// Names to report each guidance mode by
+static const char *GuidanceModeName[NUM_MISSILE_GUIDANCE_MODES] =
+{
+    "PurePursuit",
+    "ProportionalNavigation",
+    "PredictedIntercept",
+};
+
+//
+// Launch every missile in world with guidance_mode, at targets following
+// trajectories, which were generated at target_speed, and time how long
+// each takes to first hit its target
+//
+
+void CGuidanceBenchmark::Fly(CWorld *world, const CConfig *config, eMissileGuidanceMode guidance_mode, const CTargetTrajectoryTable *trajectories, float target_speed, SGuidanceBenchmarkResult *result)
+{
+    int         pair                = 0;
+    int         num_steps           = (int)((GuidanceBenchmarkMaxSeconds / GuidanceBenchmarkTimestep) + 0.5f);
+    float       time_to_intercept[GuidanceBenchmarkNumPairs];
+    CConfig     guidance_config     = *config;
+
+    guidance_config.Set(eCONFIG_MISSILE_GUIDANCE, (float)guidance_mode);
+
+    CBenchmarkSuite::SetupWorld(world, &guidance_config);
+
+    world->SetSetting(eWORLD_SETTING_TARGET_MAX_SPEED, target_speed);
+    world->SetTargetTrajectories(trajectories);
+
+    for (pair = 0; pair < GuidanceBenchmarkNumPairs; pair++)
+    {
+        time_to_intercept[pair] = -1.0f;
+    }
+
+    result->m_GuidanceMode          = guidance_mode;
+    result->m_TargetSpeed           = target_speed;
+    result->m_NumIntercepts         = 0;
+    result->m_MeanTimeToIntercept   = 0.0f;
+    result->m_MaxTimeToIntercept    = 0.0f;
+
+    for (int step = 0; (step < num_steps) && (result->m_NumIntercepts < GuidanceBenchmarkNumPairs); step++)
+    {
+        world->DoTimestep(GuidanceBenchmarkTimestep);
+
+        // Missiles only stop flying when they hit
+
+        for (pair = 0; pair < GuidanceBenchmarkNumPairs; pair++)
+        {
+            if ((time_to_intercept[pair] < 0.0f) && (world->GetMissile(pair)->GetCurrentState() != eMISSILE_STATE_FLYING))
+            {
+                time_to_intercept[pair] = world->GetTimeElapsed();
+
+                result->m_NumIntercepts++;
+                result->m_MeanTimeToIntercept   += time_to_intercept[pair];
+                result->m_MaxTimeToIntercept    = max(result->m_MaxTimeToIntercept, time_to_intercept[pair]);
+            }
+        }
+    }
+
+    result->m_InterceptFraction = (float)result->m_NumIntercepts / GuidanceBenchmarkNumPairs;
+
+    if (result->m_NumIntercepts > 0)
+    {
+        result->m_MeanTimeToIntercept /= result->m_NumIntercepts;
+    }
+}
+
+//
+// Fly every guidance mode at every target speed, and write the results to
+// results_filename. Returns false if the results file couldn't be written.
+//
+
+bool CGuidanceBenchmark::Run(const char *results_filename)
+{
+    CConfig                     config;
+    CWorld                      world(false);
+    CTargetTrajectoryTable      trajectories;
+    SGuidanceBenchmarkResult    result;
+    int                         num_steps = (int)((GuidanceBenchmarkMaxSeconds / GuidanceBenchmarkTimestep) + 0.5f);
+
+    FILE *results_file = fopen(results_filename, "w");
+
+    if (!results_file)
+    {
+        TRACE("Unable to open guidance benchmark results file %s\n", results_filename);
+
+        return false;
+    }
+
+    world.SetNumPairs(GuidanceBenchmarkNumPairs);
+
+    fprintf(results_file, "%d missiles, each given up to %g seconds to hit its target.\n\n", GuidanceBenchmarkNumPairs, GuidanceBenchmarkMaxSeconds);
+    fprintf(results_file, "%-24s %12s %12s %16s %16s\n", "Guidance", "Target speed", "Hit", "Mean time (s)", "Max time (s)");
+
+    for (int i = 0; i < NumGuidanceBenchmarkTargetSpeeds; i++)
+    {
+        float target_speed = config.Get(eCONFIG_INITIAL_TARGET_MAX_SPEED) * GuidanceBenchmarkTargetSpeedFactor[i];
+
+        trajectories.Generate(&config, target_speed, BENCHMARK_WORLD_RANDOM_SEED, GuidanceBenchmarkNumPairs, GuidanceBenchmarkTimestep, num_steps);
+
+        for (int guidance_mode = 0; guidance_mode < NUM_MISSILE_GUIDANCE_MODES; guidance_mode++)
+        {
+            Fly(&world, &config, (eMissileGuidanceMode)guidance_mode, &trajectories, target_speed, &result);
+
+            fprintf(results_file, "%-24s %12.1f %11.1f%% %16.3f %16.3f\n",
+                GuidanceModeName[guidance_mode], result.m_TargetSpeed, result.m_InterceptFraction * 100.0f, result.m_MeanTimeToIntercept, result.m_MaxTimeToIntercept);
+            fflush(results_file);
+
+            TRACE("%s at target speed %g: %.1f%% hit, mean time to intercept %.3f s\n",
+                GuidanceModeName[guidance_mode], result.m_TargetSpeed, result.m_InterceptFraction * 100.0f, result.m_MeanTimeToIntercept);
+        }
+    }
+
+    fclose(results_file);
+
+    return true;
+}
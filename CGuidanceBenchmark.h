@@ -0,0 +1,48 @@
+//
+// Benchmark of how quickly each of the missile's guidance modes gets it
+// to its target.
+//
+// We launch a squadron of missiles at automatically moving targets with
+// each guidance mode, at the target's usual speed and at faster ones, and
+// time how long each missile takes to make its first hit. The target paths
+// at each speed are precomputed into a CTargetTrajectoryTable, so every
+// guidance mode sees exactly the same launches and target paths, and any
+// difference in time to intercept is down to the guidance alone.
+//
+// We report the fraction of missiles that hit within
+// GuidanceBenchmarkMaxSeconds, and the mean and longest time to intercept
+// of those that did.
+//
+// Run the demo with /guidancebenchmark [<results file>]. Results go to
+// Guidance.txt if no file is given.
+//
+
+#ifndef CGUIDANCEBENCHMARK_H
+#define CGUIDANCEBENCHMARK_H
+
+#include "CMissile.h"
+
+class CWorld;
+class CTargetTrajectoryTable;
+
+// Results of flying every missile with one guidance mode and target speed
+struct SGuidanceBenchmarkResult
+{
+    eMissileGuidanceMode    m_GuidanceMode;
+    float                   m_TargetSpeed;                  // In world units/s
+    int                     m_NumIntercepts;
+    float                   m_InterceptFraction;            // Of all of our missiles
+    float                   m_MeanTimeToIntercept;          // In simulated seconds, of those that hit
+    float                   m_MaxTimeToIntercept;
+};
+
+class CGuidanceBenchmark
+{
+public:
+    static bool             Run(const char *results_filename);
+
+private:
+    static void             Fly(CWorld *world, const CConfig *config, eMissileGuidanceMode guidance_mode, const CTargetTrajectoryTable *trajectories, float target_speed, SGuidanceBenchmarkResult *result);
+};
+
+#endif
@@ -0,0 +1,187 @@
+//
+// Benchmark of how accurate and how fast each of the missile's
+// integrators is, at a range of timesteps.
+//
+// The missiles are flown under keyboard control with no target, so that
+// steering costs nothing and doesn't feed their position back into their
+// accelerations, and in a world big enough that they never reach its edge.
+//
+
+#include "stdafx.h"
+#include "math.h"
+#include "CIntegratorBenchmark.h"
+#include "CBenchmark.h"
+#include "CStopwatch.h"
+#include "CVector2Batch.h"
+#include "CWorld.h"
+
+//
+// Tuning constants
+//
+
+const int       IntegratorBenchmarkNumMissiles          = 64;
+const float     IntegratorBenchmarkSeconds              = 10.0f;            // Length of each flight, in simulated seconds
+const float     IntegratorBenchmarkControlPeriod        = 1.0f / 15.0f;     // How often the accelerations change. Every timestep we try divides it.
+const float     IntegratorBenchmarkWorldSize            = 1000000.0f;       // Big enough that nobody reaches the edge, small enough to keep float positions precise
+const int       IntegratorBenchmarkReferenceSteps       = 256;              // RK4 steps per control period for the reference flight
+
+// Timesteps to try, as the number of steps per control period
+static const int IntegratorBenchmarkStepsPerControlPeriod[] = { 1, 2, 4, 8, 16 };
+
+const int NumIntegratorBenchmarkTimesteps = sizeof(IntegratorBenchmarkStepsPerControlPeriod) / sizeof(IntegratorBenchmarkStepsPerControlPeriod[0]);
+
+// Names to report each integrator by
+static const char *IntegratorName[NUM_MISSILE_INTEGRATORS] =
+{
+    "ExplicitEuler",
+    "SemiImplicitEuler",
+    "RK4",
+    "AnalyticDrag",
+};
+
+//
+// Start every missile in world from the origin, then fly them all for
+// IntegratorBenchmarkSeconds with integrator, taking
+// steps_per_control_period steps per control period, and time it. Each
+// missile gets its own smooth pattern of accelerations, which is the same
+// every time for the same missile.
+//
+
+void CIntegratorBenchmark::Fly(CWorld *world, eMissileIntegrator integrator, int steps_per_control_period, SIntegratorBenchmarkResult *result)
+{
+    int         pair                = 0;
+    int         num_control_periods = (int)((IntegratorBenchmarkSeconds / IntegratorBenchmarkControlPeriod) + 0.5f);
+    float       timestep            = IntegratorBenchmarkControlPeriod / steps_per_control_period;
+    CConfig     config              = *world->GetConfig();
+    CStopwatch  stopwatch;
+
+    config.Set(eCONFIG_MISSILE_INTEGRATOR, (float)integrator);
+
+    CBenchmarkSuite::SetupWorld(world, &config);
+
+    world->SetSetting(eWORLD_SETTING_MISSILE_CONTROL_MODE, (float)eMISSILE_CONTROL_KEYBOARD);
+
+    for (pair = 0; pair < world->GetNumPairs(); pair++)
+    {
+        CMissile *missile = world->GetMissile(pair);
+
+        missile->SetTarget(NULL);
+        missile->SetPosition(0.0f, 0.0f);
+    }
+
+    float max_acceleration          = world->GetSetting(eWORLD_SETTING_MISSILE_MAX_ACCELERATION);
+    float max_angular_acceleration  = world->GetSetting(eWORLD_SETTING_MISSILE_MAX_ANGULAR_ACCELERATION);
+
+    stopwatch.Start();
+
+    for (int control_period = 0; control_period < num_control_periods; control_period++)
+    {
+        for (pair = 0; pair < world->GetNumPairs(); pair++)
+        {
+            CMissile *missile = world->GetMissile(pair);
+
+            missile->SetUserDesiredAcceleration(max_acceleration * (0.5f + (0.5f * (float)sin((0.37f * control_period) + pair))));
+            missile->SetUserDesiredAngularAcceleration(max_angular_acceleration * (float)sin((0.23f * control_period) + (1.7f * pair)));
+
+            for (int step = 0; step < steps_per_control_period; step++)
+            {
+                missile->Steer(timestep);
+                missile->Move(timestep);
+            }
+        }
+    }
+
+    result->m_Seconds                   = stopwatch.GetElapsedSeconds();
+    result->m_Integrator                = integrator;
+    result->m_Timestep                  = timestep;
+    result->m_NumSteps                  = num_control_periods * steps_per_control_period;
+    result->m_NanosecondsPerMissileStep = (result->m_Seconds * 1.0e9) / ((double)result->m_NumSteps * world->GetNumPairs());
+    result->m_MaxError                  = 0.0f;
+    result->m_MeanError                 = 0.0f;
+}
+
+//
+// Fill in the errors in result, from how far each missile in world is
+// from the same missile in reference_positions
+//
+
+void CIntegratorBenchmark::MeasureErrors(CWorld *world, const CVector2Batch *reference_positions, SIntegratorBenchmarkResult *result)
+{
+    CVector2Batch   positions;
+    float           error[IntegratorBenchmarkNumMissiles];
+    float           total_error = 0.0f;
+
+    world->GetMissilePositions(&positions);
+
+    positions.Subtract(*reference_positions);
+    positions.GetLengths(error);
+
+    result->m_MaxError = 0.0f;
+
+    for (int pair = 0; pair < IntegratorBenchmarkNumMissiles; pair++)
+    {
+        result->m_MaxError  = max(result->m_MaxError, error[pair]);
+        total_error         += error[pair];
+    }
+
+    result->m_MeanError = total_error / IntegratorBenchmarkNumMissiles;
+}
+
+//
+// Fly the reference, then every integrator at every timestep, and write
+// the results to results_filename. Returns false if the results file
+// couldn't be written.
+//
+
+bool CIntegratorBenchmark::Run(const char *results_filename)
+{
+    CConfig                     config;
+    CWorld                      world(false);
+    CVector2Batch               reference_positions;
+    SIntegratorBenchmarkResult  result;
+
+    FILE *results_file = fopen(results_filename, "w");
+
+    if (!results_file)
+    {
+        TRACE("Unable to open integrator benchmark results file %s\n", results_filename);
+
+        return false;
+    }
+
+    // Compare the integrators on their own, without any sub-stepping
+
+    config.Set(eCONFIG_WORLD_SIZE, IntegratorBenchmarkWorldSize);
+    config.Set(eCONFIG_MISSILE_MAX_SUBSTEPS, 1.0f);
+
+    world.SetNumPairs(IntegratorBenchmarkNumMissiles);
+    world.SetConfig(&config);
+
+    Fly(&world, eMISSILE_INTEGRATOR_RK4, IntegratorBenchmarkReferenceSteps, &result);
+
+    world.GetMissilePositions(&reference_positions);
+
+    fprintf(results_file, "%d missiles flown for %g seconds. Errors are from RK4 with a timestep of %g seconds.\n\n",
+        IntegratorBenchmarkNumMissiles, IntegratorBenchmarkSeconds, result.m_Timestep);
+    fprintf(results_file, "%-20s %12s %14s %16s %16s\n", "Integrator", "Timestep", "ns/step", "Max error", "Mean error");
+
+    for (int integrator = 0; integrator < NUM_MISSILE_INTEGRATORS; integrator++)
+    {
+        for (int i = 0; i < NumIntegratorBenchmarkTimesteps; i++)
+        {
+            Fly(&world, (eMissileIntegrator)integrator, IntegratorBenchmarkStepsPerControlPeriod[i], &result);
+
+            MeasureErrors(&world, &reference_positions, &result);
+
+            fprintf(results_file, "%-20s %12.6f %14.2f %16.6f %16.6f\n",
+                IntegratorName[integrator], result.m_Timestep, result.m_NanosecondsPerMissileStep, result.m_MaxError, result.m_MeanError);
+            fflush(results_file);
+
+            TRACE("%s at %g: %.2f ns/step, max error %g\n", IntegratorName[integrator], result.m_Timestep, result.m_NanosecondsPerMissileStep, result.m_MaxError);
+        }
+    }
+
+    fclose(results_file);
+
+    return true;
+}
@@ -0,0 +1,50 @@
+//
+// Benchmark of how accurate and how fast each of the missile's
+// integrators is, at a range of timesteps.
+//
+// We fly a squadron of missiles through the same pattern of forward and
+// angular accelerations with every integrator and timestep, then measure
+// how far each one ends up from where RK4 puts it with a tiny timestep.
+// The accelerations only change on the boundaries of a control period
+// that every timestep divides evenly, so every run sees exactly the same
+// inputs, and any difference is down to the integrator alone.
+//
+// We report the largest and mean position error, and the nanoseconds per
+// missile per step, so that a larger timestep with a better integrator
+// can be weighed against a smaller one with a cheaper integrator.
+//
+// Run the demo with /integratorbenchmark [<results file>]. Results go to
+// Integrators.txt if no file is given.
+//
+
+#ifndef CINTEGRATORBENCHMARK_H
+#define CINTEGRATORBENCHMARK_H
+
+#include "CMissile.h"
+
+class CWorld;
+class CVector2Batch;
+
+// Results of flying every missile with one integrator and timestep
+struct SIntegratorBenchmarkResult
+{
+    eMissileIntegrator      m_Integrator;
+    float                   m_Timestep;
+    int                     m_NumSteps;                     // Per missile
+    double                  m_Seconds;                      // Wall time
+    double                  m_NanosecondsPerMissileStep;
+    float                   m_MaxError;                     // In world units, at the end of the flight
+    float                   m_MeanError;
+};
+
+class CIntegratorBenchmark
+{
+public:
+    static bool             Run(const char *results_filename);
+
+private:
+    static void             Fly(CWorld *world, eMissileIntegrator integrator, int steps_per_control_period, SIntegratorBenchmarkResult *result);
+    static void             MeasureErrors(CWorld *world, const CVector2Batch *reference_positions, SIntegratorBenchmarkResult *result);
+};
+
+#endif
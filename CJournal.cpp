@@ -0,0 +1,294 @@
+//
+// Classes to record everything that happens to a world from the outside,
+// and to play it back again later.
+//
+// The only things that change what a world does are its config, the seed
+// it was restarted from, the state of the keyboard, the settings changed
+// from the dialog box, the steering reset button, and the length of each
+// timestep. CJournalRecorder writes each of these to a journal file as it
+// happens, in the order it happens in. CJournalPlayer reads them back and
+// makes the same calls on another world, which then follows exactly the
+// same trajectory, as fast as it can be simulated.
+//
+
+#include "stdafx.h"
+#include "CJournal.h"
+
+//
+// Tuning constants
+//
+
+const DWORD JournalFileVersion = 1;
+
+CJournalRecorder::CJournalRecorder()
+{
+    m_File = NULL;
+}
+
+//
+// Open filename and write our header to it
+//
+
+bool CJournalRecorder::Start(const char *filename)
+{
+    Stop();
+
+    m_File = fopen(filename, "wb");
+
+    if (!m_File)
+    {
+        TRACE("Unable to open journal file %s\n", filename);
+
+        return false;
+    }
+
+    SJournalFileHeader header;
+
+    memcpy(header.m_Magic, "JRNL", sizeof(header.m_Magic));
+    header.m_Version = JournalFileVersion;
+
+    fwrite(&header, sizeof(header), 1, m_File);
+
+    return true;
+}
+
+void CJournalRecorder::Stop()
+{
+    if (m_File)
+    {
+        fclose(m_File);
+
+        m_File = NULL;
+    }
+}
+
+void CJournalRecorder::RecordRestart(unsigned long random_seed)
+{
+    WriteEntry(eJOURNAL_ENTRY_RESTART, random_seed, 0.0f);
+}
+
+//
+// Record every value in config, which has just been passed over to the world
+//
+
+void CJournalRecorder::RecordConfig(const CConfig *config)
+{
+    for (int i = 0; i < NUM_CONFIG_VALUES; i++)
+    {
+        WriteEntry(eJOURNAL_ENTRY_CONFIG_VALUE, i, config->Get((eConfigValue)i));
+    }
+
+    WriteEntry(eJOURNAL_ENTRY_APPLY_CONFIG, 0, 0.0f);
+}
+
+//
+// Record the start of a timestep, along with the state of each key that's
+// about to be passed into CWorld::HandleKeyboardState()
+//
+
+void CJournalRecorder::RecordBeginTimestep(const bool *key_state)
+{
+    DWORD key_bits = 0;
+
+    for (int i = 0; i < NUM_KEYS; i++)
+    {
+        if (key_state[i])
+        {
+            key_bits |= (1 << i);
+        }
+    }
+
+    WriteEntry(eJOURNAL_ENTRY_BEGIN_TIMESTEP, key_bits, 0.0f);
+}
+
+void CJournalRecorder::RecordSetting(eWorldSetting setting, float new_value)
+{
+    WriteEntry(eJOURNAL_ENTRY_SETTING, setting, new_value);
+}
+
+void CJournalRecorder::RecordResetSteering()
+{
+    WriteEntry(eJOURNAL_ENTRY_RESET_STEERING, 0, 0.0f);
+}
+
+void CJournalRecorder::RecordDoTimestep(float timestep)
+{
+    WriteEntry(eJOURNAL_ENTRY_DO_TIMESTEP, 0, timestep);
+}
+
+void CJournalRecorder::RecordEndTimestep()
+{
+    WriteEntry(eJOURNAL_ENTRY_END_TIMESTEP, 0, 0.0f);
+}
+
+void CJournalRecorder::WriteEntry(eJournalEntryType type, DWORD index, float value)
+{
+    if (!m_File)
+    {
+        return;
+    }
+
+    SJournalEntry entry;
+
+    entry.m_Type    = type;
+    entry.m_Index   = index;
+    entry.m_Value   = value;
+
+    fwrite(&entry, sizeof(entry), 1, m_File);
+}
+
+CJournalPlayer::CJournalPlayer()
+{
+    m_File                  = NULL;
+    m_NumTimestepsPlayed    = 0;
+}
+
+//
+// Open filename and check its header
+//
+
+bool CJournalPlayer::Open(const char *filename)
+{
+    Close();
+
+    m_File = fopen(filename, "rb");
+
+    if (!m_File)
+    {
+        TRACE("Unable to open journal file %s\n", filename);
+
+        return false;
+    }
+
+    SJournalFileHeader header;
+
+    if ((fread(&header, sizeof(header), 1, m_File) != 1) ||
+        (memcmp(header.m_Magic, "JRNL", sizeof(header.m_Magic)) != 0) ||
+        (header.m_Version != JournalFileVersion))
+    {
+        TRACE("%s is not a journal file we can read\n", filename);
+
+        Close();
+
+        return false;
+    }
+
+    m_Config.SetDefaults();
+
+    m_NumTimestepsPlayed = 0;
+
+    return true;
+}
+
+void CJournalPlayer::Close()
+{
+    if (m_File)
+    {
+        fclose(m_File);
+
+        m_File = NULL;
+    }
+}
+
+//
+// Read the next entry from our journal and make the same call on world
+// that was made when it was recorded. Returns false when there are no
+// entries left.
+//
+
+bool CJournalPlayer::PlayNextEntry(CWorld *world)
+{
+    if (!m_File)
+    {
+        return false;
+    }
+
+    SJournalEntry entry;
+
+    if (fread(&entry, sizeof(entry), 1, m_File) != 1)
+    {
+        return false;
+    }
+
+    switch (entry.m_Type)
+    {
+        case eJOURNAL_ENTRY_RESTART:
+        {
+            world->Restart(entry.m_Index);
+
+            break;
+        }
+
+        case eJOURNAL_ENTRY_CONFIG_VALUE:
+        {
+            if (entry.m_Index < NUM_CONFIG_VALUES)
+            {
+                m_Config.Set((eConfigValue)entry.m_Index, entry.m_Value);
+            }
+            else
+            {
+                TRACE("Unknown config value %lu in journal\n", entry.m_Index);
+            }
+
+            break;
+        }
+
+        case eJOURNAL_ENTRY_APPLY_CONFIG:
+        {
+            world->SetConfig(&m_Config);
+
+            break;
+        }
+
+        case eJOURNAL_ENTRY_BEGIN_TIMESTEP:
+        {
+            world->BeginTimestep();
+
+            for (int i = 0; i < NUM_KEYS; i++)
+            {
+                world->HandleKeyboardState((eKey)i, (entry.m_Index & (1 << i)) != 0);
+            }
+
+            break;
+        }
+
+        case eJOURNAL_ENTRY_SETTING:
+        {
+            world->SetSetting((eWorldSetting)entry.m_Index, entry.m_Value);
+
+            break;
+        }
+
+        case eJOURNAL_ENTRY_RESET_STEERING:
+        {
+            world->GetMissile()->ResetSteering();
+
+            break;
+        }
+
+        case eJOURNAL_ENTRY_DO_TIMESTEP:
+        {
+            world->DoTimestep(entry.m_Value);
+
+            m_NumTimestepsPlayed++;
+
+            break;
+        }
+
+        case eJOURNAL_ENTRY_END_TIMESTEP:
+        {
+            world->EndTimestep();
+
+            break;
+        }
+
+        default:
+        {
+            TRACE("Unknown journal entry type %lu\n", entry.m_Type);
+
+            break;
+        }
+    }
+
+    return true;
+}
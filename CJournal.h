@@ -0,0 +1,98 @@
+//
+// Classes to record everything that happens to a world from the outside,
+// and to play it back again later.
+//
+// The only things that change what a world does are its config, the seed
+// it was restarted from, the state of the keyboard, the settings changed
+// from the dialog box, the steering reset button, and the length of each
+// timestep. CJournalRecorder writes each of these to a journal file as it
+// happens, in the order it happens in. CJournalPlayer reads them back and
+// makes the same calls on another world, which then follows exactly the
+// same trajectory, as fast as it can be simulated.
+//
+// A journal is an SJournalFileHeader followed by SJournalEntry's, one per
+// event.
+//
+
+#ifndef CJOURNAL_H
+#define CJOURNAL_H
+
+#include "CConfig.h"
+#include "CWorld.h"
+
+// Everything that can happen to a world
+enum eJournalEntryType
+{
+    eJOURNAL_ENTRY_RESTART = 0,                 // m_Index is the random seed
+    eJOURNAL_ENTRY_CONFIG_VALUE,                // m_Index is the eConfigValue, m_Value is its value
+    eJOURNAL_ENTRY_APPLY_CONFIG,                // Pass all of the config values so far over to the world
+    eJOURNAL_ENTRY_BEGIN_TIMESTEP,              // m_Index has bit N set if key N is down
+    eJOURNAL_ENTRY_SETTING,                     // m_Index is the eWorldSetting, m_Value is its new value
+    eJOURNAL_ENTRY_RESET_STEERING,
+    eJOURNAL_ENTRY_DO_TIMESTEP,                 // m_Value is the timestep
+    eJOURNAL_ENTRY_END_TIMESTEP,
+
+    NUM_JOURNAL_ENTRY_TYPES,
+};
+
+// Header at the start of the file
+struct SJournalFileHeader
+{
+    char            m_Magic[4];                 // Always "JRNL"
+    DWORD           m_Version;                  // JournalFileVersion
+};
+
+// One event
+struct SJournalEntry
+{
+    DWORD           m_Type;                     // An eJournalEntryType
+    DWORD           m_Index;
+    float           m_Value;
+};
+
+class CJournalRecorder
+{
+public:
+    CJournalRecorder();
+    ~CJournalRecorder()                         { Stop(); }
+
+    bool            Start(const char *filename);
+    void            Stop();
+    bool            IsRecording()               { return (m_File != NULL); }
+
+    // These all do nothing if we're not recording
+
+    void            RecordRestart(unsigned long random_seed);
+    void            RecordConfig(const CConfig *config);
+    void            RecordBeginTimestep(const bool *key_state);
+    void            RecordSetting(eWorldSetting setting, float new_value);
+    void            RecordResetSteering();
+    void            RecordDoTimestep(float timestep);
+    void            RecordEndTimestep();
+
+private:
+    void            WriteEntry(eJournalEntryType type, DWORD index, float value);
+
+    FILE*           m_File;
+};
+
+class CJournalPlayer
+{
+public:
+    CJournalPlayer();
+    ~CJournalPlayer()                           { Close(); }
+
+    bool            Open(const char *filename);
+    void            Close();
+
+    bool            PlayNextEntry(CWorld *world);
+
+    unsigned long   GetNumTimestepsPlayed()     { return m_NumTimestepsPlayed; }
+
+private:
+    FILE*           m_File;
+    CConfig         m_Config;                   // Config values read so far, waiting to be applied
+    unsigned long   m_NumTimestepsPlayed;
+};
+
+#endif
@@ -0,0 +1,238 @@
+//
+// Counters and histograms of how our controllers are behaving, for
+// keeping an eye on them while the demo is running instead of reading
+// through TRACE output.
+//
+// Every thread's copy of the metrics is kept on one list, which is only
+// ever added to, with a compare-exchange, so a thread can add its own
+// while others are reading the list.
+//
+
+#include "stdafx.h"
+#include "CMetrics.h"
+
+//
+// Tuning constants
+//
+
+const float MetricHistogramBucketGrowth = 2.0f;     // Each bucket is this many times as wide as the one before it
+
+// How each metric is written out. The order here must match the order of
+// eMetric and eMetricHistogram.
+
+struct SMetricDescription
+{
+    eMetric         m_Metric;
+    const char*     m_Name;
+    const char*     m_Help;
+};
+
+static const SMetricDescription MetricDescription[NUM_METRICS] =
+{
+    { eMETRIC_ADAPTATION_STEPS_TAKEN,           "adaptation_steps_taken",           "Adaptive controller steps that moved one or more coefficients"                 },
+    { eMETRIC_ADAPTATION_STEPS_SKIPPED,         "adaptation_steps_skipped",         "Adaptive controller steps skipped because every term was below its threshold"  },
+    { eMETRIC_P_COEFFICIENT_CLAMP_HITS,         "p_coefficient_clamp_hits",         "Updates that pushed the P coefficient past its min or max"                     },
+    { eMETRIC_I_COEFFICIENT_CLAMP_HITS,         "i_coefficient_clamp_hits",         "Updates that pushed the I coefficient past its min or max"                     },
+    { eMETRIC_D_COEFFICIENT_CLAMP_HITS,         "d_coefficient_clamp_hits",         "Updates that pushed the D coefficient past its min or max"                     },
+    { eMETRIC_SENSITIVITY_DERIVATIVE_CLAMPS,    "sensitivity_derivative_clamps",    "Sensitivity derivatives clamped to MaxSensitivityDerivative"                   },
+    { eMETRIC_RLS_COVARIANCE_RESETS,            "rls_covariance_resets",            "Recursive least-squares covariances reset after shrinking or losing shape"     },
+    { eMETRIC_DERIVATIVE_SENTINELS,             "derivative_sentinels",             "Errors recorded with a timestep too short to take their derivative"            },
+    { eMETRIC_INTEGRAL_WINDUP_HOLDS,            "integral_windup_holds",            "Errors left out of the PID integral because they'd have wound it up"           },
+    { eMETRIC_INTERCEPTS,                       "intercepts",                       "Missiles that hit their target"                                                },
+    { eMETRIC_MISSES,                           "misses",                           "Missiles that passed close to their target without hitting it"                 },
+    { eMETRIC_MISSILE_EXTRA_SUBSTEPS,           "missile_extra_substeps",           "Substeps missiles took beyond the one per timestep"                            },
+    { eMETRIC_STEP_HEAP_ALLOCATIONS,            "step_heap_allocations",            "Heap allocations made while the world was being stepped (Debug builds only)"  },
+};
+
+struct SMetricHistogramDescription
+{
+    eMetricHistogram    m_Histogram;
+    const char*         m_Name;
+    const char*         m_Help;
+    float               m_FirstBucketSize;      // Upper bound of our first bucket
+};
+
+static const SMetricHistogramDescription MetricHistogramDescription[NUM_METRIC_HISTOGRAMS] =
+{
+    { eMETRIC_HISTOGRAM_HEADING_ERROR,          "heading_error_degrees",            "Absolute heading error each timestep",                                 0.01f   },
+    { eMETRIC_HISTOGRAM_MODEL_ERROR,            "model_error",                      "Absolute difference between actual and model behavior each timestep",  0.01f   },
+    { eMETRIC_HISTOGRAM_MISS_DISTANCE,          "miss_distance",                    "Closest approach of each miss, in world units",                        10.0f   },
+    { eMETRIC_HISTOGRAM_INTEGRAL_DRIFT,         "pid_integral_drift",               "Difference between a running PID error integral and one added up from scratch",   1.0e-7f },
+};
+
+// One thread's copy of every metric
+class CMetricsThreadBlock
+{
+public:
+    unsigned __int64        m_Counter[NUM_METRICS];
+    unsigned __int64        m_HistogramBucket[NUM_METRIC_HISTOGRAMS][NUM_METRIC_HISTOGRAM_BUCKETS];
+    double                  m_HistogramSum[NUM_METRIC_HISTOGRAMS];         // Of the magnitudes of every sample
+    CMetricsThreadBlock*    m_Next;                                         // On MetricsThreadBlocks
+};
+
+static CMetricsThreadBlock* volatile                MetricsThreadBlocks         = NULL;
+
+static __declspec(thread) CMetricsThreadBlock*      MetricsCurrentThreadBlock   = NULL;
+
+//
+// Returns the calling thread's copy of the metrics, creating it if this
+// is the first metric the thread has updated
+//
+
+CMetricsThreadBlock *CMetrics::GetThreadBlock()
+{
+    if (!MetricsCurrentThreadBlock)
+    {
+        CMetricsThreadBlock *block = new CMetricsThreadBlock;
+
+        memset(block, 0, sizeof(*block));
+
+        // Blocks are never freed, even once their thread has finished,
+        // since their counts still belong in the totals
+
+        do
+        {
+            block->m_Next = MetricsThreadBlocks;
+        }
+        while (InterlockedCompareExchangePointer((PVOID volatile *)&MetricsThreadBlocks, block, block->m_Next) != block->m_Next);
+
+        MetricsCurrentThreadBlock = block;
+    }
+
+    return MetricsCurrentThreadBlock;
+}
+
+void CMetrics::Add(eMetric metric, LONG count)
+{
+    ASSERT((metric >= 0) && (metric < NUM_METRICS));
+
+    GetThreadBlock()->m_Counter[metric] += count;
+}
+
+//
+// Returns the total of metric over every thread
+//
+
+unsigned __int64 CMetrics::Get(eMetric metric)
+{
+    ASSERT((metric >= 0) && (metric < NUM_METRICS));
+
+    unsigned __int64 total = 0;
+
+    for (const CMetricsThreadBlock *block = MetricsThreadBlocks; block; block = block->m_Next)
+    {
+        total += block->m_Counter[metric];
+    }
+
+    return total;
+}
+
+//
+// Count value in the right bucket of histogram. Values are counted by
+// their magnitude, so negative values go in the same bucket as positive
+// ones.
+//
+
+void CMetrics::AddSample(eMetricHistogram histogram, float value)
+{
+    ASSERT((histogram >= 0) && (histogram < NUM_METRIC_HISTOGRAMS));
+
+    float   magnitude       = (value < 0.0f) ? -value : value;
+    float   bucket_limit    = MetricHistogramDescription[histogram].m_FirstBucketSize;
+    int     bucket          = 0;
+
+    while ((bucket < (NUM_METRIC_HISTOGRAM_BUCKETS - 1)) && (magnitude > bucket_limit))
+    {
+        bucket_limit *= MetricHistogramBucketGrowth;
+        bucket++;
+    }
+
+    CMetricsThreadBlock *block = GetThreadBlock();
+
+    block->m_HistogramBucket[histogram][bucket]++;
+    block->m_HistogramSum[histogram] += magnitude;
+}
+
+//
+// Set every counter and histogram back to zero
+//
+
+void CMetrics::Reset()
+{
+    for (CMetricsThreadBlock *block = MetricsThreadBlocks; block; block = block->m_Next)
+    {
+        memset(block->m_Counter,            0, sizeof(block->m_Counter));
+        memset(block->m_HistogramBucket,    0, sizeof(block->m_HistogramBucket));
+        memset(block->m_HistogramSum,       0, sizeof(block->m_HistogramSum));
+    }
+}
+
+//
+// Write every counter and histogram to filename, replacing whatever was
+// there. Histogram buckets are cumulative, as Prometheus expects. Returns
+// false if the file couldn't be written.
+//
+
+bool CMetrics::Dump(const char *filename)
+{
+    int                         i       = 0;
+    const CMetricsThreadBlock*  block   = NULL;
+
+    FILE *file = fopen(filename, "w");
+
+    if (!file)
+    {
+        TRACE("Unable to open metrics file %s\n", filename);
+
+        return false;
+    }
+
+    for (i = 0; i < NUM_METRICS; i++)
+    {
+        fprintf(file, "# HELP %s %s\n",     MetricDescription[i].m_Name, MetricDescription[i].m_Help);
+        fprintf(file, "# TYPE %s counter\n", MetricDescription[i].m_Name);
+        fprintf(file, "%s %I64u\n",         MetricDescription[i].m_Name, Get((eMetric)i));
+    }
+
+    for (i = 0; i < NUM_METRIC_HISTOGRAMS; i++)
+    {
+        const SMetricHistogramDescription   *description    = &MetricHistogramDescription[i];
+        float                               bucket_limit    = description->m_FirstBucketSize;
+        unsigned __int64                    total           = 0;
+        double                              sum             = 0.0;
+
+        fprintf(file, "# HELP %s %s\n",         description->m_Name, description->m_Help);
+        fprintf(file, "# TYPE %s histogram\n",  description->m_Name);
+
+        for (int bucket = 0; bucket < NUM_METRIC_HISTOGRAM_BUCKETS; bucket++)
+        {
+            for (block = MetricsThreadBlocks; block; block = block->m_Next)
+            {
+                total += block->m_HistogramBucket[i][bucket];
+            }
+
+            if (bucket < (NUM_METRIC_HISTOGRAM_BUCKETS - 1))
+            {
+                fprintf(file, "%s_bucket{le=\"%g\"} %I64u\n", description->m_Name, bucket_limit, total);
+            }
+            else
+            {
+                fprintf(file, "%s_bucket{le=\"+Inf\"} %I64u\n", description->m_Name, total);
+            }
+
+            bucket_limit *= MetricHistogramBucketGrowth;
+        }
+
+        for (block = MetricsThreadBlocks; block; block = block->m_Next)
+        {
+            sum += block->m_HistogramSum[i];
+        }
+
+        fprintf(file, "%s_sum %.9g\n",     description->m_Name, sum);
+        fprintf(file, "%s_count %I64u\n",  description->m_Name, total);
+    }
+
+    fclose(file);
+
+    return true;
+}
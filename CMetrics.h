@@ -0,0 +1,84 @@
+//
+// Counters and histograms of how our controllers are behaving, for
+// keeping an eye on them while the demo is running instead of reading
+// through TRACE output.
+//
+// Every thread that updates a metric gets its own 64-bit copy of all of
+// them the first time it does so, which only it writes to, so any thread
+// can call Increment(), Add() or AddSample() at any time, including the
+// workers stepping a world in parallel, without locking or sharing a
+// cache line with any other thread.
+//
+// Call Dump() every so often to write out the totals over every thread as
+// text, in the same format as a Prometheus scrape, so that they can be
+// read by eye or by anything that already reads that format. Get(), Dump()
+// and Reset() read or write every thread's copy, so should be called when
+// the other threads aren't updating them, such as between parallel steps.
+// Nothing is ever reset, apart from by Reset().
+//
+
+#ifndef CMETRICS_H
+#define CMETRICS_H
+
+// All of our counters
+enum eMetric
+{
+    // Adaptive controller
+    eMETRIC_ADAPTATION_STEPS_TAKEN = 0,             // Adaptive controller steps, however many coefficients each moved
+    eMETRIC_ADAPTATION_STEPS_SKIPPED,               // Steps skipped because every term to adapt was below its update threshold
+    eMETRIC_P_COEFFICIENT_CLAMP_HITS,               // Updates that pushed a coefficient past its min or max
+    eMETRIC_I_COEFFICIENT_CLAMP_HITS,
+    eMETRIC_D_COEFFICIENT_CLAMP_HITS,
+    eMETRIC_SENSITIVITY_DERIVATIVE_CLAMPS,          // Sensitivity derivatives clamped to MaxSensitivityDerivative
+    eMETRIC_RLS_COVARIANCE_RESETS,                  // Times a recursive least-squares covariance shrank too far, or was pushed out of shape, and was reset
+
+    // PID controller
+    eMETRIC_DERIVATIVE_SENTINELS,                   // Errors recorded with a timestep too short to take their derivative
+    eMETRIC_INTEGRAL_WINDUP_HOLDS,                  // Errors left out of the integral because they'd have wound it up
+
+    // Missile
+    eMETRIC_INTERCEPTS,                             // Missiles that hit their target
+    eMETRIC_MISSES,                                 // Missiles that passed close to their target without hitting it
+    eMETRIC_MISSILE_EXTRA_SUBSTEPS,                 // Substeps taken beyond the one per timestep
+
+    // World
+    eMETRIC_STEP_HEAP_ALLOCATIONS,                  // Heap allocations made while the world was being stepped. Debug builds only.
+
+    NUM_METRICS,
+};
+
+// All of our histograms
+enum eMetricHistogram
+{
+    eMETRIC_HISTOGRAM_HEADING_ERROR = 0,            // Absolute heading error each timestep, in degrees
+    eMETRIC_HISTOGRAM_MODEL_ERROR,                  // Absolute difference between actual and model behavior each timestep
+    eMETRIC_HISTOGRAM_MISS_DISTANCE,                // Closest approach of each miss, in world units
+    eMETRIC_HISTOGRAM_INTEGRAL_DRIFT,               // Difference between a PID controller's running integral and the same one added up from scratch
+
+    NUM_METRIC_HISTOGRAMS,
+};
+
+// Each histogram bucket is MetricHistogramBucketGrowth times as wide as
+// the one before it, with one more bucket for everything bigger
+#define NUM_METRIC_HISTOGRAM_BUCKETS 16
+
+class CMetricsThreadBlock;
+
+class CMetrics
+{
+public:
+    static void             Increment(eMetric metric)       { Add(metric, 1); }
+    static void             Add(eMetric metric, LONG count);
+    static unsigned __int64 Get(eMetric metric);
+
+    static void             AddSample(eMetricHistogram histogram, float value);
+
+    static void             Reset();
+
+    static bool             Dump(const char *filename);
+
+private:
+    static CMetricsThreadBlock*     GetThreadBlock();
+};
+
+#endif
@@ -1,502 +1,1080 @@
-//
-// Our missile. It has 2 control modes: either keyboard or PID controller. 
-//
-// The desired forward and angular accelerations from the keyboard are passed 
-// into SetUserDesiredAcceleration() and SetUserDesiredAngularAcceleration() every 
-// timestep. They're either used to set the missile's actual accelerations, or ignored,
-// depending on the missile's current control mode.
-//
-
-#include "stdafx.h"
-#include "math.h"
-#include "GlView.h"
-#include "CWorld.h"
-#include "CGraph.h"
-#include "CMissile.h"
-
-//
-// Tuning constants
-//
-
-const float MissileHeight                   = 400.0f;   // Height in world units
-const float MissileWidth                    = 200.0f;   // Width in world units
-const float MissileMaxAngularAcceleration   = 180.0f;   // Max acceleration in degrees / second^2
-
-const float MissileDragFactor               = 0.001f;   // Amount of drag to apply
-const float MissileRotationalDragFactor     = 0.005f;   // Amount of angular drag to apply
-
-const float MissileNumSecondsToExplode      = 0.5f;     // Num seconds to explode once target has been hit
-const float MissileExplosionSizeFactor      = 1.5f;     // By how many times does each dimension of the missile's size increase as it's exploding
-
-//
-// Steering model
-//
-
-#define MISSILE_STEERING_MODEL_NUM_CONTROL_POINTS 10
-
-const float MissileSteeringModelMinXValue = 0.0f;
-const float MissileSteeringModelMaxXValue = 90.0f;
-
-const float MissileSteeringModelControlPoint[MISSILE_STEERING_MODEL_NUM_CONTROL_POINTS] =
-{
-    // Process error    // Desired derivative
-    // (degrees)        // of process error
-                        // (degrees per second)
-    /* 0 */             0.0f,
-    /* 10 */            -2.0f,
-    /* 20 */            -10.0f,
-    /* 30 */            -20.0f,
-    /* 40 */            -20.0f,
-    /* 50 */            -20.0f,
-    /* 60 */            -20.0f,
-    /* 70 */            -20.0f,
-    /* 80 */            -20.0f,
-    /* 90 */            -20.0f,
-};
-
-//
-// Set some default values for our state variables
-//
-
-void CMissile::Init()
-{
-    m_ControlMode               = eMISSILE_CONTROL_PID;
-    m_pTarget                   = NULL;
-
-    m_SteeringAdaptiveController.SetCoefficients(0.0f, 0.0f, 0.0f);
-
-    m_RotationalDragFactor      = 0.0f;
-    m_MaxAngularAcceleration    = 0.0f;
-
-    m_PidOutputScale            = 1.0f;
-
-    for (int i = 0; i < NUM_MISSILE_TEXTURES; i++)
-    {
-        m_Texture[i].Free();
-    }
-}
-
-void CMissile::Reset()
-{
-    m_CurrentState          = eMISSILE_STATE_FLYING;
-
-    m_Position.x            = 0.0f;
-    m_Position.y            = 0.0f;
-
-    m_Direction.x           = 0.0f;
-    m_Direction.y           = -1.0f;
-
-    m_AngularVelocity       = 0.0f;
-    m_Speed                 = 0.0f;
-
-    m_Acceleration          = 0.0f;
-    m_AngularAcceleration   = 0.0f;
-}
-
-//
-// Initialises one texture from a .RAW file
-//
-
-void CMissile::SetTexture(const char *filename, int index, int width, 
-                          int height, int bit_depth)
-{
-    ASSERT((index >= 0) && (index < NUM_MISSILE_TEXTURES));
-
-    m_Texture[index].ReadFile(filename, width, height, bit_depth);
-}
-
-//
-// Width and height of our missile in world units
-//
-
-float CMissile::GetHeight()
-{
-    return MissileHeight;
-}
-
-float CMissile::GetWidth()
-{
-    return MissileWidth;
-}
-
-//
-// Number of seconds it takes our missile to explode
-// once it's hit its target
-//
-
-float CMissile::GetNumSecondsToExplode()
-{
-    return MissileNumSecondsToExplode;
-}
-
-//
-// Update our steering PID controller, and set the new forward and 
-// angular acceleration of our missile based on its current control mode.
-//
-
-void CMissile::Steer(float timestep)
-{
-    if (m_CurrentState != eMISSILE_STATE_FLYING)
-    {
-        m_SteeringAdaptiveController.ResetErrorHistory();
-
-        return;
-    }
-
-    //
-    // Always update our PID controllers, regardless of our current
-    // control mode, so that we will have a proper error history when
-    // switching from keyboard control to PID control.
-    //
-    // Note that this may cause problems with integral windup.
-    //
-
-    if (m_pTarget)
-    {
-        //
-        // First, figure out our steering, based on the error between
-        // our current heading and the direction of the target
-        //
-
-        CVector2 vector_to_target = *(m_pTarget->GetPosition()) - m_Position;
-
-        float heading_error = m_Direction.GetAngle() - vector_to_target.GetAngle();
-
-        // Make heading_error be between -180 and 180 degrees
-        if (heading_error > 180.0f)
-        {
-            heading_error -= 360.0f;
-        }
-        else if (heading_error < -180.0f)
-        {
-            heading_error += 360.0f;
-        }
-
-        // Our model relates the heading error to the desired derivative of the heading error.
-        // Thus, our "actual behavior value" is the current derivative of our heading error,
-        // except that we need to change the sign so that if the heading error is moving towards
-        // positive infinity, actual_heading_behavior should be positive, otherwise it
-        // should be negative
-
-        float model_behavior_value  = GetModelBehaviorValue(heading_error);
-        float d_term_value          = m_SteeringAdaptiveController.GetTermValue(eD_COEFFICIENT);
-        float actual_behavior_value = fabs(d_term_value);
-
-        if ((heading_error * d_term_value) < 0.0f)
-        {
-            actual_behavior_value = -actual_behavior_value;
-        }
-
-        m_SteeringAdaptiveController.SetAdaptationEnabled(m_ControlMode == eMISSILE_CONTROL_ADAPTIVE_PID);
-
-        m_SteeringAdaptiveController.Update(timestep, heading_error, model_behavior_value, actual_behavior_value);
-    }
-
-    //
-    // Now we're ready to update our current forward and angular acclerations
-    // based on our current control mode
-    //
-
-    float   desired_acceleration            = 0.0f;
-    float   desired_angular_acceleration    = 0.0f;
-
-    switch (m_ControlMode)
-    {
-        case eMISSILE_CONTROL_ADAPTIVE_PID:
-        case eMISSILE_CONTROL_PID:
-        {
-            desired_acceleration            = GetMaxAcceleration();
-            desired_angular_acceleration    = m_SteeringAdaptiveController.GetOutput() * m_PidOutputScale;
-
-            break;
-        }
-
-        case eMISSILE_CONTROL_KEYBOARD:
-        {
-            desired_acceleration            = m_UserDesiredAcceleration;
-            desired_angular_acceleration    = m_UserDesiredAngularAcceleration;
-
-            break;
-        }
-
-        default:
-        {
-            TRACE("Unknown missile control mode: %d\n", m_ControlMode);
-
-            break;
-        }
-    }
-
-    // Make sure that our desired accelerations don't exceed their maximum values
-    desired_acceleration                    = Clamp(desired_acceleration,           0.0f,                           GetMaxAcceleration());
-    desired_angular_acceleration            = Clamp(desired_angular_acceleration,   -GetMaxAngularAcceleration(),   GetMaxAngularAcceleration());
-
-    SetAcceleration(desired_acceleration);
-    SetAngularAcceleration(desired_angular_acceleration);
-}
-
-//
-// Move our missile, based on its current forward and angular acceleration,
-// by timestep seconds.
-//
-
-void CMissile::Move(float timestep)
-{
-    switch (m_CurrentState)
-    {
-        case eMISSILE_STATE_FLYING:
-        {
-            //
-            // Apply our accelerations
-            //
-
-            m_Speed += m_Acceleration * timestep;
-
-            // We're always moving in the direction that we're facing
-            CVector2 velocity = m_Direction;
-            velocity.Normalize(m_Speed);
-
-            m_AngularVelocity += m_AngularAcceleration * timestep;
-
-            //
-            // Model a bit of drag. Drag is proportional to
-            // velocity squared.
-            //
-
-            // Drag on our speed
-
-            float drag      = -m_Speed * (float)fabs(m_Speed); // Be sure to preserve m_Speed's sign when squaring it
-            drag            *= (MissileDragFactor * timestep);
-
-            m_Speed         += drag;
-
-            // Drag on our angular velocity
-
-            float rotational_drag   = -m_AngularVelocity * (float)fabs(m_AngularVelocity); // Be sure to preserve m_Speed's sign when squaring it
-            rotational_drag         *= (m_RotationalDragFactor * timestep);
-
-            m_AngularVelocity       += rotational_drag;
-
-            //
-            // Update our direction
-            //
-
-            float delta_angle = m_AngularVelocity * timestep;
-
-            m_Direction.Rotate(delta_angle);
-            m_Direction.Normalize();
-
-            //
-            // Update our position
-            //
-
-            m_Position += velocity * timestep;
-
-            break;
-        }
-
-        case eMISSILE_STATE_EXPLODING:
-        {
-            m_ExplosionTimeLeft -= timestep;
-
-            if (m_ExplosionTimeLeft < 0.0f)
-            {
-                m_ExplosionTimeLeft = 0.0f;
-                m_CurrentState      = eMISSILE_STATE_FINISHED_EXPLODING;
-            }
-
-            // Fall through to the next case
-        }
-
-        case eMISSILE_STATE_FINISHED_EXPLODING:
-        {
-            // We're not moving, so there's nothing to do
-
-            break;
-        }
-
-        default:
-        {
-            TRACE("Unknown missile state: %d\n", m_CurrentState);
-
-            break;
-        }
-    }
-
-    //
-    // Simple logic to keep us within the world
-    //
-
-    float my_half_size      = max(GetWidth(), GetHeight()) / 2.0f;
-    float world_half_size   = m_pCurrentWorld->GetSize() / 2.0f;
-
-    float furthest_negative = -world_half_size  + my_half_size;
-    float furthest_positive = world_half_size   - my_half_size;
-
-    m_Position.x            = Clamp(m_Position.x, furthest_negative, furthest_positive);
-    m_Position.y            = Clamp(m_Position.y, furthest_negative, furthest_positive);
-
-    //DumpState();
-}
-
-//
-// Check to see if we've hit our target, and explode if we have
-//
-
-void CMissile::CheckCollisionWithTarget()
-{
-    bool impact_has_occured = false;
-
-    if ((m_pTarget->GetCurrentState()   == eTARGET_STATE_MOVING) &&
-        (GetCurrentState()              == eMISSILE_STATE_FLYING))
-    {
-        // This is an axis-aligned bounding box test, so we
-        // won't take the orientation of our missile into account
-
-        CVector2*   target_position     = m_pTarget->GetPosition();
-        float       target_half_size    = m_pTarget->GetSize() / 2.0f;
-        float       missile_half_size   = max(GetWidth(), GetHeight()) / 2.0f;
-
-        CVector2    missile_bbox_min(m_Position.x       - missile_half_size,    m_Position.y        - missile_half_size);
-        CVector2    missile_bbox_max(m_Position.x       + missile_half_size,    m_Position.y        + missile_half_size);
-
-        CVector2    target_bbox_min(target_position->x  - target_half_size,     target_position->y  - target_half_size);
-        CVector2    target_bbox_max(target_position->x  + target_half_size,     target_position->y  + target_half_size);
-
-        // Test if the boxes aren't overlapping, then invert the result
-        impact_has_occured = !( (missile_bbox_min.x > target_bbox_max.x)    ||
-                                (missile_bbox_min.y > target_bbox_max.y)    ||
-                                (missile_bbox_max.x < target_bbox_min.x)    ||
-                                (missile_bbox_max.y < target_bbox_max.y));
-    }
-
-    if (impact_has_occured)
-    {
-        m_CurrentState      = eMISSILE_STATE_EXPLODING;
-        m_ExplosionTimeLeft = GetNumSecondsToExplode();
-
-        m_pTarget->Explode();
-    }
-}
-
-//
-// Draw our missile on the specified view
-//
-
-int CMissile::Draw(CGlView *gl_view)
-{
-    eMissileTexture texture_to_use      = eMISSILE_TEXTURE_NO_FLAME;
-    float           missile_half_width  = GetWidth() / 2.0f;
-    float           missile_half_height = GetHeight() / 2.0f;
-    float           texture_alpha       = 1.0f;
-
-    switch (m_CurrentState)
-    {
-        case eMISSILE_STATE_FLYING:
-        {
-            if (m_Acceleration > 0.1f)
-            {
-                texture_to_use = (eMissileTexture)((rand() % (eMISSILE_TEXTURE_FLAME_3 - eMISSILE_TEXTURE_FLAME_1 + 1)) + eMISSILE_TEXTURE_FLAME_1);
-            }
-
-            break;
-        }
-
-        case eMISSILE_STATE_EXPLODING:
-        {
-            texture_to_use = eMISSILE_TEXTURE_EXPLOSION;
-
-            // Make the explosion scale and fade over time
-            float explosion_fraction_complete           = (GetNumSecondsToExplode() - m_ExplosionTimeLeft) / GetNumSecondsToExplode();
-
-            float min_explosion_size                    = max(missile_half_width, missile_half_height);
-            float max_explosion_size                    = min_explosion_size * MissileExplosionSizeFactor;
-            missile_half_width = missile_half_height    = ((max_explosion_size - min_explosion_size) * explosion_fraction_complete) + min_explosion_size;
-
-            texture_alpha                               = 1.0f - explosion_fraction_complete;
-
-            break;
-        }
-
-        case eMISSILE_STATE_FINISHED_EXPLODING:
-        {
-            return TRUE; // Nothing to draw if we're done exploding
-
-            break;
-        }
-
-        default:
-        {
-            TRACE("Unknown missile state: %d\n", m_CurrentState);
-
-            break;
-        }
-    }
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_TEXTURE_2D);
-
-    if (m_Texture[texture_to_use].GetData() != NULL)
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, 4, m_Texture[texture_to_use].GetWidth(),
-            m_Texture[texture_to_use].GetHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE,
-            m_Texture[texture_to_use].GetData());
-    }
-
-    glLoadIdentity();
-    glTranslatef(m_Position.x, m_Position.y, 0.0f);
-    glRotatef(GetAngle(), 0.0f, 0.0f, -1.0f);
-
-    glColor4f(1.0f, 1.0f, 1.0f, texture_alpha);
-
-    glBegin(GL_QUADS);
-        glTexCoord2f(1.0f, 0.0f); glVertex2f(-missile_half_width,  missile_half_height);
-        glTexCoord2f(0.0f, 0.0f); glVertex2f( missile_half_width,  missile_half_height);
-        glTexCoord2f(0.0f, 1.0f); glVertex2f( missile_half_width, -missile_half_height);
-        glTexCoord2f(1.0f, 1.0f); glVertex2f(-missile_half_width, -missile_half_height);
-    glEnd();
-
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_BLEND);
-
-    return TRUE;
-}
-
-//
-// Debug printing of our current state
-//
-
-void CMissile::DumpState()
-{
-    TRACE(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>\n");
-    TRACE(">>> Position:             [%f, %f]\n",           m_Position.x,   m_Position.y);
-    TRACE(">>> Direction:            [%f, %f]\n",           m_Direction.x,  m_Direction.y);
-    TRACE(">>> Speed:                %f units/s\n",         m_Speed);
-    TRACE(">>> Angular velocity:     %f degrees/s\n",       m_AngularVelocity);
-    TRACE(">>> Acceleration:         %f units/s^2\n",       m_Acceleration);
-    TRACE(">>> Angular acceleration: %f degrees/s^2\n\n",   m_AngularAcceleration);
-    TRACE(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>\n");
-}
-
-//
-// Calculates our desired heading error derivative
-//
-
-float CMissile::GetModelBehaviorValue(float heading_error)
-{
-    // Set up our graph
-
-    CGraph model_graph(MISSILE_STEERING_MODEL_NUM_CONTROL_POINTS, MissileSteeringModelMinXValue, MissileSteeringModelMaxXValue);
-
-    for (int i = 0; i < MISSILE_STEERING_MODEL_NUM_CONTROL_POINTS; i++)
-    {
-        model_graph.SetControlPoint(i, MissileSteeringModelControlPoint[i]);
-    }
-
-    // Now, interpolate our model behavior value
-
-    float model_behavior_value = model_graph.GetValue(fabs(heading_error));
-
-    return model_behavior_value;
-}
\ No newline at end of file
+//
+// Our missile. It has 2 control modes: either keyboard or PID controller. 
+//
+// The desired forward and angular accelerations from the keyboard are passed 
+// into SetUserDesiredAcceleration() and SetUserDesiredAngularAcceleration() every 
+// timestep. They're either used to set the missile's actual accelerations, or ignored,
+// depending on the missile's current control mode.
+//
+
+#include "stdafx.h"
+#include "math.h"
+#include "GlView.h"
+#include "CWorld.h"
+#include "CGraph.h"
+#include "CProfiler.h"
+#include "CMetrics.h"
+#include "CMissile.h"
+
+//
+// Tuning constants
+//
+// The rest of our tuning values, such as our size, drag and steering model,
+// are read from our CConfig. See CConfig.cpp for their default values.
+//
+
+const float MissileNearMissDistanceFactor   = 3.0f;     // Passing within this many times the distance at which we'd hit our target, without hitting it, counts as a miss
+
+// Guidance
+const float MissileMaxLeadSine              = 0.866f;   // Sine of the largest lead angle proportional navigation will aim off by. 60 degrees.
+const float MissileMaxInterceptTime         = 5.0f;     // Furthest ahead, in seconds, that we'll predict an intercept
+const float MissileMinGuidanceSpeed         = 1.0f;     // Slower than this, we can't lead our target, and pursue it instead
+
+// Largest changes we'll allow in one substep, when our config allows more
+// than one
+const float MissileSubstepMaxAngularVelocityChange  = 10.0f;    // Degrees / second
+const float MissileSubstepMaxTurn                   = 5.0f;     // Degrees
+const float MissileSubstepMaxDistanceFraction       = 0.1f;     // Of the distance to our target
+
+//
+// Advance a velocity, under a constant acceleration and a drag of
+// -drag_factor * velocity * |velocity|, by time seconds, exactly. Returns
+// the new velocity, and the distance covered (signed, like the velocity).
+//
+// We mirror things so that the acceleration is +ve. Then if we're moving
+// with it, we approach terminal velocity along a tanh() curve, and if
+// we're moving against it, both it and drag slow us along a tan() curve
+// until we stop and turn around.
+//
+
+static void SolveQuadraticDrag(float velocity, float acceleration, float drag_factor, float time, float *new_velocity, float *distance)
+{
+    if (drag_factor <= 0.0f)
+    {
+        *new_velocity   = velocity + (acceleration * time);
+        *distance       = (velocity * time) + (0.5f * acceleration * time * time);
+
+        return;
+    }
+
+    double  sign                = (acceleration != 0.0f) ? Sign(acceleration) : Sign(velocity);
+    double  v                   = sign * velocity;
+    double  a                   = sign * acceleration;
+    double  k                   = drag_factor;
+    double  t                   = time;
+    double  covered             = 0.0;
+
+    if (sign == 0.0)
+    {
+        *new_velocity   = 0.0f;
+        *distance       = 0.0f;
+
+        return;
+    }
+
+    if (v < 0.0)
+    {
+        // Moving against our acceleration, so both it and drag slow us down
+
+        double terminal_velocity    = sqrt(a / k);
+        double phase                = atan(-v / terminal_velocity);
+        double time_to_stop         = phase / (k * terminal_velocity);
+
+        if (t < time_to_stop)
+        {
+            double remaining_phase  = phase - (k * terminal_velocity * t);
+
+            *new_velocity           = (float)(sign * -terminal_velocity * tan(remaining_phase));
+            *distance               = (float)(sign * -log(cos(remaining_phase) / cos(phase)) / k);
+
+            return;
+        }
+
+        // We stop, then carry on from rest for the rest of the time
+
+        covered     = log(cos(phase)) / k;
+        v           = 0.0;
+        t           -= time_to_stop;
+    }
+
+    if (a == 0.0)
+    {
+        // Coasting, with only drag
+
+        *new_velocity   = (float)(sign * v / (1.0 + (k * v * t)));
+        *distance       = (float)(sign * (covered + (log(1.0 + (k * v * t)) / k)));
+
+        return;
+    }
+
+    // Moving with our acceleration, towards terminal velocity. The distance
+    // is log(cosh(x) + r sinh(x)) / k, rearranged so that it can't overflow.
+
+    double terminal_velocity    = sqrt(a / k);
+    double x                    = k * terminal_velocity * t;
+    double r                    = v / terminal_velocity;
+    double tanh_x               = tanh(x);
+
+    *new_velocity   = (float)(sign * terminal_velocity * (v + (terminal_velocity * tanh_x)) / (terminal_velocity + (v * tanh_x)));
+    *distance       = (float)(sign * (covered + ((x + log((0.5 * (1.0 + r)) + (0.5 * (1.0 - r) * exp(-2.0 * x)))) / k)));
+}
+
+//
+// Set some default values for our state variables
+//
+
+void CMissile::Init()
+{
+    m_ControlMode               = eMISSILE_CONTROL_PID;
+    m_pTarget                   = NULL;
+    m_pConfig                   = NULL;
+    m_pTelemetryRecorder        = NULL;
+
+    m_SteeringAdaptiveController.SetCoefficients(0.0f, 0.0f, 0.0f);
+
+    m_RotationalDragFactor      = 0.0f;
+    m_MaxAngularAcceleration    = 0.0f;
+    m_MaxAcceleration           = 0.0f;
+
+    m_PidOutputScale            = 1.0f;
+}
+
+void CMissile::Reset()
+{
+    m_CurrentState          = eMISSILE_STATE_FLYING;
+
+    m_Position.x            = 0.0f;
+    m_Position.y            = 0.0f;
+
+    m_Direction.x           = 0.0f;
+    m_Direction.y           = -1.0f;
+
+    m_AngularVelocity       = 0.0f;
+    m_Speed                 = 0.0f;
+
+    m_Acceleration          = 0.0f;
+    m_AngularAcceleration   = 0.0f;
+
+    m_ExplosionTimeLeft     = 0.0f;
+
+    m_PreviousDistanceToTarget  = -1.0f;
+    m_ApproachingTarget         = false;
+
+    // Don't steer from errors from before we were reset
+    m_SteeringAdaptiveController.ResetErrorHistory();
+}
+
+//
+// Use the tuning values in config from now on. Our steering controller
+// is set up from them right away.
+//
+
+void CMissile::SetConfig(const CConfig *config)
+{
+    m_pConfig = config;
+
+    ApplySteeringConfig();
+}
+
+//
+// Reset our steering controller, then set it up again from our config
+//
+
+void CMissile::ResetSteering()
+{
+    m_SteeringAdaptiveController.Reset();
+
+    ApplySteeringConfig();
+}
+
+//
+// Send the adaptive controller tuning values from our config over to
+// our steering controller
+//
+
+void CMissile::ApplySteeringConfig()
+{
+    if (!m_pConfig)
+    {
+        return;
+    }
+
+    m_SteeringAdaptiveController.SetAdaptationRule((eAdaptationRule)m_pConfig->GetInt(eCONFIG_STEERING_ADAPTATION_RULE));
+    m_SteeringAdaptiveController.SetTimeslice(m_pConfig->Get(eCONFIG_STEERING_TIMESLICE));
+    m_SteeringAdaptiveController.SetCoefficientClamp(eP_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_MIN_P_COEFFICIENT), m_pConfig->Get(eCONFIG_STEERING_MAX_P_COEFFICIENT));
+    m_SteeringAdaptiveController.SetCoefficientClamp(eI_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_MIN_I_COEFFICIENT), m_pConfig->Get(eCONFIG_STEERING_MAX_I_COEFFICIENT));
+    m_SteeringAdaptiveController.SetCoefficientClamp(eD_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_MIN_D_COEFFICIENT), m_pConfig->Get(eCONFIG_STEERING_MAX_D_COEFFICIENT));
+    m_SteeringAdaptiveController.SetUpdateThreshold(eP_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_P_UPDATE_THRESHOLD));
+    m_SteeringAdaptiveController.SetUpdateThreshold(eI_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_I_UPDATE_THRESHOLD));
+    m_SteeringAdaptiveController.SetUpdateThreshold(eD_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_D_UPDATE_THRESHOLD));
+    m_SteeringAdaptiveController.SetAdaptationGain(eP_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_P_ADAPTATION_GAIN));
+    m_SteeringAdaptiveController.SetAdaptationGain(eI_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_I_ADAPTATION_GAIN));
+    m_SteeringAdaptiveController.SetAdaptationGain(eD_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_D_ADAPTATION_GAIN));
+    m_SteeringAdaptiveController.SetAlpha(eP_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_P_ALPHA));
+    m_SteeringAdaptiveController.SetAlpha(eI_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_I_ALPHA));
+    m_SteeringAdaptiveController.SetAlpha(eD_COEFFICIENT, m_pConfig->Get(eCONFIG_STEERING_D_ALPHA));
+    m_SteeringAdaptiveController.SetDerivativeEstimator((eDerivativeEstimator)m_pConfig->GetInt(eCONFIG_STEERING_DERIVATIVE_ESTIMATOR), m_pConfig->Get(eCONFIG_STEERING_DERIVATIVE_TIME_CONSTANT));
+    m_SteeringAdaptiveController.SetIntegralMode((eIntegralMode)m_pConfig->GetInt(eCONFIG_STEERING_INTEGRAL_MODE), m_pConfig->Get(eCONFIG_STEERING_INTEGRAL_TIME_CONSTANT), m_pConfig->Get(eCONFIG_STEERING_TRACKING_TIME_CONSTANT));
+    m_SteeringAdaptiveController.SetAdaptationSchedule((eAdaptationSchedule)m_pConfig->GetInt(eCONFIG_STEERING_ADAPTATION_SCHEDULE), m_pConfig->Get(eCONFIG_STEERING_SENSITIVITY_TIME_CONSTANT));
+    m_SteeringAdaptiveController.SetRecursiveLeastSquares(m_pConfig->Get(eCONFIG_STEERING_RLS_FORGETTING_FACTOR), m_pConfig->Get(eCONFIG_STEERING_RLS_INITIAL_COVARIANCE), m_pConfig->Get(eCONFIG_STEERING_RLS_COVARIANCE_RESET_FRACTION));
+
+    // Our steering model, which is read every timestep, so it's set up
+    // here rather than each time it's needed
+
+    m_SteeringModelGraph.Initialize(MISSILE_STEERING_MODEL_NUM_CONTROL_POINTS, m_pConfig->Get(eCONFIG_MISSILE_STEERING_MODEL_MIN_X_VALUE), m_pConfig->Get(eCONFIG_MISSILE_STEERING_MODEL_MAX_X_VALUE));
+
+    for (int i = 0; i < MISSILE_STEERING_MODEL_NUM_CONTROL_POINTS; i++)
+    {
+        m_SteeringModelGraph.SetControlPoint(i, m_pConfig->Get((eConfigValue)(eCONFIG_MISSILE_STEERING_MODEL_CONTROL_POINT_0 + i)));
+    }
+}
+
+//
+// Width and height of our missile in world units
+//
+
+float CMissile::GetHeight()
+{
+    return m_pConfig->Get(eCONFIG_MISSILE_HEIGHT);
+}
+
+float CMissile::GetWidth()
+{
+    return m_pConfig->Get(eCONFIG_MISSILE_WIDTH);
+}
+
+//
+// Number of seconds it takes our missile to explode
+// once it's hit its target
+//
+
+float CMissile::GetNumSecondsToExplode()
+{
+    return m_pConfig->Get(eCONFIG_MISSILE_NUM_SECONDS_TO_EXPLODE);
+}
+
+//
+// Update our steering PID controller, and set the new forward and 
+// angular acceleration of our missile based on its current control mode.
+//
+
+void CMissile::Steer(float timestep)
+{
+    PROFILE_ZONE("Missile.Steer");
+
+    if (m_CurrentState != eMISSILE_STATE_FLYING)
+    {
+        m_SteeringAdaptiveController.ResetErrorHistory();
+
+        return;
+    }
+
+    //
+    // Always update our PID controllers, regardless of our current
+    // control mode, so that we will have a proper error history when
+    // switching from keyboard control to PID control.
+    //
+    // That would wind up the integral, if it's over every error, so we
+    // tell the controller how much of its output goes unused below.
+    //
+
+    if (m_pTarget)
+    {
+        //
+        // First, figure out our steering, based on the error between
+        // our current heading and the direction our guidance wants us to
+        // head in
+        //
+
+        CVector2 guidance_direction = GetGuidanceDirection();
+
+        float heading_error = GetAngleBetween(&m_Direction, &guidance_direction);
+
+        CMetrics::AddSample(eMETRIC_HISTOGRAM_HEADING_ERROR, heading_error);
+
+        // Our model relates the heading error to the desired derivative of the heading error.
+        // Thus, our "actual behavior value" is the current derivative of our heading error,
+        // except that we need to change the sign so that if the heading error is moving towards
+        // positive infinity, actual_heading_behavior should be positive, otherwise it
+        // should be negative
+
+        float model_behavior_value  = GetModelBehaviorValue(heading_error);
+        float d_term_value          = m_SteeringAdaptiveController.GetTermValue(eD_COEFFICIENT);
+        float actual_behavior_value = fabs(d_term_value);
+
+        if ((heading_error * d_term_value) < 0.0f)
+        {
+            actual_behavior_value = -actual_behavior_value;
+        }
+
+        m_SteeringAdaptiveController.SetAdaptationEnabled(m_ControlMode == eMISSILE_CONTROL_ADAPTIVE_PID);
+
+        m_SteeringAdaptiveController.Update(timestep, heading_error, model_behavior_value, actual_behavior_value);
+
+        if (m_pTelemetryRecorder)
+        {
+            RecordTelemetry(timestep, heading_error, model_behavior_value, actual_behavior_value);
+        }
+    }
+
+    //
+    // Now we're ready to update our current forward and angular acclerations
+    // based on our current control mode
+    //
+
+    float   desired_acceleration            = 0.0f;
+    float   desired_angular_acceleration    = 0.0f;
+    float   steering_output                 = m_SteeringAdaptiveController.GetOutput();
+    float   pid_angular_acceleration        = steering_output * m_PidOutputScale;
+
+    switch (m_ControlMode)
+    {
+        case eMISSILE_CONTROL_ADAPTIVE_PID:
+        case eMISSILE_CONTROL_PID:
+        {
+            desired_acceleration            = GetMaxAcceleration();
+            desired_angular_acceleration    = pid_angular_acceleration;
+
+            break;
+        }
+
+        case eMISSILE_CONTROL_KEYBOARD:
+        {
+            desired_acceleration            = m_UserDesiredAcceleration;
+            desired_angular_acceleration    = m_UserDesiredAngularAcceleration;
+
+            break;
+        }
+
+        default:
+        {
+            TRACE("Unknown missile control mode: %d\n", m_ControlMode);
+
+            break;
+        }
+    }
+
+    // Make sure that our desired accelerations don't exceed their maximum values
+    desired_acceleration                    = Clamp(desired_acceleration,           0.0f,                           GetMaxAcceleration());
+    desired_angular_acceleration            = Clamp(desired_angular_acceleration,   -GetMaxAngularAcceleration(),   GetMaxAngularAcceleration());
+
+    // Let our steering controller know how much of its output wasn't
+    // used, either because it was clamped or because we're steering from
+    // the keyboard, so that its integral doesn't wind up
+
+    if ((desired_angular_acceleration != pid_angular_acceleration) && (m_PidOutputScale != 0.0f))
+    {
+        m_SteeringAdaptiveController.SetUnappliedOutput(steering_output - (desired_angular_acceleration / m_PidOutputScale));
+    }
+    else
+    {
+        m_SteeringAdaptiveController.SetUnappliedOutput(0.0f);
+    }
+
+    SetAcceleration(desired_acceleration);
+    SetAngularAcceleration(desired_angular_acceleration);
+}
+
+//
+// Our original integrator: explicit Euler, except that we move along the
+// speed we have after accelerating but before drag, and turn by the
+// angular velocity we have after both. Only accurate with small timesteps.
+//
+
+void CMissile::IntegrateExplicitEuler(float timestep)
+{
+    //
+    // Apply our accelerations
+    //
+
+    m_Speed += m_Acceleration * timestep;
+
+    // We're always moving in the direction that we're facing,
+    // which is always a unit vector
+    CVector2 velocity = m_Direction * m_Speed;
+
+    m_AngularVelocity += m_AngularAcceleration * timestep;
+
+    //
+    // Model a bit of drag. Drag is proportional to
+    // velocity squared.
+    //
+
+    // Drag on our speed
+
+    float drag      = -m_Speed * (float)fabs(m_Speed); // Be sure to preserve m_Speed's sign when squaring it
+    drag            *= (m_pConfig->Get(eCONFIG_MISSILE_DRAG_FACTOR) * timestep);
+
+    m_Speed         += drag;
+
+    // Drag on our angular velocity
+
+    float rotational_drag   = -m_AngularVelocity * (float)fabs(m_AngularVelocity); // Be sure to preserve m_Speed's sign when squaring it
+    rotational_drag         *= (m_RotationalDragFactor * timestep);
+
+    m_AngularVelocity       += rotational_drag;
+
+    //
+    // Update our direction
+    //
+
+    float delta_angle = m_AngularVelocity * timestep;
+
+    m_Direction.RotateBy(GetRotation(delta_angle));
+    m_Direction.Renormalize();
+
+    //
+    // Update our position
+    //
+
+    m_Position += velocity * timestep;
+}
+
+//
+// Semi-implicit (symplectic) Euler: update our speed and angular velocity
+// from their accelerations and drag first, then move and turn by the new
+// values. Just as cheap as explicit Euler, but much better behaved as the
+// timestep grows.
+//
+
+void CMissile::IntegrateSemiImplicitEuler(float timestep)
+{
+    float drag_factor   = m_pConfig->Get(eCONFIG_MISSILE_DRAG_FACTOR);
+
+    m_Speed             += (m_Acceleration          - (drag_factor              * m_Speed           * (float)fabs(m_Speed)))            * timestep;
+    m_AngularVelocity   += (m_AngularAcceleration   - (m_RotationalDragFactor   * m_AngularVelocity * (float)fabs(m_AngularVelocity)))  * timestep;
+
+    m_Direction.RotateBy(GetRotation(m_AngularVelocity * timestep));
+    m_Direction.Renormalize();
+
+    m_Position += m_Direction * (m_Speed * timestep);
+}
+
+//
+// Classic fourth order Runge-Kutta over our speed, angular velocity,
+// heading and position, holding our accelerations constant for the whole
+// timestep. The heading is integrated as an angle relative to where we're
+// facing at the start of the timestep, so that it can be turned back into
+// a direction with one rotation.
+//
+
+void CMissile::IntegrateRK4(float timestep)
+{
+    static const float  StageFraction[4]    = { 0.0f, 0.5f, 0.5f, 1.0f };  // Of the timestep, at which each stage is evaluated
+    static const float  StageWeight[4]      = { 1.0f, 2.0f, 2.0f, 1.0f };
+
+    float       drag_factor                 = m_pConfig->Get(eCONFIG_MISSILE_DRAG_FACTOR);
+    float       previous_speed_rate         = 0.0f;         // Derivatives from the previous stage
+    float       previous_angular_rate       = 0.0f;
+    float       previous_angle_rate         = 0.0f;
+    float       total_speed_rate            = 0.0f;         // Weighted sums of every stage's derivatives
+    float       total_angular_rate          = 0.0f;
+    float       total_angle_rate            = 0.0f;
+    CVector2    total_velocity(0.0f, 0.0f);
+
+    for (int stage = 0; stage < 4; stage++)
+    {
+        float       stage_time          = StageFraction[stage] * timestep;
+        float       speed               = m_Speed           + (previous_speed_rate      * stage_time);
+        float       angular_velocity    = m_AngularVelocity + (previous_angular_rate    * stage_time);
+        float       angle               = previous_angle_rate * stage_time;
+        CVector2    velocity            = m_Direction;
+
+        velocity.RotateBy(GetRotation(angle));
+        velocity *= speed;
+
+        previous_speed_rate     = m_Acceleration        - (drag_factor              * speed             * (float)fabs(speed));
+        previous_angular_rate   = m_AngularAcceleration - (m_RotationalDragFactor   * angular_velocity  * (float)fabs(angular_velocity));
+        previous_angle_rate     = angular_velocity;
+
+        total_speed_rate        += StageWeight[stage] * previous_speed_rate;
+        total_angular_rate      += StageWeight[stage] * previous_angular_rate;
+        total_angle_rate        += StageWeight[stage] * previous_angle_rate;
+        total_velocity          += velocity * StageWeight[stage];
+    }
+
+    m_Speed             += total_speed_rate     * (timestep / 6.0f);
+    m_AngularVelocity   += total_angular_rate   * (timestep / 6.0f);
+    m_Position          += total_velocity       * (timestep / 6.0f);
+
+    m_Direction.RotateBy(GetRotation(total_angle_rate * (timestep / 6.0f)));
+    m_Direction.Renormalize();
+}
+
+//
+// Solve our speed and angular velocity exactly, since with constant
+// acceleration and drag proportional to velocity squared they have closed
+// forms. We then move the distance we'd cover along the direction we'd
+// face halfway through the turn, which is exact for straight lines and
+// very close for the gentle arcs we fly in one timestep.
+//
+
+void CMissile::IntegrateAnalyticDrag(float timestep)
+{
+    float distance      = 0.0f;
+    float delta_angle   = 0.0f;
+
+    SolveQuadraticDrag(m_Speed,             m_Acceleration,         m_pConfig->Get(eCONFIG_MISSILE_DRAG_FACTOR),    timestep,   &m_Speed,           &distance);
+    SolveQuadraticDrag(m_AngularVelocity,   m_AngularAcceleration,  m_RotationalDragFactor,                         timestep,   &m_AngularVelocity, &delta_angle);
+
+    CVector2 halfway_direction = m_Direction;
+
+    halfway_direction.RotateBy(GetRotation(delta_angle * 0.5f));
+
+    m_Position += halfway_direction * distance;
+
+    m_Direction.RotateBy(GetRotation(delta_angle));
+    m_Direction.Renormalize();
+}
+
+//
+// Integrate our motion over timestep seconds, with the integrator chosen
+// by our config
+//
+
+void CMissile::Integrate(float timestep)
+{
+    switch (m_pConfig->GetInt(eCONFIG_MISSILE_INTEGRATOR))
+    {
+        case eMISSILE_INTEGRATOR_EXPLICIT_EULER:
+        {
+            IntegrateExplicitEuler(timestep);
+
+            break;
+        }
+
+        case eMISSILE_INTEGRATOR_SEMI_IMPLICIT_EULER:
+        {
+            IntegrateSemiImplicitEuler(timestep);
+
+            break;
+        }
+
+        case eMISSILE_INTEGRATOR_RK4:
+        {
+            IntegrateRK4(timestep);
+
+            break;
+        }
+
+        case eMISSILE_INTEGRATOR_ANALYTIC_DRAG:
+        {
+            IntegrateAnalyticDrag(timestep);
+
+            break;
+        }
+
+        default:
+        {
+            TRACE("Unknown missile integrator: %d\n", m_pConfig->GetInt(eCONFIG_MISSILE_INTEGRATOR));
+
+            IntegrateExplicitEuler(timestep);
+
+            break;
+        }
+    }
+}
+
+//
+// Work out how many substeps to split a timestep into, from how much our
+// angular velocity is about to change, how far we're about to turn, and
+// how close we'll get to our target. Missiles flying straight and far from
+// their target take one step; only the ones turning hard or closing in
+// pay for more.
+//
+
+int CMissile::GetNumSubsteps(float timestep)
+{
+    int max_substeps = m_pConfig->GetInt(eCONFIG_MISSILE_MAX_SUBSTEPS);
+
+    if (max_substeps <= 1)
+    {
+        return 1;
+    }
+
+    float angular_velocity_change   = (m_AngularAcceleration - (m_RotationalDragFactor * m_AngularVelocity * (float)fabs(m_AngularVelocity))) * timestep;
+    float turn                      = m_AngularVelocity * timestep;
+    float num_substeps              = 1.0f;
+
+    num_substeps = max(num_substeps, (float)fabs(angular_velocity_change)   / MissileSubstepMaxAngularVelocityChange);
+    num_substeps = max(num_substeps, (float)fabs(turn)                      / MissileSubstepMaxTurn);
+
+    if (m_pTarget)
+    {
+        float distance_to_target    = GetDistanceBetween(m_pTarget->GetPosition(), &m_Position);
+        float distance_moved        = (float)fabs(m_Speed) * timestep;
+
+        if (distance_to_target > 0.0f)
+        {
+            num_substeps = max(num_substeps, distance_moved / (MissileSubstepMaxDistanceFraction * distance_to_target));
+        }
+    }
+
+    int substeps = min((int)ceil(num_substeps), max_substeps);
+
+    if (substeps > 1)
+    {
+        CMetrics::Add(eMETRIC_MISSILE_EXTRA_SUBSTEPS, substeps - 1);
+    }
+
+    return substeps;
+}
+
+//
+// Move our missile, based on its current forward and angular acceleration,
+// by timestep seconds.
+//
+
+void CMissile::Move(float timestep)
+{
+    PROFILE_ZONE("Missile.Move");
+
+    switch (m_CurrentState)
+    {
+        case eMISSILE_STATE_FLYING:
+        {
+            //
+            // Take smaller steps when one big one would be inaccurate,
+            // checking for a collision with our target between them so
+            // that we can't pass straight through it. The last check is
+            // left to our world.
+            //
+
+            int     num_substeps    = GetNumSubsteps(timestep);
+            float   substep         = timestep / num_substeps;
+
+            for (int i = 0; (i < num_substeps) && (m_CurrentState == eMISSILE_STATE_FLYING); i++)
+            {
+                Integrate(substep);
+
+                if ((i < (num_substeps - 1)) && m_pTarget)
+                {
+                    CheckCollisionWithTarget();
+                }
+            }
+
+            break;
+        }
+
+        case eMISSILE_STATE_EXPLODING:
+        {
+            AdvanceExplosion(timestep);
+
+            // Fall through to the next case
+        }
+
+        case eMISSILE_STATE_FINISHED_EXPLODING:
+        {
+            // We're not moving, so there's nothing to do
+
+            break;
+        }
+
+        default:
+        {
+            TRACE("Unknown missile state: %d\n", m_CurrentState);
+
+            break;
+        }
+    }
+
+    //
+    // Simple logic to keep us within the world
+    //
+
+    float my_half_size      = max(GetWidth(), GetHeight()) / 2.0f;
+    float world_half_size   = m_pCurrentWorld->GetSize() / 2.0f;
+
+    float furthest_negative = -world_half_size  + my_half_size;
+    float furthest_positive = world_half_size   - my_half_size;
+
+    m_Position.x            = Clamp(m_Position.x, furthest_negative, furthest_positive);
+    m_Position.y            = Clamp(m_Position.y, furthest_negative, furthest_positive);
+
+    //DumpState();
+}
+
+//
+// Check to see if we've hit our target, and explode if we have
+//
+
+void CMissile::CheckCollisionWithTarget()
+{
+    PROFILE_ZONE("Missile.CheckCollisionWithTarget");
+
+    bool impact_has_occured = false;
+
+    if ((m_pTarget->GetCurrentState()   == eTARGET_STATE_MOVING) &&
+        (GetCurrentState()              == eMISSILE_STATE_FLYING))
+    {
+        // This is an axis-aligned bounding box test, so we
+        // won't take the orientation of our missile into account
+
+        CVector2*   target_position     = m_pTarget->GetPosition();
+        float       target_half_size    = m_pTarget->GetSize() / 2.0f;
+        float       missile_half_size   = max(GetWidth(), GetHeight()) / 2.0f;
+
+        CVector2    missile_bbox_min(m_Position.x       - missile_half_size,    m_Position.y        - missile_half_size);
+        CVector2    missile_bbox_max(m_Position.x       + missile_half_size,    m_Position.y        + missile_half_size);
+
+        CVector2    target_bbox_min(target_position->x  - target_half_size,     target_position->y  - target_half_size);
+        CVector2    target_bbox_max(target_position->x  + target_half_size,     target_position->y  + target_half_size);
+
+        // Test if the boxes aren't overlapping, then invert the result
+        impact_has_occured = !( (missile_bbox_min.x > target_bbox_max.x)    ||
+                                (missile_bbox_min.y > target_bbox_max.y)    ||
+                                (missile_bbox_max.x < target_bbox_min.x)    ||
+                                (missile_bbox_max.y < target_bbox_max.y));
+
+        // If we were closing in on our target and have just started moving
+        // away from it again, without hitting it, count a miss if we came
+        // close enough
+
+        float distance_to_target = (*target_position - m_Position).GetLength();
+
+        if (!impact_has_occured && (m_PreviousDistanceToTarget >= 0.0f))
+        {
+            if (distance_to_target < m_PreviousDistanceToTarget)
+            {
+                m_ApproachingTarget = true;
+            }
+            else if (m_ApproachingTarget)
+            {
+                m_ApproachingTarget = false;
+
+                if (m_PreviousDistanceToTarget < (MissileNearMissDistanceFactor * (target_half_size + missile_half_size)))
+                {
+                    CMetrics::Increment(eMETRIC_MISSES);
+                    CMetrics::AddSample(eMETRIC_HISTOGRAM_MISS_DISTANCE, m_PreviousDistanceToTarget);
+                }
+            }
+        }
+
+        m_PreviousDistanceToTarget = distance_to_target;
+    }
+
+    if (impact_has_occured)
+    {
+        m_CurrentState      = eMISSILE_STATE_EXPLODING;
+        m_ExplosionTimeLeft = GetNumSecondsToExplode();
+
+        m_pTarget->Explode();
+
+        CMetrics::Increment(eMETRIC_INTERCEPTS);
+    }
+}
+
+//
+// Count seconds off of our explosion, if we're exploding, finishing it
+// if that's all of it. Move() does this every timestep, but a world that
+// stops moving us while we explode can do it all at once when it needs
+// our explosion to be up to date.
+//
+
+void CMissile::AdvanceExplosion(float seconds)
+{
+    if (m_CurrentState != eMISSILE_STATE_EXPLODING)
+    {
+        return;
+    }
+
+    m_ExplosionTimeLeft -= seconds;
+
+    if (m_ExplosionTimeLeft < 0.0f)
+    {
+        m_ExplosionTimeLeft = 0.0f;
+        m_CurrentState      = eMISSILE_STATE_FINISHED_EXPLODING;
+    }
+}
+
+//
+// Draw our missile on the specified view
+//
+
+int CMissile::Draw(CGlView *gl_view)
+{
+    eMissileTexture texture_to_use      = eMISSILE_TEXTURE_NO_FLAME;
+    float           missile_half_width  = GetWidth() / 2.0f;
+    float           missile_half_height = GetHeight() / 2.0f;
+    float           texture_alpha       = 1.0f;
+
+    switch (m_CurrentState)
+    {
+        case eMISSILE_STATE_FLYING:
+        {
+            if (m_Acceleration > 0.1f)
+            {
+                texture_to_use = (eMissileTexture)((rand() % (eMISSILE_TEXTURE_FLAME_3 - eMISSILE_TEXTURE_FLAME_1 + 1)) + eMISSILE_TEXTURE_FLAME_1);
+            }
+
+            break;
+        }
+
+        case eMISSILE_STATE_EXPLODING:
+        {
+            texture_to_use = eMISSILE_TEXTURE_EXPLOSION;
+
+            // Make the explosion scale and fade over time
+            float explosion_fraction_complete           = (GetNumSecondsToExplode() - m_ExplosionTimeLeft) / GetNumSecondsToExplode();
+
+            float min_explosion_size                    = max(missile_half_width, missile_half_height);
+            float max_explosion_size                    = min_explosion_size * m_pConfig->Get(eCONFIG_MISSILE_EXPLOSION_SIZE_FACTOR);
+            missile_half_width = missile_half_height    = ((max_explosion_size - min_explosion_size) * explosion_fraction_complete) + min_explosion_size;
+
+            texture_alpha                               = 1.0f - explosion_fraction_complete;
+
+            break;
+        }
+
+        case eMISSILE_STATE_FINISHED_EXPLODING:
+        {
+            return TRUE; // Nothing to draw if we're done exploding
+
+            break;
+        }
+
+        default:
+        {
+            TRACE("Unknown missile state: %d\n", m_CurrentState);
+
+            break;
+        }
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_TEXTURE_2D);
+
+    CTexture *texture = m_pCurrentWorld->GetMissileTexture(texture_to_use);
+
+    if (texture->GetData() != NULL)
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, 4, texture->GetWidth(),
+            texture->GetHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE,
+            texture->GetData());
+    }
+
+    glLoadIdentity();
+    glTranslatef(m_Position.x, m_Position.y, 0.0f);
+    glRotatef(GetAngle(), 0.0f, 0.0f, -1.0f);
+
+    glColor4f(1.0f, 1.0f, 1.0f, texture_alpha);
+
+    glBegin(GL_QUADS);
+        glTexCoord2f(1.0f, 0.0f); glVertex2f(-missile_half_width,  missile_half_height);
+        glTexCoord2f(0.0f, 0.0f); glVertex2f( missile_half_width,  missile_half_height);
+        glTexCoord2f(0.0f, 1.0f); glVertex2f( missile_half_width, -missile_half_height);
+        glTexCoord2f(1.0f, 1.0f); glVertex2f(-missile_half_width, -missile_half_height);
+    glEnd();
+
+    glDisable(GL_TEXTURE_2D);
+    glDisable(GL_BLEND);
+
+    return TRUE;
+}
+
+//
+// Debug printing of our current state
+//
+
+void CMissile::DumpState()
+{
+    TRACE(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>\n");
+    TRACE(">>> Position:             [%f, %f]\n",           m_Position.x,   m_Position.y);
+    TRACE(">>> Direction:            [%f, %f]\n",           m_Direction.x,  m_Direction.y);
+    TRACE(">>> Speed:                %f units/s\n",         m_Speed);
+    TRACE(">>> Angular velocity:     %f degrees/s\n",       m_AngularVelocity);
+    TRACE(">>> Acceleration:         %f units/s^2\n",       m_Acceleration);
+    TRACE(">>> Angular acceleration: %f degrees/s^2\n\n",   m_AngularAcceleration);
+    TRACE(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>\n");
+}
+
+//
+// Save or load everything that changes as we fly. Our textures, config,
+// telemetry recorder, world and target aren't included, since they're
+// set up by our world.
+//
+
+void CMissile::Serialize(CArchive &archive)
+{
+    if (archive.IsStoring())
+    {
+        archive << (int)m_ControlMode << (int)m_CurrentState;
+        archive << m_UserDesiredAcceleration << m_UserDesiredAngularAcceleration;
+        archive << m_Acceleration << m_AngularAcceleration << m_MaxAcceleration;
+        archive << m_RotationalDragFactor << m_MaxAngularAcceleration;
+        archive << m_Speed << m_AngularVelocity << m_ExplosionTimeLeft << m_PidOutputScale;
+    }
+    else
+    {
+        int control_mode;
+        int current_state;
+
+        archive >> control_mode >> current_state;
+        archive >> m_UserDesiredAcceleration >> m_UserDesiredAngularAcceleration;
+        archive >> m_Acceleration >> m_AngularAcceleration >> m_MaxAcceleration;
+        archive >> m_RotationalDragFactor >> m_MaxAngularAcceleration;
+        archive >> m_Speed >> m_AngularVelocity >> m_ExplosionTimeLeft >> m_PidOutputScale;
+
+        m_ControlMode   = (eMissileControlMode)control_mode;
+        m_CurrentState  = (eMissileState)current_state;
+    }
+
+    m_Position.Serialize(archive);
+    m_Direction.Serialize(archive);
+
+    m_SteeringAdaptiveController.Serialize(archive);
+}
+
+//
+// Record the current state of our steering with our telemetry recorder
+//
+
+void CMissile::RecordTelemetry(float timestep, float heading_error, float model_behavior_value, float actual_behavior_value)
+{
+    STelemetryRecord record;
+
+    record.m_Time                   = m_pCurrentWorld->GetTimeElapsed();
+    record.m_Timestep               = timestep;
+    record.m_HeadingError           = heading_error;
+    record.m_ModelBehaviorValue     = model_behavior_value;
+    record.m_ActualBehaviorValue    = actual_behavior_value;
+
+    for (int i = 0; i < NUM_PID_COEFFICIENTS; i++)
+    {
+        record.m_Coefficient[i]     = m_SteeringAdaptiveController.GetCoefficient((ePIDCoefficient)i);
+        record.m_TermValue[i]       = m_SteeringAdaptiveController.GetTermValue((ePIDCoefficient)i);
+    }
+
+    record.m_Output                 = m_SteeringAdaptiveController.GetOutput();
+    record.m_PositionX              = m_Position.x;
+    record.m_PositionY              = m_Position.y;
+    record.m_Speed                  = m_Speed;
+    record.m_AngularVelocity        = m_AngularVelocity;
+
+    m_pTelemetryRecorder->Record(record);
+}
+
+//
+// Calculates our desired heading error derivative
+//
+
+float CMissile::GetModelBehaviorValue(float heading_error)
+{
+    // Interpolate our model behavior value from the graph that
+    // ApplySteeringConfig() set up
+
+    float model_behavior_value = m_SteeringModelGraph.GetValue(fabs(heading_error));
+
+    return model_behavior_value;
+}
+
+//
+// The direction our guidance mode wants us to head in, for our steering
+// to turn us towards. Only its direction matters, not its length. Every
+// mode pursues our target directly until we're moving fast enough to
+// lead it.
+//
+
+CVector2 CMissile::GetGuidanceDirection()
+{
+    CVector2 vector_to_target = *(m_pTarget->GetPosition()) - m_Position;
+
+    if (m_Speed < MissileMinGuidanceSpeed)
+    {
+        return vector_to_target;
+    }
+
+    switch (m_pConfig->GetInt(eCONFIG_MISSILE_GUIDANCE))
+    {
+        case eMISSILE_GUIDANCE_PURE_PURSUIT:
+        {
+            return vector_to_target;
+        }
+
+        case eMISSILE_GUIDANCE_PROPORTIONAL_NAVIGATION:
+        {
+            //
+            // The line of sight to our target stops turning when our
+            // velocity across it matches our target's, which is what
+            // proportional navigation drives us towards. Head off the line
+            // of sight by the angle that does that, so that our steering
+            // nulls the line of sight rate rather than chasing our
+            // target's tail.
+            //
+
+            float distance_to_target = vector_to_target.GetLength();
+
+            if (distance_to_target <= 0.0f)
+            {
+                return vector_to_target;
+            }
+
+            CVector2    line_of_sight   = vector_to_target * (1.0f / distance_to_target);
+            CVector2    target_velocity = m_pTarget->GetVelocity();
+            float       lead_sine       = GetCrossProduct(&line_of_sight, &target_velocity) / m_Speed;
+
+            lead_sine = max(-MissileMaxLeadSine, min(MissileMaxLeadSine, lead_sine));
+
+            line_of_sight.RotateBy(CVector2((float)sqrt(1.0f - (lead_sine * lead_sine)), lead_sine));
+
+            return line_of_sight;
+        }
+
+        case eMISSILE_GUIDANCE_PREDICTED_INTERCEPT:
+        {
+            //
+            // Find the soonest time t at which we could be where our target
+            // will be, if it keeps its velocity and we keep our speed:
+            // |vector_to_target + target_velocity * t| = m_Speed * t
+            //
+
+            CVector2    target_velocity = m_pTarget->GetVelocity();
+            float       a               = GetDotProduct(&target_velocity, &target_velocity) - (m_Speed * m_Speed);
+            float       b               = 2.0f * GetDotProduct(&vector_to_target, &target_velocity);
+            float       c               = GetDotProduct(&vector_to_target, &vector_to_target);
+            float       intercept_time  = -1.0f;
+
+            if (fabs(a) < 0.0001f)
+            {
+                // We're as fast as our target, so it's only linear
+
+                if (b < 0.0f)
+                {
+                    intercept_time = -c / b;
+                }
+            }
+            else
+            {
+                float discriminant = (b * b) - (4.0f * a * c);
+
+                if (discriminant >= 0.0f)
+                {
+                    float root          = (float)sqrt(discriminant);
+                    float early_time    = (-b - root) / (2.0f * a);
+                    float late_time     = (-b + root) / (2.0f * a);
+
+                    intercept_time = (min(early_time, late_time) > 0.0f) ? min(early_time, late_time) : max(early_time, late_time);
+                }
+            }
+
+            // If we can't catch it going the way it is, aim for where it'll
+            // be by the time we've covered the distance to it now, which
+            // at least cuts the corner
+
+            if (intercept_time <= 0.0f)
+            {
+                intercept_time = (float)sqrt(c) / m_Speed;
+            }
+
+            return vector_to_target + (target_velocity * min(intercept_time, MissileMaxInterceptTime));
+        }
+
+        default:
+        {
+            TRACE("Unknown missile guidance mode: %d\n", m_pConfig->GetInt(eCONFIG_MISSILE_GUIDANCE));
+
+            return vector_to_target;
+        }
+    }
+}
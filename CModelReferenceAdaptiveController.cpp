@@ -1,218 +1,531 @@
-//
-// Class to represent a Model Reference Adaptive Controller.
-//
-// To use, first set it up with SetAdaptationRule(), SetTimeslice(), SetClamp(), SetUpdateThreshold(),
-// SetAdaptationGain(), and SetAlpha() (used with the Normalized MIT Rule only), then
-// every frame call SetModelBehaviorValue() with whatever value your model outputs, then Update(). 
-// The result can be gotten with GetOutput()
-//
-
-#include "stdafx.h"
-#include "math.h"
-#include "CVector2.h"
-
-#include "CModelReferenceAdaptiveController.h"
-
-void CModelReferenceAdaptiveController::Reset()
-{
-    m_AdaptationRule                        = eADAPT_MIT_RULE;
-    m_Timeslice                             = 0.0f;
-    m_TotalTimeElapsed                      = 0.0f;
-    m_PreviousModelError                    = 0.0f;
-    m_AdaptationEnabled                     = true;
-
-    for (int i = 0; i < NUM_PID_COEFFICIENTS; i++)
-    {
-        m_Coefficient[i]                    = 0.0f;
-        m_AdaptationGain[i]                 = 0.0f;
-        m_UpdateThreshold[i]                = 0.0f;
-        m_Alpha[i]                          = 0.0f;
-        m_MinCoefficient[i]                 = 0.0f;
-        m_MaxCoefficient[i]                 = 0.0f;
-        m_PreviousCoefficientDerivative[i]  = 0.0f;
-    }
-
-    m_PidController.Clear();
-}
-
-void CModelReferenceAdaptiveController::Update(float timestep, float process_error, 
-                                               float model_behavior_value, float actual_behavior_value)
-{
-    m_PidController.Record(process_error, timestep);
-
-    m_TotalTimeElapsed += timestep;
-
-    // Update each coefficient using a round-robin system
-
-    ePIDCoefficient current_term            = (ePIDCoefficient)((int)(m_TotalTimeElapsed / m_Timeslice) % NUM_PID_COEFFICIENTS);
-    float           current_term_value      = GetTermValue(current_term);
-    float           model_error             = actual_behavior_value - model_behavior_value;
-    float           coefficient_derivative  = 0.0f;
-
-    //TRACE("Heading error: %f. Actual: %f. Model: %f Model error: %f\n", process_error, actual_behavior_value, model_behavior_value, model_error);
-
-    // Make sure that the term is big enough to tune (see the section
-    // Instability Resulting from Lack of Excitation)
-
-    if ((fabs(current_term_value) > m_UpdateThreshold[current_term]) && m_AdaptationEnabled)
-    {
-        coefficient_derivative = GetCoefficientDerivative(current_term, model_error, timestep);
-
-        //TRACE("\tUpdating coefficient %d. Prev. value: %f. Derivative: %f\n", current_term, m_Coefficient[current_term], coefficient_derivative);
-
-        m_Coefficient[current_term] += coefficient_derivative * timestep;
-
-        // Clamp each coefficient to prevent the arms race problem discussed in
-        // Calculating the Sensitivity Derviative
-
-        m_Coefficient[current_term] = Clamp(m_Coefficient[current_term], m_MinCoefficient[current_term], m_MaxCoefficient[current_term]);
-
-        //TRACE("\tNew value: %f\n", m_Coefficient[current_term]);
-    }
-
-    // Now we can update our coefficients
-
-    m_PidController.SetCoefficients(m_Coefficient[eP_COEFFICIENT], m_Coefficient[eI_COEFFICIENT], m_Coefficient[eD_COEFFICIENT]);
-
-    // And remember the previous values of our coefficient derivative and model error
-
-    for (int i = 0; i < NUM_PID_COEFFICIENTS; i++)
-    {
-        m_PreviousCoefficientDerivative[i] = 0.0f;
-    }
-
-    m_PreviousCoefficientDerivative[current_term] = coefficient_derivative;
-
-    m_PreviousModelError = model_error;
-}
-
-void CModelReferenceAdaptiveController::SetCoefficients(float p_coefficient, float i_coefficient, float d_coefficient)  
-{ 
-    m_Coefficient[eP_COEFFICIENT] = p_coefficient;
-    m_Coefficient[eI_COEFFICIENT] = i_coefficient;
-    m_Coefficient[eD_COEFFICIENT] = d_coefficient;
-
-    m_PidController.SetCoefficients(p_coefficient, i_coefficient, d_coefficient);
-}
-
-float CModelReferenceAdaptiveController::GetTermValue(ePIDCoefficient coefficient)
-{
-    switch (coefficient)
-    {
-        case eP_COEFFICIENT:
-        {
-            return m_PidController.GetError();
-
-            break;
-        }
-
-        case eI_COEFFICIENT:
-        {
-            return m_PidController.GetErrorIntegral();
-
-            break;
-        }
-
-        case eD_COEFFICIENT:
-        {
-            return m_PidController.GetErrorDerivative();
-
-            break;
-        }
-
-        default:
-        {
-            // Unknown term
-            ASSERT(0);
-
-            break;
-        }
-    };
-
-    return 0.0f;
-}
-
-float CModelReferenceAdaptiveController::GetCoefficientDerivative(ePIDCoefficient current_term, 
-                                                                  float model_error, float timestep)
-{
-    float adaptation_gain           = m_AdaptationGain[current_term];
-    float sensitivity_derivative    = GetSensitivityDerivative(current_term, model_error, timestep);
-
-    switch (m_AdaptationRule)
-    {
-        case eADAPT_MIT_RULE:
-        {
-            return -adaptation_gain * model_error * sensitivity_derivative;
-
-            break;
-        }
-
-        case eADAPT_SIGN_SIGN_RULE:
-        {
-            return -adaptation_gain * Sign(model_error) * Sign(sensitivity_derivative);
-
-            break;
-        }
-
-        case eADAPT_SIGN_DATA_RULE:
-        {
-            return -adaptation_gain * model_error * Sign(sensitivity_derivative);
-
-            break;
-        }
-
-        case eADAPT_SIGN_ERROR_RULE:
-        {
-            return -adaptation_gain * Sign(model_error) * sensitivity_derivative;
-
-            break;
-        }
-
-        case eADAPT_NORMALIZED_MIT_RULE:
-        {
-            return (-adaptation_gain * model_error * sensitivity_derivative) /
-                (m_Alpha[current_term] + sensitivity_derivative * sensitivity_derivative);
-
-            break;
-        }
-
-        default:
-        {
-            // Unknown adaptation rule
-            ASSERT(0);
-
-            break;
-        }
-    };
-
-    return 0.0f;
-}
-
-const float MaxSensitivityDerivative = 1000.0f;
-
-float CModelReferenceAdaptiveController::GetSensitivityDerivative(ePIDCoefficient current_term, 
-                                                                  float model_error, float timestep)
-{
-    float model_error_derivative = (model_error - m_PreviousModelError) / timestep;
-    float coefficient_derivative = m_PreviousCoefficientDerivative[current_term];
-
-    if (fabs(coefficient_derivative) > 0.0000001f)
-    {
-        return Clamp(model_error_derivative / coefficient_derivative, -MaxSensitivityDerivative, MaxSensitivityDerivative);
-    }
-    else if (fabs(model_error_derivative) < 0.0001f)
-    {
-        // This is the division of zero by zero case, as discussed in Calculating the Sensitivity Derivative
-        return 0.0f;
-    }
-    else if (model_error_derivative > 0.0f)
-    {
-        // This is one of the division by zero cases, as discussed in Calculating the Sensitivity Derivative
-        return 1.0f;
-    }
-    else
-    {
-        // This is the other division by zero case, as discussed in Calculating the Sensitivity Derivative
-        return -1.0f;
-    }
-}
+//
+// Class to represent a Model Reference Adaptive Controller.
+//
+// To use, first set it up with SetAdaptationRule(), SetTimeslice(), SetClamp(), SetUpdateThreshold(),
+// SetAdaptationGain(), and SetAlpha() (used with the Normalized MIT Rule only), then
+// every frame call SetModelBehaviorValue() with whatever value your model outputs, then Update(). 
+// The result can be gotten with GetOutput()
+//
+
+#include "stdafx.h"
+#include "math.h"
+#include "CVector2.h"
+#include "CMetrics.h"
+
+#include "CModelReferenceAdaptiveController.h"
+
+//
+// Tuning constants
+//
+
+const float MaxSensitivityDerivative = 1000.0f;
+
+void CModelReferenceAdaptiveController::Reset()
+{
+    m_AdaptationRule                        = eADAPT_MIT_RULE;
+    m_Timeslice                             = 0.0f;
+    m_AdaptationSchedule                    = eADAPT_ROUND_ROBIN;
+    m_SensitivityTimeConstant               = 0.0f;
+    m_ForgettingFactor                      = 1.0f;
+    m_StepForgettingFactor                  = 1.0f;
+    m_ForgettingTimestep                    = 0.0f;
+    m_TotalTimeElapsed                      = 0.0f;
+    m_PreviousModelError                    = 0.0f;
+    m_AdaptationEnabled                     = true;
+
+    for (int i = 0; i < NUM_PID_COEFFICIENTS; i++)
+    {
+        m_Coefficient[i]                    = 0.0f;
+        m_AdaptationGain[i]                 = 0.0f;
+        m_UpdateThreshold[i]                = 0.0f;
+        m_Alpha[i]                          = 0.0f;
+        m_MinCoefficient[i]                 = 0.0f;
+        m_MaxCoefficient[i]                 = 0.0f;
+        m_PreviousCoefficientDerivative[i]  = 0.0f;
+        m_FilteredRegressor[i]              = 0.0f;
+    }
+
+    m_PidController.SetCoefficients(0.0f, 0.0f, 0.0f);
+    m_PidController.Clear();
+
+    m_Estimator = CRecursiveLeastSquares();
+}
+
+//
+// Choose whether to adapt our coefficients one at a time or all together.
+// With eADAPT_SIMULTANEOUS, sensitivity_time_constant is how long, in
+// seconds, each term takes to show up in the behavior value, which sets
+// both how heavily its filtered regressor is smoothed and how big it is.
+//
+
+void CModelReferenceAdaptiveController::SetAdaptationSchedule(eAdaptationSchedule schedule, float sensitivity_time_constant)
+{
+    ASSERT((schedule >= 0) && (schedule < NUM_ADAPTATION_SCHEDULES));
+
+    if (schedule != m_AdaptationSchedule)
+    {
+        // Neither schedule's history means anything to the other
+
+        for (int i = 0; i < NUM_PID_COEFFICIENTS; i++)
+        {
+            m_PreviousCoefficientDerivative[i]  = 0.0f;
+            m_FilteredRegressor[i]              = 0.0f;
+        }
+    }
+
+    m_AdaptationSchedule        = schedule;
+    m_SensitivityTimeConstant   = sensitivity_time_constant;
+}
+
+//
+// Set up the Recursive Least Squares rule. forgetting_factor is how much
+// of its weight each observation keeps after a second, initial_covariance
+// how far the first observations can move each coefficient. The
+// covariance is reset to that whenever any coefficient's falls below
+// reset_fraction of it, and its trace is never let grow past where it
+// started.
+//
+
+void CModelReferenceAdaptiveController::SetRecursiveLeastSquares(float forgetting_factor, float initial_covariance, float reset_fraction)
+{
+    ASSERT((forgetting_factor > 0.0f) && (forgetting_factor <= 1.0f));
+
+    m_ForgettingFactor      = forgetting_factor;
+    m_ForgettingTimestep    = 0.0f;
+
+    m_Estimator.SetInitialCovariance(initial_covariance, reset_fraction);
+    m_Estimator.ResetCovariance();
+}
+
+void CModelReferenceAdaptiveController::Update(float timestep, float process_error, 
+                                               float model_behavior_value, float actual_behavior_value)
+{
+    m_PidController.Record(process_error, timestep);
+
+    m_TotalTimeElapsed += timestep;
+
+    float model_error = actual_behavior_value - model_behavior_value;
+
+    //TRACE("Heading error: %f. Actual: %f. Model: %f Model error: %f\n", process_error, actual_behavior_value, model_behavior_value, model_error);
+
+    CMetrics::AddSample(eMETRIC_HISTOGRAM_MODEL_ERROR, model_error);
+
+    // The Recursive Least Squares rule always adapts every coefficient at
+    // once, so it has no schedule to follow
+
+    if (m_AdaptationRule == eADAPT_RECURSIVE_LEAST_SQUARES_RULE)
+    {
+        AdaptRecursiveLeastSquares(timestep, process_error, model_error);
+    }
+    else if (m_AdaptationSchedule == eADAPT_SIMULTANEOUS)
+    {
+        AdaptSimultaneously(timestep, process_error, model_error);
+    }
+    else
+    {
+        AdaptRoundRobin(timestep, model_error);
+    }
+
+    // Now we can update our coefficients
+
+    m_PidController.SetCoefficients(m_Coefficient[eP_COEFFICIENT], m_Coefficient[eI_COEFFICIENT], m_Coefficient[eD_COEFFICIENT]);
+
+    m_PreviousModelError = model_error;
+}
+
+//
+// Adapt one coefficient, taking turns a timeslice at a time. The
+// sensitivity derivative comes from how much the model error changed
+// after the last adjustment to the coefficient.
+//
+
+void CModelReferenceAdaptiveController::AdaptRoundRobin(float timestep, float model_error)
+{
+    // Update each coefficient using a round-robin system
+
+    ePIDCoefficient current_term            = (ePIDCoefficient)((int)(m_TotalTimeElapsed / m_Timeslice) % NUM_PID_COEFFICIENTS);
+    float           current_term_value      = GetTermValue(current_term);
+    float           coefficient_derivative  = 0.0f;
+
+    // Make sure that the term is big enough to tune (see the section
+    // Instability Resulting from Lack of Excitation)
+
+    if ((fabs(current_term_value) > m_UpdateThreshold[current_term]) && m_AdaptationEnabled)
+    {
+        float sensitivity_derivative = GetSensitivityDerivative(current_term, model_error, timestep);
+
+        coefficient_derivative = GetCoefficientDerivative(current_term, model_error, sensitivity_derivative);
+
+        //TRACE("\tUpdating coefficient %d. Prev. value: %f. Derivative: %f\n", current_term, m_Coefficient[current_term], coefficient_derivative);
+
+        AdaptCoefficient(current_term, m_Coefficient[current_term] + (coefficient_derivative * timestep));
+
+        CMetrics::Increment(eMETRIC_ADAPTATION_STEPS_TAKEN);
+
+        //TRACE("\tNew value: %f\n", m_Coefficient[current_term]);
+    }
+    else if (m_AdaptationEnabled)
+    {
+        CMetrics::Increment(eMETRIC_ADAPTATION_STEPS_SKIPPED);
+    }
+
+    // And remember the previous values of our coefficient derivative
+
+    for (int i = 0; i < NUM_PID_COEFFICIENTS; i++)
+    {
+        m_PreviousCoefficientDerivative[i] = 0.0f;
+    }
+
+    m_PreviousCoefficientDerivative[current_term] = coefficient_derivative;
+}
+
+//
+// Adapt all three coefficients at once. Raising a coefficient adds its
+// term to our output, which turns the process error towards zero, so it
+// makes the behavior value (how fast the error is growing) smaller by
+// roughly its term, pointed along the error, as it's been over the last
+// m_SensitivityTimeConstant seconds. That low-pass filtered term, with
+// its sign flipped, is each coefficient's sensitivity derivative.
+//
+
+void CModelReferenceAdaptiveController::AdaptSimultaneously(float timestep, float process_error, float model_error)
+{
+    bool adapted = false;
+
+    UpdateFilteredRegressors(timestep, process_error);
+
+    for (int i = 0; i < NUM_PID_COEFFICIENTS; i++)
+    {
+        ePIDCoefficient coefficient = (ePIDCoefficient)i;
+
+        // Leave alone any coefficient whose term is too small to tune,
+        // just as the round robin does
+
+        if (!IsAboveUpdateThreshold(coefficient) || !m_AdaptationEnabled)
+        {
+            continue;
+        }
+
+        float sensitivity_derivative = -m_SensitivityTimeConstant * m_FilteredRegressor[i];
+
+        if (fabs(sensitivity_derivative) > MaxSensitivityDerivative)
+        {
+            CMetrics::Increment(eMETRIC_SENSITIVITY_DERIVATIVE_CLAMPS);
+
+            sensitivity_derivative = Clamp(sensitivity_derivative, -MaxSensitivityDerivative, MaxSensitivityDerivative);
+        }
+
+        float coefficient_derivative = GetCoefficientDerivative(coefficient, model_error, sensitivity_derivative);
+
+        AdaptCoefficient(coefficient, m_Coefficient[i] + (coefficient_derivative * timestep));
+
+        adapted = true;
+    }
+
+    // Count the step once however many coefficients it moved, so that
+    // every schedule and rule is counted alike
+
+    if (adapted)
+    {
+        CMetrics::Increment(eMETRIC_ADAPTATION_STEPS_TAKEN);
+    }
+    else if (m_AdaptationEnabled)
+    {
+        CMetrics::Increment(eMETRIC_ADAPTATION_STEPS_SKIPPED);
+    }
+}
+
+//
+// Adapt all three coefficients at once with our recursive least-squares
+// estimator. Near where we are, the model error moves by each
+// coefficient's sensitivity derivative (as in AdaptSimultaneously()) for
+// each unit that coefficient moves, so the coefficients that would bring
+// it to zero satisfy
+//
+//      sensitivity . coefficients = sensitivity . current coefficients - model error
+//
+// which is one observation of a linear model for the estimator to fit.
+// The estimator starts from our current coefficients every time, so that
+// it keeps up with clamping and with coefficients set from outside.
+//
+
+void CModelReferenceAdaptiveController::AdaptRecursiveLeastSquares(float timestep, float process_error, float model_error)
+{
+    int     i           = 0;
+    bool    excited     = false;
+    float   regressor[NUM_PID_COEFFICIENTS];
+    float   observation = -model_error;
+
+    UpdateFilteredRegressors(timestep, process_error);
+
+    if (!m_AdaptationEnabled)
+    {
+        return;
+    }
+
+    for (i = 0; i < NUM_PID_COEFFICIENTS; i++)
+    {
+        excited         = excited || IsAboveUpdateThreshold((ePIDCoefficient)i);
+        regressor[i]    = -m_SensitivityTimeConstant * m_FilteredRegressor[i];
+        observation     += regressor[i] * m_Coefficient[i];
+    }
+
+    // With every term too small, the observation can't tell us anything
+
+    if (!excited)
+    {
+        CMetrics::Increment(eMETRIC_ADAPTATION_STEPS_SKIPPED);
+
+        return;
+    }
+
+    if (timestep != m_ForgettingTimestep)
+    {
+        m_StepForgettingFactor  = CRecursiveLeastSquares::GetStepForgettingFactor(m_ForgettingFactor, timestep);
+        m_ForgettingTimestep    = timestep;
+    }
+
+    m_Estimator.SetEstimate(m_Coefficient);
+    m_Estimator.Update(regressor, observation, m_StepForgettingFactor);
+
+    for (i = 0; i < NUM_PID_COEFFICIENTS; i++)
+    {
+        AdaptCoefficient((ePIDCoefficient)i, m_Estimator.GetEstimate(i));
+    }
+
+    CMetrics::Increment(eMETRIC_ADAPTATION_STEPS_TAKEN);
+}
+
+//
+// Low-pass filter each term, pointed along the process error, with a time
+// constant of m_SensitivityTimeConstant, for AdaptSimultaneously() and
+// AdaptRecursiveLeastSquares() to take their sensitivity derivatives from
+//
+
+void CModelReferenceAdaptiveController::UpdateFilteredRegressors(float timestep, float process_error)
+{
+    float filter_weight = timestep / (m_SensitivityTimeConstant + timestep);
+
+    for (int i = 0; i < NUM_PID_COEFFICIENTS; i++)
+    {
+        m_FilteredRegressor[i] += ((GetTermValue((ePIDCoefficient)i) * Sign(process_error)) - m_FilteredRegressor[i]) * filter_weight;
+    }
+}
+
+//
+// Whether coefficient's term is big enough to tune (see the section
+// Instability Resulting from Lack of Excitation)
+//
+
+bool CModelReferenceAdaptiveController::IsAboveUpdateThreshold(ePIDCoefficient coefficient)
+{
+    return (fabs(GetTermValue(coefficient)) > m_UpdateThreshold[coefficient]);
+}
+
+//
+// Move coefficient to new_value, or as close to it as its clamp allows
+//
+
+void CModelReferenceAdaptiveController::AdaptCoefficient(ePIDCoefficient coefficient, float new_value)
+{
+    // Clamp each coefficient to prevent the arms race problem discussed in
+    // Calculating the Sensitivity Derviative
+
+    m_Coefficient[coefficient] = Clamp(new_value, m_MinCoefficient[coefficient], m_MaxCoefficient[coefficient]);
+
+    if (m_Coefficient[coefficient] != new_value)
+    {
+        CMetrics::Increment((eMetric)(eMETRIC_P_COEFFICIENT_CLAMP_HITS + coefficient));
+    }
+}
+
+void CModelReferenceAdaptiveController::SetCoefficients(float p_coefficient, float i_coefficient, float d_coefficient)  
+{ 
+    m_Coefficient[eP_COEFFICIENT] = p_coefficient;
+    m_Coefficient[eI_COEFFICIENT] = i_coefficient;
+    m_Coefficient[eD_COEFFICIENT] = d_coefficient;
+
+    m_PidController.SetCoefficients(p_coefficient, i_coefficient, d_coefficient);
+}
+
+void CModelReferenceAdaptiveController::SetCoefficient(ePIDCoefficient coefficient, float new_value)
+{
+    m_Coefficient[coefficient] = new_value;
+
+    m_PidController.SetCoefficients(m_Coefficient[eP_COEFFICIENT], m_Coefficient[eI_COEFFICIENT], m_Coefficient[eD_COEFFICIENT]);
+}
+
+float CModelReferenceAdaptiveController::GetTermValue(ePIDCoefficient coefficient)
+{
+    switch (coefficient)
+    {
+        case eP_COEFFICIENT:
+        {
+            return m_PidController.GetError();
+
+            break;
+        }
+
+        case eI_COEFFICIENT:
+        {
+            return m_PidController.GetErrorIntegral();
+
+            break;
+        }
+
+        case eD_COEFFICIENT:
+        {
+            return m_PidController.GetErrorDerivative();
+
+            break;
+        }
+
+        default:
+        {
+            // Unknown term
+            ASSERT(0);
+
+            break;
+        }
+    };
+
+    return 0.0f;
+}
+
+float CModelReferenceAdaptiveController::GetCoefficientDerivative(ePIDCoefficient current_term, 
+                                                                  float model_error, float sensitivity_derivative)
+{
+    float adaptation_gain           = m_AdaptationGain[current_term];
+
+    switch (m_AdaptationRule)
+    {
+        case eADAPT_MIT_RULE:
+        {
+            return -adaptation_gain * model_error * sensitivity_derivative;
+
+            break;
+        }
+
+        case eADAPT_SIGN_SIGN_RULE:
+        {
+            return -adaptation_gain * Sign(model_error) * Sign(sensitivity_derivative);
+
+            break;
+        }
+
+        case eADAPT_SIGN_DATA_RULE:
+        {
+            return -adaptation_gain * model_error * Sign(sensitivity_derivative);
+
+            break;
+        }
+
+        case eADAPT_SIGN_ERROR_RULE:
+        {
+            return -adaptation_gain * Sign(model_error) * sensitivity_derivative;
+
+            break;
+        }
+
+        case eADAPT_NORMALIZED_MIT_RULE:
+        {
+            return (-adaptation_gain * model_error * sensitivity_derivative) /
+                (m_Alpha[current_term] + sensitivity_derivative * sensitivity_derivative);
+
+            break;
+        }
+
+        default:
+        {
+            // Unknown adaptation rule
+            ASSERT(0);
+
+            break;
+        }
+    };
+
+    return 0.0f;
+}
+
+float CModelReferenceAdaptiveController::GetSensitivityDerivative(ePIDCoefficient current_term, 
+                                                                  float model_error, float timestep)
+{
+    float model_error_derivative = (model_error - m_PreviousModelError) / timestep;
+    float coefficient_derivative = m_PreviousCoefficientDerivative[current_term];
+
+    if (fabs(coefficient_derivative) > 0.0000001f)
+    {
+        float sensitivity_derivative = model_error_derivative / coefficient_derivative;
+
+        if (fabs(sensitivity_derivative) > MaxSensitivityDerivative)
+        {
+            CMetrics::Increment(eMETRIC_SENSITIVITY_DERIVATIVE_CLAMPS);
+        }
+
+        return Clamp(sensitivity_derivative, -MaxSensitivityDerivative, MaxSensitivityDerivative);
+    }
+    else if (fabs(model_error_derivative) < 0.0001f)
+    {
+        // This is the division of zero by zero case, as discussed in Calculating the Sensitivity Derivative
+        return 0.0f;
+    }
+    else if (model_error_derivative > 0.0f)
+    {
+        // This is one of the division by zero cases, as discussed in Calculating the Sensitivity Derivative
+        return 1.0f;
+    }
+    else
+    {
+        // This is the other division by zero case, as discussed in Calculating the Sensitivity Derivative
+        return -1.0f;
+    }
+}
+
+//
+// Save or load our current state and tuning values, along with
+// our PID controller's and estimator's
+//
+
+void CModelReferenceAdaptiveController::Serialize(CArchive &archive)
+{
+    int i = 0;
+
+    if (archive.IsStoring())
+    {
+        archive << m_TotalTimeElapsed << m_PreviousModelError << (BYTE)m_AdaptationEnabled;
+        archive << (int)m_AdaptationRule << m_Timeslice;
+        archive << (int)m_AdaptationSchedule << m_SensitivityTimeConstant << m_ForgettingFactor;
+
+        for (i = 0; i < NUM_PID_COEFFICIENTS; i++)
+        {
+            archive << m_Coefficient[i] << m_PreviousCoefficientDerivative[i] << m_FilteredRegressor[i];
+            archive << m_AdaptationGain[i] << m_UpdateThreshold[i] << m_Alpha[i];
+            archive << m_MinCoefficient[i] << m_MaxCoefficient[i];
+        }
+    }
+    else
+    {
+        BYTE    adaptation_enabled;
+        int     adaptation_rule;
+        int     adaptation_schedule;
+
+        archive >> m_TotalTimeElapsed >> m_PreviousModelError >> adaptation_enabled;
+        archive >> adaptation_rule >> m_Timeslice;
+        archive >> adaptation_schedule >> m_SensitivityTimeConstant >> m_ForgettingFactor;
+
+        m_AdaptationEnabled     = (adaptation_enabled != 0);
+        m_AdaptationRule        = (eAdaptationRule)adaptation_rule;
+        m_AdaptationSchedule    = (eAdaptationSchedule)adaptation_schedule;
+        m_ForgettingTimestep    = 0.0f;                 // So that the next step works out its forgetting factor again
+
+        for (i = 0; i < NUM_PID_COEFFICIENTS; i++)
+        {
+            archive >> m_Coefficient[i] >> m_PreviousCoefficientDerivative[i] >> m_FilteredRegressor[i];
+            archive >> m_AdaptationGain[i] >> m_UpdateThreshold[i] >> m_Alpha[i];
+            archive >> m_MinCoefficient[i] >> m_MaxCoefficient[i];
+        }
+    }
+
+    m_PidController.Serialize(archive);
+    m_Estimator.Serialize(archive);
+}
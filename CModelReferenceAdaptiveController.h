@@ -1,77 +1,128 @@
-//
-// Class to represent a Model Reference Adaptive Controller.
-//
-// To use, first set it up with SetAdaptationRule(), SetTimeslice(), SetClamp(), SetUpdateThreshold(),
-// SetAdaptationGain(), and SetAlpha() (used with the Normalized MIT Rule only), then
-// every frame call SetModelBehaviorValue() with whatever value your model outputs, then Update(). 
-// The result can be gotten with GetOutput()
-//
-
-#include "CPidController.h"
-
-enum ePIDCoefficient
-{
-    eP_COEFFICIENT = 0,
-    eI_COEFFICIENT,
-    eD_COEFFICIENT,
-
-    NUM_PID_COEFFICIENTS,
-};
-
-enum eAdaptationRule
-{
-    eADAPT_MIT_RULE = 0,
-    eADAPT_SIGN_SIGN_RULE,
-    eADAPT_SIGN_DATA_RULE,
-    eADAPT_SIGN_ERROR_RULE,
-    eADAPT_NORMALIZED_MIT_RULE,
-
-    NUM_UPDATE_RULES,
-};
-
-class CModelReferenceAdaptiveController
-{
-public:
-    CModelReferenceAdaptiveController()                                                     { Reset(); }
-    ~CModelReferenceAdaptiveController()                                                    { }
-
-    void            Reset();
-    void            ResetErrorHistory()                                                     { m_PidController.Clear(); }
-
-    void            Update(float timestep, float process_error, float model_behavior_value, float actual_behavior_value);
-    float           GetOutput()                                                             { return m_PidController.GetOutput(); }
-    float           GetCoefficient(ePIDCoefficient coefficient)                             { return m_Coefficient[coefficient]; }
-    float           GetTermValue(ePIDCoefficient coefficient);
-
-    void            SetAdaptationEnabled(bool adaptation_enabled)                           { m_AdaptationEnabled = adaptation_enabled; }
-    void            SetAdaptationRule(eAdaptationRule adaptation_rule)                      { m_AdaptationRule = adaptation_rule; }
-    void            SetTimeslice(float timeslice)                                           { m_Timeslice = timeslice; }
-    void            SetCoefficientClamp(ePIDCoefficient coefficient, float min, float max)  { m_MinCoefficient[coefficient] = min; m_MaxCoefficient[coefficient] = max; }
-    void            SetUpdateThreshold(ePIDCoefficient coefficient, float threshold)        { m_UpdateThreshold[coefficient] = threshold; }
-    void            SetAdaptationGain(ePIDCoefficient coefficient, float adaptation_gain)   { m_AdaptationGain[coefficient] = adaptation_gain; }
-    void            SetAlpha(ePIDCoefficient coefficient, float alpha)                      { m_Alpha[coefficient] = alpha; }
-
-    void            SetCoefficients(float p_coefficient, float i_coefficient, float d_coefficient);
-
-private:
-    float           GetCoefficientDerivative(ePIDCoefficient current_term, float model_error, float timestep);
-    float           GetSensitivityDerivative(ePIDCoefficient current_term, float model_error, float timestep);
-
-    // Current state
-    float           m_TotalTimeElapsed;
-    float           m_Coefficient[NUM_PID_COEFFICIENTS];
-    float           m_PreviousModelError;
-    float           m_PreviousCoefficientDerivative[NUM_PID_COEFFICIENTS];
-    bool            m_AdaptationEnabled;
-    
-    // Tuning values
-    eAdaptationRule m_AdaptationRule;
-    float           m_Timeslice;
-    float           m_AdaptationGain[NUM_PID_COEFFICIENTS];
-    float           m_UpdateThreshold[NUM_PID_COEFFICIENTS];
-    float           m_Alpha[NUM_PID_COEFFICIENTS];
-    float           m_MinCoefficient[NUM_PID_COEFFICIENTS];
-    float           m_MaxCoefficient[NUM_PID_COEFFICIENTS];
-
-    CPidController  m_PidController;
-};
\ No newline at end of file
+//
+// Class to represent a Model Reference Adaptive Controller.
+//
+// To use, first set it up with SetAdaptationRule(), SetTimeslice(), SetClamp(), SetUpdateThreshold(),
+// SetAdaptationGain(), and SetAlpha() (used with the Normalized MIT Rule only), then
+// every frame call SetModelBehaviorValue() with whatever value your model outputs, then Update(). 
+// The result can be gotten with GetOutput()
+//
+// By default only one coefficient is adapted at a time, taking turns a timeslice each. With
+// SetAdaptationSchedule() all three can be adapted together every frame instead, each with
+// its own sensitivity derivative taken from a low-pass filtered copy of its term (its
+// "filtered regressor"), rather than from how the model error changed after the last
+// adjustment, which can't tell the three coefficients apart.
+//
+// The Recursive Least Squares rule adapts all three together whatever the schedule, from
+// the same filtered regressors. Rather than following the gradient with a gain per
+// coefficient, it estimates the coefficients that would zero the model error with a
+// CRecursiveLeastSquares, so it takes far fewer steps to settle after the missile's
+// handling changes. Set it up with SetRecursiveLeastSquares().
+//
+
+#ifndef CMODELREFERENCEADAPTIVECONTROLLER_H
+#define CMODELREFERENCEADAPTIVECONTROLLER_H
+
+#include "CPidController.h"
+#include "CRecursiveLeastSquares.h"
+
+enum ePIDCoefficient
+{
+    eP_COEFFICIENT = 0,
+    eI_COEFFICIENT,
+    eD_COEFFICIENT,
+
+    NUM_PID_COEFFICIENTS,
+};
+
+enum eAdaptationRule
+{
+    eADAPT_MIT_RULE = 0,
+    eADAPT_SIGN_SIGN_RULE,
+    eADAPT_SIGN_DATA_RULE,
+    eADAPT_SIGN_ERROR_RULE,
+    eADAPT_NORMALIZED_MIT_RULE,
+    eADAPT_RECURSIVE_LEAST_SQUARES_RULE,
+
+    NUM_UPDATE_RULES,
+};
+
+enum eAdaptationSchedule
+{
+    eADAPT_ROUND_ROBIN = 0,
+    eADAPT_SIMULTANEOUS,
+
+    NUM_ADAPTATION_SCHEDULES,
+};
+
+class CModelReferenceAdaptiveController
+{
+public:
+    CModelReferenceAdaptiveController()                                                     { Reset(); }
+    ~CModelReferenceAdaptiveController()                                                    { }
+
+    void            Reset();
+    void            ResetErrorHistory()                                                     { m_PidController.Clear(); }
+
+    void            Update(float timestep, float process_error, float model_behavior_value, float actual_behavior_value);
+    float           GetOutput()                                                             { return m_PidController.GetOutput(); }
+    float           GetCoefficient(ePIDCoefficient coefficient)                             { return m_Coefficient[coefficient]; }
+    float           GetTermValue(ePIDCoefficient coefficient);
+    float           GetModelError()                                                         { return m_PreviousModelError; }
+
+    void            SetAdaptationEnabled(bool adaptation_enabled)                           { m_AdaptationEnabled = adaptation_enabled; }
+    void            SetAdaptationRule(eAdaptationRule adaptation_rule)                      { m_AdaptationRule = adaptation_rule; }
+    void            SetTimeslice(float timeslice)                                           { m_Timeslice = timeslice; }
+    void            SetAdaptationSchedule(eAdaptationSchedule schedule, float sensitivity_time_constant);
+    void            SetRecursiveLeastSquares(float forgetting_factor, float initial_covariance, float reset_fraction);
+    void            ResetCovariance()                                                       { m_Estimator.ResetCovariance(); }
+    void            SetCoefficientClamp(ePIDCoefficient coefficient, float min, float max)  { m_MinCoefficient[coefficient] = min; m_MaxCoefficient[coefficient] = max; }
+    void            SetUpdateThreshold(ePIDCoefficient coefficient, float threshold)        { m_UpdateThreshold[coefficient] = threshold; }
+    void            SetAdaptationGain(ePIDCoefficient coefficient, float adaptation_gain)   { m_AdaptationGain[coefficient] = adaptation_gain; }
+    void            SetAlpha(ePIDCoefficient coefficient, float alpha)                      { m_Alpha[coefficient] = alpha; }
+    void            SetDerivativeEstimator(eDerivativeEstimator estimator, float time_constant) { m_PidController.SetDerivativeEstimator(estimator, time_constant); }
+    void            SetIntegralMode(eIntegralMode mode, float forgetting_time_constant, float tracking_time_constant) { m_PidController.SetIntegralMode(mode, forgetting_time_constant, tracking_time_constant); }
+    void            SetUnappliedOutput(float unapplied_output)                              { m_PidController.SetUnappliedOutput(unapplied_output); }
+
+    void            SetCoefficients(float p_coefficient, float i_coefficient, float d_coefficient);
+    void            SetCoefficient(ePIDCoefficient coefficient, float new_value);
+
+    void            Serialize(CArchive &archive);
+
+private:
+    void            AdaptRoundRobin(float timestep, float model_error);
+    void            AdaptSimultaneously(float timestep, float process_error, float model_error);
+    void            AdaptRecursiveLeastSquares(float timestep, float process_error, float model_error);
+    void            UpdateFilteredRegressors(float timestep, float process_error);
+    bool            IsAboveUpdateThreshold(ePIDCoefficient coefficient);
+    void            AdaptCoefficient(ePIDCoefficient coefficient, float new_value);
+
+    float           GetCoefficientDerivative(ePIDCoefficient current_term, float model_error, float sensitivity_derivative);
+    float           GetSensitivityDerivative(ePIDCoefficient current_term, float model_error, float timestep);
+
+    // Current state
+    float           m_TotalTimeElapsed;
+    float           m_Coefficient[NUM_PID_COEFFICIENTS];
+    float           m_PreviousModelError;
+    float           m_PreviousCoefficientDerivative[NUM_PID_COEFFICIENTS];
+    float           m_FilteredRegressor[NUM_PID_COEFFICIENTS];         // Used with eADAPT_SIMULTANEOUS and eADAPT_RECURSIVE_LEAST_SQUARES_RULE only
+    bool            m_AdaptationEnabled;
+    
+    // Tuning values
+    eAdaptationRule m_AdaptationRule;
+    float           m_Timeslice;
+    eAdaptationSchedule m_AdaptationSchedule;
+    float           m_SensitivityTimeConstant;                          // Seconds
+    float           m_ForgettingFactor;                                 // Of each observation's weight left after a second, with eADAPT_RECURSIVE_LEAST_SQUARES_RULE
+    float           m_StepForgettingFactor;                             // The same for one step of m_ForgettingTimestep seconds, kept so that we only work it out when the timestep changes
+    float           m_ForgettingTimestep;
+    float           m_AdaptationGain[NUM_PID_COEFFICIENTS];
+    float           m_UpdateThreshold[NUM_PID_COEFFICIENTS];
+    float           m_Alpha[NUM_PID_COEFFICIENTS];
+    float           m_MinCoefficient[NUM_PID_COEFFICIENTS];
+    float           m_MaxCoefficient[NUM_PID_COEFFICIENTS];
+
+    CPidController  m_PidController;
+    CRecursiveLeastSquares m_Estimator;                                 // Used with eADAPT_RECURSIVE_LEAST_SQUARES_RULE only
+};
+
+#endif
\ No newline at end of file
@@ -1,188 +1,749 @@
-//
-// Class to represent a PID Controller. 
-//
-// To use, first set the P, I, and D coefficients with SetCoefficients(), 
-// then begin recording error values with Record(). Use GetOutput()
-// to calculate the current output of the controller.
-//
-
-#include "stdafx.h"
-#include "CPidController.h"
-
-//
-// Reset our controller to contain no error terms
-//
-
-void CPidController::Clear()
-{
-    m_CurrentIndex      = -1;
-    m_PreviousIndex     = -1;
-    m_NumErrorsRecorded = 0;
-
-    m_CurrentIntegral   = 0.0f;
-
-    for (int i = 0; i < NUM_ERROR_SLOTS; i++)
-    {
-        m_Error[i]      = 0.0f;
-        m_Timestep[i]   = 0.0f;
-    }
-}
-
-//
-// Record an error term and its associated timestep.
-//
-// Update our current integral value as well. The integral of a
-// function is the area under its curve. In this case, we have NUM_ERROR_SLOTS
-// samples of values from our error function, and wish to approximate its 
-// integral. We see that we have a series of samples and their associated 
-// timesteps. Each sample/timestep pair can represent a rectangle of area
-// on our graph. By summing together these areas, we can approximate the integral
-// of our error function.
-//
-// The limit as the size of the timesteps approach zero is the actual integral
-// of the error function.
-//
-// For more information about numerical integration, please see chapter 4 of
-// the Numerical Recipes books, available online at http://www.nr.com/
-//
-
-void CPidController::Record(float error, float timestep)
-{
-    m_PreviousIndex             = m_CurrentIndex;
-    m_CurrentIndex              = (m_CurrentIndex + 1) % NUM_ERROR_SLOTS;
-
-    if (m_NumErrorsRecorded == NUM_ERROR_SLOTS)
-    {
-        m_CurrentIntegral       -= m_Error[m_CurrentIndex] * m_Timestep[m_CurrentIndex];
-    }
-
-    m_Error[m_CurrentIndex]     = error;
-    m_Timestep[m_CurrentIndex]  = timestep;
-
-    m_CurrentIntegral           += error * timestep;
-
-    m_NumErrorsRecorded         = min(m_NumErrorsRecorded + 1, NUM_ERROR_SLOTS);
-}
-
-//
-// Returns the last error term recorded
-//
-
-float CPidController::GetError()
-{
-    if (m_NumErrorsRecorded >= 1)
-    {
-        ASSERT((m_CurrentIndex >= 0) && (m_CurrentIndex < NUM_ERROR_SLOTS));
-
-        return m_Error[m_CurrentIndex];
-    }
-    else
-    {
-        return 0.0f;
-    }
-}
-
-//
-// Returns the integral of the last NUM_ERROR_SLOTS error terms recorded.
-//
-// See CPidController::Record() for how m_CurrentIntegral is calculated.
-// Alternately, see CPidController::CalculateIntegralDirectly() for
-// how to calculate the integral from scratch.
-//
-
-float CPidController::GetErrorIntegral()
-{
-    return m_CurrentIntegral;
-}
-
-//
-// Returns the current instantaneous derivative the error.
-//
-// The derivative of a variable is its rate of change. We can estimate its
-// current rate of change by dividing the difference between two successive 
-// samples of the variable by the time elapsed between them.
-//
-// The limit as the size of the timesteps approaches zero is the actual derivative
-// of the error function.
-//
-
-float CPidController::GetErrorDerivative()
-{
-    if (m_NumErrorsRecorded >= 2)
-    {
-        ASSERT((m_CurrentIndex  >= 0)   && (m_CurrentIndex  < NUM_ERROR_SLOTS));
-        ASSERT((m_PreviousIndex >= 0)   && (m_PreviousIndex < NUM_ERROR_SLOTS));
-
-        float difference    = m_Error[m_CurrentIndex] - m_Error[m_PreviousIndex];
-        float time_interval = m_Timestep[m_CurrentIndex];
-
-        if (time_interval > 0.001f)
-        {
-            return (difference / time_interval);
-        }
-        else
-        {
-            return 999999.0f;
-        }
-    }
-    else
-    {
-        return 0.0f;
-    }
-}
-
-//
-// Calculates the current output of our controller
-//
-
-float CPidController::GetOutput()
-{
-    return  m_P_Coefficient * GetError()            +
-            m_I_Coefficient * GetErrorIntegral()    +
-            m_D_Coefficient * GetErrorDerivative();
-}
-
-//
-// Used for debugging to determine the amount of floating point
-// error that has accumulated in m_CurrentIntegral, by calculating
-// the current integral from scratch.
-//
-// See CPidController::Record() for an explanation of approximating
-// the integral of a variable.
-//
-
-float CPidController::CalculateIntegralDirectly()
-{
-    float integral = 0.0f;
-
-    for (int i = 0; i < m_NumErrorsRecorded; i++)
-    {
-        integral += (m_Error[i] * m_Timestep[i]);
-    }
-
-    return integral;
-}
-
-//
-// Debug printing of our current state
-//
-
-void CPidController::DumpState()
-{
-    TRACE(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>\n");
-    TRACE(">>> Num errors recorded: %d. Current index: %d. Previous index: %d.\n", m_NumErrorsRecorded, m_CurrentIndex, m_PreviousIndex);
-
-    for (int i = 0; i < NUM_ERROR_SLOTS; i++)
-    {
-        TRACE(">>> Slot %d: Error: %f Timestep: %f\n", i, m_Error[i], m_Timestep[i]);
-    }
-
-    TRACE(">>>\n");
-    TRACE(">>> Current P term: Coefficient %f * Error      %f = %f\n", m_P_Coefficient, GetError(),             m_P_Coefficient * GetError());
-    TRACE(">>> Current I term: Coefficient %f * Integral   %f = %f\n", m_I_Coefficient, GetErrorIntegral(),     m_I_Coefficient * GetErrorIntegral());
-    TRACE(">>> Current D term: Coefficient %f * Derivative %f = %f\n", m_D_Coefficient, GetErrorDerivative(),   m_D_Coefficient * GetErrorDerivative());
-    TRACE(">>>\n");
-    TRACE(">>> Final output: %f\n", GetOutput());
-    TRACE(">>> Integral: %f. Calculated directly: %f\n", GetErrorIntegral(), CalculateIntegralDirectly());
-    TRACE(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>\n");
-}
+//
+// Class to represent a PID Controller. 
+//
+// To use, first set the P, I, and D coefficients with SetCoefficients(), 
+// then begin recording error values with Record(). Use GetOutput()
+// to calculate the current output of the controller.
+//
+
+#include "stdafx.h"
+#include "math.h"
+#include "CPidController.h"
+#include "CMetrics.h"
+
+//
+// Tuning constants
+//
+
+const float     PidMinDerivativeTimestep    = 0.001f;       // Shortest timestep we'll take the derivative of the error over
+const float     PidDerivativeSentinel       = 999999.0f;    // What GetErrorDerivative() returns when the timestep is shorter than that
+const double    PidMinFitDeterminant        = 1.0e-9;       // Smallest determinant of a quadratic fit we'll solve, with time scaled to the length of the window
+const int       PidIntegralDriftInterval    = 1024;         // Errors recorded between each measurement of how far our integral has drifted
+
+CPidController::CPidController()
+{
+    m_DerivativeEstimator       = eDERIVATIVE_DIFFERENCE;
+    m_DerivativeTimeConstant    = 0.0f;
+    m_IntegralMode              = eINTEGRAL_WINDOW;
+    m_ForgettingTimeConstant    = 0.0f;
+    m_TrackingTimeConstant      = 0.0f;
+
+    SetCoefficients(0.0f, 0.0f, 0.0f);
+    Clear();
+}
+
+//
+// Choose how GetErrorDerivative() estimates the derivative. time_constant
+// is in seconds, and is only used by eDERIVATIVE_LOW_PASS: the longer it
+// is, the more noise is filtered out, and the further behind the error
+// the derivative lags.
+//
+// This can be changed at any time. Only the estimator we're using is kept
+// up to date as errors are recorded, so a new one is caught up with the
+// errors we already have, and the low-pass filter starts from whatever
+// the old one's estimate was.
+//
+
+void CPidController::SetDerivativeEstimator(eDerivativeEstimator estimator, float time_constant)
+{
+    if (estimator != m_DerivativeEstimator)
+    {
+        float derivative = GetErrorDerivative();
+
+        m_FilteredDerivative = (derivative != PidDerivativeSentinel) ? derivative : 0.0f;
+
+        CalculateFitSumsDirectly();
+    }
+
+    m_DerivativeEstimator       = estimator;
+    m_DerivativeTimeConstant    = max(time_constant, 0.0f);
+}
+
+//
+// Choose how the error is integrated. Both time constants are in seconds.
+// forgetting_time_constant is how long eINTEGRAL_EXPONENTIAL takes to
+// forget an error down to 1/e of what it was. tracking_time_constant is
+// how quickly eINTEGRAL_BACK_CALCULATION pulls the integral back when some
+// of our output isn't used. Neither needs to be anything like the other,
+// so each mode has its own. The other modes use neither.
+//
+// The integral carries on from where it was when the mode is changed,
+// apart from when switching to eINTEGRAL_WINDOW, where it's added up again
+// from the errors in our window.
+//
+
+void CPidController::SetIntegralMode(eIntegralMode mode, float forgetting_time_constant, float tracking_time_constant)
+{
+    if ((mode == eINTEGRAL_WINDOW) && (m_IntegralMode != eINTEGRAL_WINDOW))
+    {
+        m_CurrentIntegral       = CalculateIntegralDirectly();
+        m_IntegralCompensation  = 0.0f;
+    }
+
+    m_IntegralMode              = mode;
+    m_ForgettingTimeConstant    = max(forgetting_time_constant, 0.0f);
+    m_TrackingTimeConstant      = max(tracking_time_constant, 0.0f);
+}
+
+//
+// Reset our controller to contain no error terms
+//
+
+void CPidController::Clear()
+{
+    int i = 0;
+
+    m_CurrentIndex              = -1;
+    m_PreviousIndex             = -1;
+    m_NumErrorsRecorded         = 0;
+
+    m_CurrentIntegral           = 0.0f;
+    m_IntegralCompensation      = 0.0f;
+    m_NumRecordsSinceDrift      = 0;
+    m_UnappliedOutput           = 0.0f;
+
+    m_FilteredDerivative        = 0.0f;
+    m_WindowLength              = 0.0;
+    m_NumRecordsSinceFitSums    = 0;
+
+    for (i = 0; i < NUM_ERROR_SLOTS; i++)
+    {
+        m_Error[i]      = 0.0f;
+        m_Timestep[i]   = 0.0f;
+    }
+
+    for (i = 0; i < NUM_FIT_TIME_SUMS; i++)
+    {
+        m_TimeSum[i] = 0.0;
+    }
+
+    for (i = 0; i < NUM_FIT_ERROR_SUMS; i++)
+    {
+        m_ErrorSum[i] = 0.0;
+    }
+}
+
+//
+// Record an error term and its associated timestep.
+//
+// Update our current integral value as well. The integral of a
+// function is the area under its curve. In this case, we have NUM_ERROR_SLOTS
+// samples of values from our error function, and wish to approximate its 
+// integral. We see that we have a series of samples and their associated 
+// timesteps. Each sample/timestep pair can represent a rectangle of area
+// on our graph. By summing together these areas, we can approximate the integral
+// of our error function.
+//
+// The limit as the size of the timesteps approach zero is the actual integral
+// of the error function.
+//
+// For more information about numerical integration, please see chapter 4 of
+// the Numerical Recipes books, available online at http://www.nr.com/
+//
+// Rather than adding up all of the areas every time, we add each new one
+// and take away the one that's dropped out of our window. Each add or
+// subtract rounds a little, so we keep track of what's been lost to
+// rounding as well, with AddToIntegral(), to stop it from building up
+// over a long run.
+//
+// That's for eINTEGRAL_WINDOW. See Integrate() for the other modes.
+//
+
+void CPidController::Record(float error, float timestep)
+{
+    m_PreviousIndex             = m_CurrentIndex;
+    m_CurrentIndex              = (m_CurrentIndex + 1) % NUM_ERROR_SLOTS;
+
+    if ((m_NumErrorsRecorded == NUM_ERROR_SLOTS) && (m_IntegralMode == eINTEGRAL_WINDOW))
+    {
+        AddToIntegral(-(m_Error[m_CurrentIndex] * m_Timestep[m_CurrentIndex]));
+    }
+
+    if (m_DerivativeEstimator != eDERIVATIVE_DIFFERENCE)
+    {
+        UpdateDerivative(error, timestep);
+    }
+
+    m_Error[m_CurrentIndex]     = error;
+    m_Timestep[m_CurrentIndex]  = timestep;
+
+    Integrate(error, timestep);
+
+    m_NumErrorsRecorded         = min(m_NumErrorsRecorded + 1, NUM_ERROR_SLOTS);
+
+    // Rounding errors in the sums we shift along build up from one to the
+    // next, so they're added up again from scratch once every error in
+    // them has been replaced
+
+    if (((m_DerivativeEstimator == eDERIVATIVE_LEAST_SQUARES) || (m_DerivativeEstimator == eDERIVATIVE_SAVITZKY_GOLAY)) &&
+        (++m_NumRecordsSinceFitSums == NUM_ERROR_SLOTS))
+    {
+        CalculateFitSumsDirectly();
+    }
+
+    // Every so often, check how far our integral has drifted from what it
+    // should be
+
+    if ((m_IntegralMode == eINTEGRAL_WINDOW) && (++m_NumRecordsSinceDrift == PidIntegralDriftInterval))
+    {
+        CMetrics::AddSample(eMETRIC_HISTOGRAM_INTEGRAL_DRIFT, GetIntegralDrift());
+
+        m_NumRecordsSinceDrift = 0;
+    }
+
+    // Count errors that GetErrorDerivative() will return its sentinel for
+    // here, since that can be called any number of times per error
+
+    if ((m_DerivativeEstimator == eDERIVATIVE_DIFFERENCE) && (m_NumErrorsRecorded >= 2) && (timestep <= PidMinDerivativeTimestep))
+    {
+        CMetrics::Increment(eMETRIC_DERIVATIVE_SENTINELS);
+    }
+}
+
+//
+// Add value to our integral, using Neumaier's version of Kahan summation.
+//
+// When two floats are added, the low bits of the smaller one are rounded
+// away. We can work out exactly what they were from the sum, and we keep
+// them in m_IntegralCompensation, to be added back in when the integral
+// is read. That way the integral stays as accurate as if it were added up
+// from scratch, however many times we've added to it.
+//
+
+void CPidController::AddToIntegral(float value)
+{
+    float sum = m_CurrentIntegral + value;
+
+    if (fabs(m_CurrentIntegral) >= fabs(value))
+    {
+        m_IntegralCompensation += (m_CurrentIntegral - sum) + value;
+    }
+    else
+    {
+        m_IntegralCompensation += (value - sum) + m_CurrentIntegral;
+    }
+
+    m_CurrentIntegral = sum;
+}
+
+//
+// Add the area of error over timestep to our integral.
+//
+// An integral over every error keeps on growing for as long as the error
+// stays the same sign, which is fine so long as our output is doing
+// something about it. When it isn't, because it's been clamped or because
+// something else is steering, the integral winds up, and once our output
+// is used again it overshoots until the integral has unwound. So:
+//
+//  - eINTEGRAL_EXPONENTIAL forgets old errors, as if the area under the
+//    curve decayed with m_ForgettingTimeConstant. That's the backward Euler
+//    form of dI/dt = error - I/T.
+//
+//  - eINTEGRAL_CONDITIONAL leaves out errors that would push an output
+//    that isn't being used further in the same direction.
+//
+//  - eINTEGRAL_BACK_CALCULATION pulls the integral back by the output
+//    that wasn't used, so that our I term is within
+//    m_TrackingTimeConstant seconds of matching what was actually done.
+//
+
+void CPidController::Integrate(float error, float timestep)
+{
+    switch (m_IntegralMode)
+    {
+        case eINTEGRAL_WINDOW:
+        {
+            AddToIntegral(error * timestep);
+
+            break;
+        }
+
+        case eINTEGRAL_EXPONENTIAL:
+        {
+            float time_constant = m_ForgettingTimeConstant + timestep;
+
+            if (time_constant > 0.0f)
+            {
+                m_CurrentIntegral       = (GetErrorIntegral() + (error * timestep)) * (m_ForgettingTimeConstant / time_constant);
+                m_IntegralCompensation  = 0.0f;
+            }
+
+            break;
+        }
+
+        case eINTEGRAL_CONDITIONAL:
+        {
+            float i_term_change = m_I_Coefficient * error;
+
+            if (((m_UnappliedOutput > 0.0f) && (i_term_change > 0.0f)) || ((m_UnappliedOutput < 0.0f) && (i_term_change < 0.0f)))
+            {
+                CMetrics::Increment(eMETRIC_INTEGRAL_WINDUP_HOLDS);
+            }
+            else
+            {
+                AddToIntegral(error * timestep);
+            }
+
+            break;
+        }
+
+        case eINTEGRAL_BACK_CALCULATION:
+        {
+            float tracking_gain = m_I_Coefficient * m_TrackingTimeConstant;
+
+            if (tracking_gain > 0.0f)
+            {
+                AddToIntegral((error - (m_UnappliedOutput / tracking_gain)) * timestep);
+            }
+            else
+            {
+                AddToIntegral(error * timestep);
+            }
+
+            break;
+        }
+
+        default:
+        {
+            TRACE("Unknown integral mode: %d\n", m_IntegralMode);
+
+            break;
+        }
+    }
+}
+
+//
+// Bring our derivative estimator up to date with an error that's about to
+// be recorded in m_CurrentIndex, timestep seconds after the last one.
+//
+// The low-pass filter is the backward Euler form of s / (Ts + 1), where T
+// is m_DerivativeTimeConstant. When T is 0, it's the same as the plain
+// difference, except that it holds its last value rather than returning
+// PidDerivativeSentinel when the timestep is too short.
+//
+// The sums used to fit a line or quadratic to our errors are in terms of
+// time relative to the last error, so that they stay small however long
+// we run for. Moving them along to the new error means replacing each t
+// with t - timestep, and expanding the powers of that.
+//
+
+void CPidController::UpdateDerivative(float error, float timestep)
+{
+    int     i = 0;
+    double  t_k;
+
+    if (m_DerivativeEstimator == eDERIVATIVE_LOW_PASS)
+    {
+        float time_constant = m_DerivativeTimeConstant + timestep;
+
+        if ((m_NumErrorsRecorded >= 1) && (time_constant > PidMinDerivativeTimestep))
+        {
+            float difference        = error - m_Error[m_PreviousIndex];
+
+            m_FilteredDerivative    = ((m_DerivativeTimeConstant * m_FilteredDerivative) + difference) / time_constant;
+        }
+
+        return;
+    }
+
+    // Forget the error we're about to overwrite
+
+    if (m_NumErrorsRecorded == NUM_ERROR_SLOTS)
+    {
+        double oldest_time  = -m_WindowLength;
+        double oldest_error = m_Error[m_CurrentIndex];
+
+        t_k = 1.0;
+
+        for (i = 0; i < NUM_FIT_TIME_SUMS; i++)
+        {
+            m_TimeSum[i] -= t_k;
+
+            if (i < NUM_FIT_ERROR_SUMS)
+            {
+                m_ErrorSum[i] -= t_k * oldest_error;
+            }
+
+            t_k *= oldest_time;
+        }
+
+        m_WindowLength -= m_Timestep[(m_CurrentIndex + 1) % NUM_ERROR_SLOTS];
+    }
+
+    if (m_NumErrorsRecorded >= 1)
+    {
+        m_WindowLength += timestep;
+    }
+
+    // Move every error we have back by timestep
+
+    double h    = timestep;
+    double h2   = h * h;
+    double h3   = h2 * h;
+    double h4   = h3 * h;
+
+    m_TimeSum[4]    += (-4.0 * h * m_TimeSum[3]) + (6.0 * h2 * m_TimeSum[2]) - (4.0 * h3 * m_TimeSum[1]) + (h4 * m_TimeSum[0]);
+    m_TimeSum[3]    += (-3.0 * h * m_TimeSum[2]) + (3.0 * h2 * m_TimeSum[1]) - (h3 * m_TimeSum[0]);
+    m_TimeSum[2]    += (-2.0 * h * m_TimeSum[1]) + (h2 * m_TimeSum[0]);
+    m_TimeSum[1]    -= h * m_TimeSum[0];
+
+    m_ErrorSum[2]   += (-2.0 * h * m_ErrorSum[1]) + (h2 * m_ErrorSum[0]);
+    m_ErrorSum[1]   -= h * m_ErrorSum[0];
+
+    // And add the new one, at time 0
+
+    m_TimeSum[0]    += 1.0;
+    m_ErrorSum[0]   += error;
+}
+
+//
+// Add up the sums used to fit a line or quadratic to our errors from
+// scratch, rather than shifting them along. See UpdateDerivative().
+//
+
+void CPidController::CalculateFitSumsDirectly()
+{
+    int     i       = 0;
+    int     index   = m_CurrentIndex;
+    double  time    = 0.0;
+
+    for (i = 0; i < NUM_FIT_TIME_SUMS; i++)
+    {
+        m_TimeSum[i] = 0.0;
+    }
+
+    for (i = 0; i < NUM_FIT_ERROR_SUMS; i++)
+    {
+        m_ErrorSum[i] = 0.0;
+    }
+
+    // Go back from the last error to the first, to find the time of each
+    // relative to the last
+
+    for (int error = 0; error < m_NumErrorsRecorded; error++)
+    {
+        double t_k = 1.0;
+
+        for (i = 0; i < NUM_FIT_TIME_SUMS; i++)
+        {
+            m_TimeSum[i] += t_k;
+
+            if (i < NUM_FIT_ERROR_SUMS)
+            {
+                m_ErrorSum[i] += t_k * m_Error[index];
+            }
+
+            t_k *= time;
+        }
+
+        if (error < m_NumErrorsRecorded - 1)
+        {
+            time    -= m_Timestep[index];
+            index   = (index + NUM_ERROR_SLOTS - 1) % NUM_ERROR_SLOTS;
+        }
+    }
+
+    m_WindowLength              = -time;
+    m_NumRecordsSinceFitSums    = 0;
+}
+
+//
+// Returns the last error term recorded
+//
+
+float CPidController::GetError()
+{
+    if (m_NumErrorsRecorded >= 1)
+    {
+        ASSERT((m_CurrentIndex >= 0) && (m_CurrentIndex < NUM_ERROR_SLOTS));
+
+        return m_Error[m_CurrentIndex];
+    }
+    else
+    {
+        return 0.0f;
+    }
+}
+
+//
+// Returns the integral of the last NUM_ERROR_SLOTS error terms recorded,
+// or of every error term, depending on our integral mode.
+//
+// See CPidController::Record() for how m_CurrentIntegral is calculated.
+// Alternately, see CPidController::CalculateIntegralDirectly() for
+// how to calculate the integral from scratch.
+//
+
+float CPidController::GetErrorIntegral()
+{
+    return m_CurrentIntegral + m_IntegralCompensation;
+}
+
+//
+// Returns how far our integral has drifted from the sum of the areas
+// actually in our window, from rounding as it's been added to. This adds
+// up the window from scratch, so it's for checking up on us rather than
+// calling every timestep.
+//
+
+float CPidController::GetIntegralDrift()
+{
+    if (m_IntegralMode != eINTEGRAL_WINDOW)
+    {
+        return 0.0f;
+    }
+
+    return (float)fabs(GetErrorIntegral() - CalculateIntegralDirectly());
+}
+
+//
+// Returns the current instantaneous derivative the error.
+//
+// The derivative of a variable is its rate of change. We can estimate its
+// current rate of change by dividing the difference between two successive 
+// samples of the variable by the time elapsed between them.
+//
+// The limit as the size of the timesteps approaches zero is the actual derivative
+// of the error function.
+//
+// That's what eDERIVATIVE_DIFFERENCE does, but any noise in the error is
+// divided by the timestep too, so the other estimators smooth it out,
+// either by filtering the difference or by fitting a curve to every
+// error we have.
+//
+
+float CPidController::GetErrorDerivative()
+{
+    switch (m_DerivativeEstimator)
+    {
+        case eDERIVATIVE_DIFFERENCE:
+        {
+            break;
+        }
+
+        case eDERIVATIVE_LOW_PASS:
+        {
+            return m_FilteredDerivative;
+
+            break;
+        }
+
+        case eDERIVATIVE_LEAST_SQUARES:
+        {
+            return GetFittedSlope(1);
+
+            break;
+        }
+
+        case eDERIVATIVE_SAVITZKY_GOLAY:
+        {
+            return GetFittedSlope(2);
+
+            break;
+        }
+
+        default:
+        {
+            TRACE("Unknown derivative estimator: %d\n", m_DerivativeEstimator);
+
+            break;
+        }
+    }
+
+    if (m_NumErrorsRecorded >= 2)
+    {
+        ASSERT((m_CurrentIndex  >= 0)   && (m_CurrentIndex  < NUM_ERROR_SLOTS));
+        ASSERT((m_PreviousIndex >= 0)   && (m_PreviousIndex < NUM_ERROR_SLOTS));
+
+        float difference    = m_Error[m_CurrentIndex] - m_Error[m_PreviousIndex];
+        float time_interval = m_Timestep[m_CurrentIndex];
+
+        if (time_interval > PidMinDerivativeTimestep)
+        {
+            return (difference / time_interval);
+        }
+        else
+        {
+            return PidDerivativeSentinel;
+        }
+    }
+    else
+    {
+        return 0.0f;
+    }
+}
+
+//
+// Slope, at the last error, of the polynomial of degree 1 or 2 that best
+// fits every error we have, in the least squares sense.
+//
+// Fitting a quadratic over a fixed number of equally spaced errors is the
+// same as a Savitzky-Golay filter; fitting it to the times the errors
+// were actually recorded at keeps it right when the timestep varies.
+// Until there are enough errors, or if they're too close together in time
+// to fit a quadratic to, we fit a line instead.
+//
+// Time is scaled so that the window is 1 second long, to keep the sums
+// we're solving with close to 1.
+//
+
+float CPidController::GetFittedSlope(int degree)
+{
+    double n = m_TimeSum[0];
+
+    if ((n < 2.0) || (m_WindowLength <= PidMinDerivativeTimestep))
+    {
+        return 0.0f;
+    }
+
+    double scale    = 1.0 / m_WindowLength;
+    double s1       = m_TimeSum[1] * scale;
+    double s2       = m_TimeSum[2] * scale * scale;
+    double e0       = m_ErrorSum[0];
+    double e1       = m_ErrorSum[1] * scale;
+
+    if ((degree == 2) && (n >= 3.0))
+    {
+        double s3   = m_TimeSum[3] * scale * scale * scale;
+        double s4   = m_TimeSum[4] * scale * scale * scale * scale;
+        double e2   = m_ErrorSum[2] * scale * scale;
+
+        // Solve for the linear coefficient with Cramer's rule
+
+        double determinant  = (n * ((s2 * s4) - (s3 * s3))) - (s1 * ((s1 * s4) - (s2 * s3))) + (s2 * ((s1 * s3) - (s2 * s2)));
+
+        if (fabs(determinant) > PidMinFitDeterminant)
+        {
+            double numerator = (n * ((e1 * s4) - (s3 * e2))) - (e0 * ((s1 * s4) - (s3 * s2))) + (s2 * ((s1 * e2) - (e1 * s2)));
+
+            return (float)((numerator / determinant) * scale);
+        }
+    }
+
+    return (float)((((n * e1) - (s1 * e0)) / ((n * s2) - (s1 * s1))) * scale);
+}
+
+//
+// Calculates the current output of our controller
+//
+
+float CPidController::GetOutput()
+{
+    return  m_P_Coefficient * GetError()            +
+            m_I_Coefficient * GetErrorIntegral()    +
+            m_D_Coefficient * GetErrorDerivative();
+}
+
+//
+// Used for debugging to determine the amount of floating point
+// error that has accumulated in m_CurrentIntegral, by calculating
+// the current integral from scratch.
+//
+// See CPidController::Record() for an explanation of approximating
+// the integral of a variable.
+//
+
+float CPidController::CalculateIntegralDirectly()
+{
+    double integral = 0.0;
+
+    for (int i = 0; i < m_NumErrorsRecorded; i++)
+    {
+        integral += (m_Error[i] * m_Timestep[i]);
+    }
+
+    return (float)integral;
+}
+
+//
+// Save or load our coefficients and everything we've recorded
+//
+
+void CPidController::Serialize(CArchive &archive)
+{
+    int i = 0;
+
+    if (archive.IsStoring())
+    {
+        archive << m_P_Coefficient << m_I_Coefficient << m_D_Coefficient;
+
+        for (i = 0; i < NUM_ERROR_SLOTS; i++)
+        {
+            archive << m_Error[i] << m_Timestep[i];
+        }
+
+        archive << m_CurrentIndex << m_PreviousIndex << m_NumErrorsRecorded;
+        archive << m_CurrentIntegral << m_IntegralCompensation << m_NumRecordsSinceDrift;
+        archive << (int)m_IntegralMode << m_ForgettingTimeConstant << m_TrackingTimeConstant << m_UnappliedOutput;
+
+        archive << (int)m_DerivativeEstimator << m_DerivativeTimeConstant << m_FilteredDerivative;
+        archive << m_WindowLength << m_NumRecordsSinceFitSums;
+
+        for (i = 0; i < NUM_FIT_TIME_SUMS; i++)
+        {
+            archive << m_TimeSum[i];
+        }
+
+        for (i = 0; i < NUM_FIT_ERROR_SUMS; i++)
+        {
+            archive << m_ErrorSum[i];
+        }
+    }
+    else
+    {
+        int integral_mode;
+        int derivative_estimator;
+
+        archive >> m_P_Coefficient >> m_I_Coefficient >> m_D_Coefficient;
+
+        for (i = 0; i < NUM_ERROR_SLOTS; i++)
+        {
+            archive >> m_Error[i] >> m_Timestep[i];
+        }
+
+        archive >> m_CurrentIndex >> m_PreviousIndex >> m_NumErrorsRecorded;
+        archive >> m_CurrentIntegral >> m_IntegralCompensation >> m_NumRecordsSinceDrift;
+        archive >> integral_mode >> m_ForgettingTimeConstant >> m_TrackingTimeConstant >> m_UnappliedOutput;
+
+        m_IntegralMode = (eIntegralMode)integral_mode;
+
+        archive >> derivative_estimator >> m_DerivativeTimeConstant >> m_FilteredDerivative;
+        archive >> m_WindowLength >> m_NumRecordsSinceFitSums;
+
+        m_DerivativeEstimator = (eDerivativeEstimator)derivative_estimator;
+
+        for (i = 0; i < NUM_FIT_TIME_SUMS; i++)
+        {
+            archive >> m_TimeSum[i];
+        }
+
+        for (i = 0; i < NUM_FIT_ERROR_SUMS; i++)
+        {
+            archive >> m_ErrorSum[i];
+        }
+    }
+}
+
+//
+// Debug printing of our current state
+//
+
+void CPidController::DumpState()
+{
+    TRACE(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>\n");
+    TRACE(">>> Num errors recorded: %d. Current index: %d. Previous index: %d.\n", m_NumErrorsRecorded, m_CurrentIndex, m_PreviousIndex);
+
+    for (int i = 0; i < NUM_ERROR_SLOTS; i++)
+    {
+        TRACE(">>> Slot %d: Error: %f Timestep: %f\n", i, m_Error[i], m_Timestep[i]);
+    }
+
+    TRACE(">>>\n");
+    TRACE(">>> Current P term: Coefficient %f * Error      %f = %f\n", m_P_Coefficient, GetError(),             m_P_Coefficient * GetError());
+    TRACE(">>> Current I term: Coefficient %f * Integral   %f = %f\n", m_I_Coefficient, GetErrorIntegral(),     m_I_Coefficient * GetErrorIntegral());
+    TRACE(">>> Current D term: Coefficient %f * Derivative %f = %f\n", m_D_Coefficient, GetErrorDerivative(),   m_D_Coefficient * GetErrorDerivative());
+    TRACE(">>>\n");
+    TRACE(">>> Final output: %f\n", GetOutput());
+    TRACE(">>> Integral: %f. Calculated directly: %f\n", GetErrorIntegral(), CalculateIntegralDirectly());
+    TRACE(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>\n");
+}
@@ -1,52 +1,120 @@
-//
-// Class to represent a PID Controller. 
-//
-// To use, first set the P, I, and D coefficients with SetCoefficients(), 
-// then begin recording error values with Record(). Use GetOutput()
-// to calculate the current output of the controller.
-//
-
-#ifndef CPIDCONTOLLER_H
-#define CPIDCONTOLLER_H
-
-#define NUM_ERROR_SLOTS 10
-
-class CPidController
-{
-public:
-    CPidController()                        { SetCoefficients(0.0f, 0.0f, 0.0f); Clear(); }
-    ~CPidController()                       { }
-
-    void    SetCoefficients(float p_coefficient, float i_coefficient, float d_coefficient) { m_P_Coefficient = p_coefficient; m_I_Coefficient = i_coefficient; m_D_Coefficient = d_coefficient; }
-
-    void    Record(float error, float timestep);
-
-    void    Clear();
-    bool    IsFull()                        { return (m_NumErrorsRecorded == NUM_ERROR_SLOTS); }
-
-    float   GetError();
-    float   GetErrorIntegral();
-    float   GetErrorDerivative();
-
-    float   GetOutput();
-
-    void    DumpState();
-
-private:
-    float   CalculateIntegralDirectly();
-
-    float   m_P_Coefficient;                // Our current P coefficient
-    float   m_I_Coefficient;                // Our current I coefficient
-    float   m_D_Coefficient;                // Our current D coefficient
-
-    float   m_Error[NUM_ERROR_SLOTS];       // The last NUM_ERROR_SLOTS error terms that have been recorded
-    float   m_Timestep[NUM_ERROR_SLOTS];    // The last NUM_ERROR_SLOTS timesteps that have been recorded
-
-    int     m_CurrentIndex;                 // Index into m_Error[] anmd m_Timestep[] of the last recorded error
-    int     m_PreviousIndex;                // Index into m_Error[] anmd m_Timestep[] of the next-to-last recorded error
-    int     m_NumErrorsRecorded;            // Number of error values that have been recorded so far. Between 0 and NUM_ERROR_SLOTS.
-
-    float   m_CurrentIntegral;              // The current value of our integral term
-};
-
+//
+// Class to represent a PID Controller. 
+//
+// To use, first set the P, I, and D coefficients with SetCoefficients(), 
+// then begin recording error values with Record(). Use GetOutput()
+// to calculate the current output of the controller.
+//
+// The derivative of the error can be estimated in several ways, chosen with
+// SetDerivativeEstimator(). Each costs the same whatever the size of the
+// window of errors it looks at, and only the one chosen is kept up to date.
+//
+// Likewise, the integral can be over just the last NUM_ERROR_SLOTS errors,
+// or over every error with older ones gradually forgotten, or over every
+// error with something to stop it winding up while our output isn't being
+// used, chosen with SetIntegralMode(). For the latter, tell us how much of
+// each output wasn't used with SetUnappliedOutput().
+//
+
+#ifndef CPIDCONTOLLER_H
+#define CPIDCONTOLLER_H
+
+#define NUM_ERROR_SLOTS     10
+#define NUM_FIT_TIME_SUMS   5                       // Powers of time summed to fit a quadratic to our errors
+#define NUM_FIT_ERROR_SUMS  3
+
+// Possible ways of estimating the derivative of the error
+enum eDerivativeEstimator
+{
+    eDERIVATIVE_DIFFERENCE = 0,                     // Difference between the last two errors over the timestep between them
+    eDERIVATIVE_LOW_PASS,                           // That difference, passed through a first-order low-pass filter
+    eDERIVATIVE_LEAST_SQUARES,                      // Slope of the straight line that best fits every recorded error
+    eDERIVATIVE_SAVITZKY_GOLAY,                     // Slope, at the last error, of the quadratic that best fits every recorded error
+
+    NUM_DERIVATIVE_ESTIMATORS,
+};
+
+// Possible ways of integrating the error
+enum eIntegralMode
+{
+    eINTEGRAL_WINDOW = 0,                           // Over the last NUM_ERROR_SLOTS errors
+    eINTEGRAL_EXPONENTIAL,                          // Over every error, forgetting older ones with a time constant
+    eINTEGRAL_CONDITIONAL,                          // Over every error, except those that would push an output that isn't being used further the same way
+    eINTEGRAL_BACK_CALCULATION,                     // Over every error, pulled back towards what's used of our output with a time constant
+
+    NUM_INTEGRAL_MODES,
+};
+
+class CPidController
+{
+public:
+    CPidController();
+    ~CPidController()                       { }
+
+    void    SetCoefficients(float p_coefficient, float i_coefficient, float d_coefficient) { m_P_Coefficient = p_coefficient; m_I_Coefficient = i_coefficient; m_D_Coefficient = d_coefficient; }
+    void    SetDerivativeEstimator(eDerivativeEstimator estimator, float time_constant);
+    void    SetIntegralMode(eIntegralMode mode, float forgetting_time_constant, float tracking_time_constant);
+    void    SetUnappliedOutput(float unapplied_output)  { m_UnappliedOutput = unapplied_output; }
+
+    void    Record(float error, float timestep);
+
+    void    Clear();
+    bool    IsFull()                        { return (m_NumErrorsRecorded == NUM_ERROR_SLOTS); }
+
+    float   GetError();
+    float   GetErrorIntegral();
+    float   GetIntegralDrift();
+    float   GetErrorDerivative();
+
+    float   GetOutput();
+
+    void    DumpState();
+
+    void    Serialize(CArchive &archive);
+
+private:
+    float   CalculateIntegralDirectly();
+    void    AddToIntegral(float value);
+    void    Integrate(float error, float timestep);
+
+    void    UpdateDerivative(float error, float timestep);
+    void    CalculateFitSumsDirectly();
+    float   GetFittedSlope(int degree);
+
+    float   m_P_Coefficient;                // Our current P coefficient
+    float   m_I_Coefficient;                // Our current I coefficient
+    float   m_D_Coefficient;                // Our current D coefficient
+
+    float   m_Error[NUM_ERROR_SLOTS];       // The last NUM_ERROR_SLOTS error terms that have been recorded
+    float   m_Timestep[NUM_ERROR_SLOTS];    // The last NUM_ERROR_SLOTS timesteps that have been recorded
+
+    int     m_CurrentIndex;                 // Index into m_Error[] anmd m_Timestep[] of the last recorded error
+    int     m_PreviousIndex;                // Index into m_Error[] anmd m_Timestep[] of the next-to-last recorded error
+    int     m_NumErrorsRecorded;            // Number of error values that have been recorded so far. Between 0 and NUM_ERROR_SLOTS.
+
+    float   m_CurrentIntegral;              // The current value of our integral term, apart from...
+    float   m_IntegralCompensation;         // ...what's been lost to rounding while adding to it
+    int     m_NumRecordsSinceDrift;         // Errors recorded since we last measured how far the integral has drifted
+
+    eIntegralMode m_IntegralMode;
+    float   m_ForgettingTimeConstant;       // In seconds. How long eINTEGRAL_EXPONENTIAL takes to forget.
+    float   m_TrackingTimeConstant;         // In seconds. How long eINTEGRAL_BACK_CALCULATION takes to catch up.
+    float   m_UnappliedOutput;              // How much more of our last output was asked for than was used
+
+    eDerivativeEstimator m_DerivativeEstimator;
+    float   m_DerivativeTimeConstant;       // Time constant of the low-pass filter, in seconds
+    float   m_FilteredDerivative;           // Output of the low-pass filter
+
+    // Sums over the recorded errors of t^k and t^k * error, where t is the
+    // time each error was recorded, relative to the last one. Each is
+    // shifted along as errors are recorded, so the best fitting line or
+    // quadratic can be found without going through the errors, and added
+    // up again from scratch every NUM_ERROR_SLOTS errors.
+
+    double  m_TimeSum[NUM_FIT_TIME_SUMS];   // Sum of t^k, for k from 0 to 4
+    double  m_ErrorSum[NUM_FIT_ERROR_SUMS]; // Sum of t^k * error, for k from 0 to 2
+    double  m_WindowLength;                 // Seconds from the first recorded error to the last
+    int     m_NumRecordsSinceFitSums;       // Errors recorded since the sums were last added up from scratch
+};
+
 #endif
\ No newline at end of file
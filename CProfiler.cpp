@@ -0,0 +1,301 @@
+//
+// Scoped timing zones, for seeing where each frame's time goes.
+//
+// Every thread that records a zone gets its own ring buffer of events the
+// first time it does so, which only it writes to, so recording never has
+// to lock. MarkFrame() and ExportChromeTrace() read every thread's buffer,
+// so should be called when the other threads aren't recording, such as
+// between parallel steps.
+//
+
+#include "stdafx.h"
+#include "CStopwatch.h"
+#include "CProfiler.h"
+
+//
+// Tuning constants
+//
+
+const int   ProfileEventsPerThread      = 65536;    // Number of zones each thread remembers. Must be a power of 2.
+const int   ProfileMaxThreads           = 64;       // Zones recorded by any more threads than this are dropped
+const int   ProfileNumFrames            = 256;      // Number of frames whose totals we remember
+const int   ProfileMaxZonesPerFrame     = 32;       // Number of different zone names we total up per frame
+const int   ProfileMaxZoneDepth         = 32;       // Zones nested deeper than this are totalled as if they were this deep
+
+// The most recent events recorded by one thread
+class CProfileThreadBuffer
+{
+public:
+    DWORD                   m_ThreadId;
+    SProfileEvent           m_Event[ProfileEventsPerThread];
+    volatile LONG           m_NumEvents;                // Number of events ever recorded. Only changed by the owning thread.
+    LONG                    m_FrameStartEvent;          // Number of events that had been recorded when the current frame started
+    __int64                 m_ChildCounts[ProfileMaxZoneDepth + 1];     // Time in zones at each depth that have ended while the zone they're nested in hasn't yet
+};
+
+// Total time spent in one zone during one frame
+struct SProfileZoneTotal
+{
+    const char*             m_Name;
+    __int64                 m_Counts;                   // Performance counter ticks
+};
+
+// Totals of every zone recorded during one frame
+struct SProfileFrame
+{
+    __int64                 m_StartCounter;
+    __int64                 m_EndCounter;
+    int                     m_NumZones;
+    SProfileZoneTotal       m_Zone[ProfileMaxZonesPerFrame];
+};
+
+static CProfileThreadBuffer*            ProfileThreadBuffer[ProfileMaxThreads];
+static volatile LONG                    ProfileNumThreadBuffers     = 0;
+
+static __declspec(thread) CProfileThreadBuffer*     ProfileCurrentThreadBuffer  = NULL;
+static __declspec(thread) int                       ProfileCurrentDepth         = 0;
+
+static SProfileFrame                    ProfileFrame[ProfileNumFrames];
+static LONG                             ProfileNumFramesMarked      = 0;
+static __int64                          ProfileFrameStartCounter    = 0;
+
+//
+// Returns the calling thread's buffer, creating it if this is the first
+// zone the thread has recorded. Returns NULL if there are already too
+// many threads.
+//
+
+CProfileThreadBuffer *CProfiler::GetThreadBuffer()
+{
+    if (!ProfileCurrentThreadBuffer)
+    {
+        LONG index = InterlockedIncrement(&ProfileNumThreadBuffers) - 1;
+
+        if (index >= ProfileMaxThreads)
+        {
+            InterlockedDecrement(&ProfileNumThreadBuffers);
+
+            return NULL;
+        }
+
+        CProfileThreadBuffer *buffer = new CProfileThreadBuffer;
+
+        buffer->m_ThreadId          = GetCurrentThreadId();
+        buffer->m_NumEvents         = 0;
+        buffer->m_FrameStartEvent   = 0;
+
+        memset(buffer->m_ChildCounts, 0, sizeof(buffer->m_ChildCounts));
+
+        // Buffers are never freed, since other threads may still read them
+
+        ProfileThreadBuffer[index]  = buffer;
+        ProfileCurrentThreadBuffer  = buffer;
+    }
+
+    return ProfileCurrentThreadBuffer;
+}
+
+//
+// Start a zone on the calling thread. Returns the number of zones it's
+// nested inside.
+//
+
+int CProfiler::EnterZone()
+{
+    return ProfileCurrentDepth++;
+}
+
+//
+// Record one zone on the calling thread, overwriting its oldest zone if
+// its buffer is full
+//
+
+void CProfiler::RecordEvent(const char *name, int depth, __int64 start_counter, __int64 end_counter)
+{
+    ProfileCurrentDepth = depth;
+
+    CProfileThreadBuffer *buffer = GetThreadBuffer();
+
+    if (!buffer)
+    {
+        return;
+    }
+
+    LONG            num_events  = buffer->m_NumEvents;
+    SProfileEvent   *event      = &buffer->m_Event[num_events & (ProfileEventsPerThread - 1)];
+
+    event->m_Name           = name;
+    event->m_Depth          = depth;
+    event->m_StartCounter   = start_counter;
+    event->m_EndCounter     = end_counter;
+
+    buffer->m_NumEvents     = num_events + 1;
+}
+
+//
+// End the current frame, adding up the time spent in each zone during it
+// on every thread, and start the next one.
+//
+// Zones are recorded as they end, so every zone nested inside another is
+// recorded before it. As we go through them we keep a running total, for
+// each depth, of the time in zones that have ended at that depth since
+// the last zone one level up did, which is exactly the time the next
+// zone to end one level up spent in them, and take it off that zone's
+// time. Those totals carry over from frame to frame, for zones that
+// straddle the start of one.
+//
+
+void CProfiler::MarkFrame()
+{
+    __int64 current_counter = CStopwatch::GetCounter();
+
+    if (ProfileFrameStartCounter != 0)
+    {
+        SProfileFrame   *frame          = &ProfileFrame[ProfileNumFramesMarked % ProfileNumFrames];
+        LONG            num_buffers     = min(ProfileNumThreadBuffers, ProfileMaxThreads);
+
+        frame->m_StartCounter   = ProfileFrameStartCounter;
+        frame->m_EndCounter     = current_counter;
+        frame->m_NumZones       = 0;
+
+        for (int i = 0; i < num_buffers; i++)
+        {
+            CProfileThreadBuffer    *buffer     = ProfileThreadBuffer[i];
+            LONG                    end_event   = buffer->m_NumEvents;
+            LONG                    start_event = max(buffer->m_FrameStartEvent, end_event - ProfileEventsPerThread);
+
+            for (LONG event_index = start_event; event_index < end_event; event_index++)
+            {
+                const SProfileEvent *event      = &buffer->m_Event[event_index & (ProfileEventsPerThread - 1)];
+                int                 depth       = min(event->m_Depth, ProfileMaxZoneDepth - 1);
+                __int64             counts      = event->m_EndCounter - event->m_StartCounter;
+                __int64             self_counts = counts - buffer->m_ChildCounts[depth + 1];
+                int                 zone        = 0;
+
+                buffer->m_ChildCounts[depth + 1]    = 0;
+                buffer->m_ChildCounts[depth]        += counts;
+
+                while ((zone < frame->m_NumZones) && (frame->m_Zone[zone].m_Name != event->m_Name))
+                {
+                    zone++;
+                }
+
+                if (zone == frame->m_NumZones)
+                {
+                    if (zone == ProfileMaxZonesPerFrame)
+                    {
+                        continue;
+                    }
+
+                    frame->m_Zone[zone].m_Name      = event->m_Name;
+                    frame->m_Zone[zone].m_Counts    = 0;
+
+                    frame->m_NumZones++;
+                }
+
+                frame->m_Zone[zone].m_Counts    += self_counts;
+            }
+
+            buffer->m_FrameStartEvent = end_event;
+        }
+
+        ProfileNumFramesMarked++;
+    }
+
+    ProfileFrameStartCounter = current_counter;
+}
+
+//
+// Write every zone and frame total we still have to filename, in the
+// Chrome trace event format. Zones are complete ("X") events on the
+// thread that recorded them, and frame totals are counter ("C") events
+// in milliseconds, which show up as a stacked graph above the threads.
+// Returns false if the file couldn't be written.
+//
+
+bool CProfiler::ExportChromeTrace(const char *filename)
+{
+    int         i                       = 0;
+    LONG        num_buffers             = min(ProfileNumThreadBuffers, ProfileMaxThreads);
+    LONG        first_frame             = max(0, ProfileNumFramesMarked - ProfileNumFrames);
+    double      microseconds_per_count  = 1.0e6 / CStopwatch::GetCounterFrequency();
+    __int64     base_counter            = 0;
+    bool        first_event             = true;
+
+    FILE *file = fopen(filename, "w");
+
+    if (!file)
+    {
+        TRACE("Unable to open profile file %s\n", filename);
+
+        return false;
+    }
+
+    // Make all of our times relative to the earliest one we have
+
+    if (first_frame < ProfileNumFramesMarked)
+    {
+        base_counter = ProfileFrame[first_frame % ProfileNumFrames].m_StartCounter;
+    }
+
+    for (i = 0; i < num_buffers; i++)
+    {
+        CProfileThreadBuffer    *buffer             = ProfileThreadBuffer[i];
+        LONG                    first_event_index   = max(0, buffer->m_NumEvents - ProfileEventsPerThread);
+
+        if (buffer->m_NumEvents > 0)
+        {
+            __int64 start_counter = buffer->m_Event[first_event_index & (ProfileEventsPerThread - 1)].m_StartCounter;
+
+            if ((base_counter == 0) || (start_counter < base_counter))
+            {
+                base_counter = start_counter;
+            }
+        }
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (i = 0; i < num_buffers; i++)
+    {
+        CProfileThreadBuffer    *buffer     = ProfileThreadBuffer[i];
+        LONG                    end_event   = buffer->m_NumEvents;
+
+        for (LONG event_index = max(0, end_event - ProfileEventsPerThread); event_index < end_event; event_index++)
+        {
+            const SProfileEvent *event = &buffer->m_Event[event_index & (ProfileEventsPerThread - 1)];
+
+            fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}",
+                first_event ? "" : ",", event->m_Name, (unsigned long)buffer->m_ThreadId,
+                (event->m_StartCounter - base_counter) * microseconds_per_count,
+                (event->m_EndCounter - event->m_StartCounter) * microseconds_per_count);
+
+            first_event = false;
+        }
+    }
+
+    for (LONG frame_index = first_frame; frame_index < ProfileNumFramesMarked; frame_index++)
+    {
+        const SProfileFrame *frame      = &ProfileFrame[frame_index % ProfileNumFrames];
+        double              timestamp   = (frame->m_StartCounter - base_counter) * microseconds_per_count;
+
+        fprintf(file, "%s\n{\"name\":\"Frame time\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"ms\":%.4f}}",
+            first_event ? "" : ",", timestamp, (frame->m_EndCounter - frame->m_StartCounter) * microseconds_per_count / 1000.0);
+
+        fprintf(file, ",\n{\"name\":\"Frame zones\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{", timestamp);
+
+        for (i = 0; i < frame->m_NumZones; i++)
+        {
+            fprintf(file, "%s\"%s\":%.4f", (i == 0) ? "" : ",", frame->m_Zone[i].m_Name, frame->m_Zone[i].m_Counts * microseconds_per_count / 1000.0);
+        }
+
+        fprintf(file, "}}");
+
+        first_event = false;
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    return true;
+}
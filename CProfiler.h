@@ -0,0 +1,105 @@
+//
+// Scoped timing zones, for seeing where each frame's time goes.
+//
+// Put PROFILE_ZONE("name") at the top of a block to time from there to
+// the end of the block. Each zone costs two reads of the performance
+// counter and one write to a buffer belonging to the calling thread, so
+// zones can be used on any thread, including the workers stepping a world
+// in parallel. Zone names must be string literals, since only the pointer
+// is kept.
+//
+// Call PROFILE_FRAME() once at the start of every frame. It adds up how
+// long was spent in each zone, on every thread, since the previous call.
+// Those totals are self times: time spent in zones nested inside a zone
+// on the same thread counts towards the nested zones rather than it, so
+// no time is counted twice.
+//
+// Each thread keeps only its most recent ProfileEventsPerThread zones, and
+// we keep only the most recent ProfileNumFrames frame totals. Call
+// CProfiler::ExportChromeTrace() to write them out as JSON that can be
+// loaded into chrome://tracing (or any other viewer that reads the Chrome
+// trace event format) to see them as a flame chart.
+//
+// All of this is compiled out unless PROFILING_ENABLED is defined, which
+// it is in Debug builds. Add it to the preprocessor definitions of a
+// Release build to profile that.
+//
+
+#ifndef CPROFILER_H
+#define CPROFILER_H
+
+#ifdef PROFILING_ENABLED
+
+#define PROFILE_CONCATENATE_2(a, b)     a##b
+#define PROFILE_CONCATENATE(a, b)       PROFILE_CONCATENATE_2(a, b)
+
+#define PROFILE_ZONE(name)              CProfileZone PROFILE_CONCATENATE(profile_zone_, __LINE__)(name)
+#define PROFILE_FRAME()                 CProfiler::MarkFrame()
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_FRAME()
+
+#endif
+
+// One timed zone
+struct SProfileEvent
+{
+    const char*             m_Name;
+    int                     m_Depth;                    // Number of zones this one is nested inside, on its thread
+    __int64                 m_StartCounter;             // Performance counter values
+    __int64                 m_EndCounter;
+};
+
+class CProfileThreadBuffer;
+
+class CProfiler
+{
+public:
+    static int              EnterZone();
+    static void             RecordEvent(const char *name, int depth, __int64 start_counter, __int64 end_counter);
+
+    static void             MarkFrame();
+
+    static bool             ExportChromeTrace(const char *filename);
+
+private:
+    static CProfileThreadBuffer*    GetThreadBuffer();
+};
+
+//
+// Times the block it's declared in. Use PROFILE_ZONE() rather than
+// declaring one of these directly, so that it gets compiled out.
+//
+
+class CProfileZone
+{
+public:
+    CProfileZone(const char *name)
+    {
+        LARGE_INTEGER counter;
+
+        QueryPerformanceCounter(&counter);
+
+        m_Name          = name;
+        m_Depth         = CProfiler::EnterZone();
+        m_StartCounter  = counter.QuadPart;
+    }
+
+    ~CProfileZone()
+    {
+        LARGE_INTEGER counter;
+
+        QueryPerformanceCounter(&counter);
+
+        CProfiler::RecordEvent(m_Name, m_Depth, m_StartCounter, counter.QuadPart);
+    }
+
+private:
+    const char*             m_Name;
+    int                     m_Depth;
+    __int64                 m_StartCounter;
+};
+
+#endif
@@ -0,0 +1,79 @@
+//
+// Simple pseudo-random number generator.
+//
+// Unlike rand(), each CRandom has its own state, so a simulation that only
+// draws its random numbers from its own CRandom objects does exactly the
+// same thing every time it's run from the same seed, no matter what else
+// in the program is calling rand().
+//
+// We use Marsaglia's 32-bit xorshift generator, which has a period of
+// 2^32 - 1 and only needs a few shifts and XORs per number.
+//
+
+#include "stdafx.h"
+#include "CRandom.h"
+
+//
+// Start our sequence of numbers over from seed
+//
+
+void CRandom::SetSeed(unsigned long seed)
+{
+    m_Seed  = seed;
+
+    // Xorshift gets stuck at 0, so mix the seed up and make sure it's
+    // not 0. Mixing also means that nearby seeds give unrelated sequences.
+
+    m_State = (seed * 1664525UL + 1013904223UL) & 0xFFFFFFFFUL;
+
+    if (m_State == 0)
+    {
+        m_State = 0x12345678UL;
+    }
+}
+
+//
+// Returns the next number in our sequence, between 0 and 2^32 - 1
+//
+
+unsigned long CRandom::GetInt()
+{
+    m_State ^= (m_State << 13) & 0xFFFFFFFFUL;
+    m_State ^= (m_State >> 17);
+    m_State ^= (m_State << 5)  & 0xFFFFFFFFUL;
+
+    return m_State;
+}
+
+//
+// Returns the next number in our sequence, scaled to be between 0 and 1
+//
+
+float CRandom::GetFloat()
+{
+    // Only use the top 24 bits, which is all that fits exactly in a float
+
+    return (float)(GetInt() >> 8) / (float)0xFFFFFF;
+}
+
+//
+// Save or load where we are in our sequence
+//
+
+void CRandom::Serialize(CArchive &archive)
+{
+    if (archive.IsStoring())
+    {
+        archive << (DWORD)m_Seed << (DWORD)m_State;
+    }
+    else
+    {
+        DWORD seed;
+        DWORD state;
+
+        archive >> seed >> state;
+
+        m_Seed  = seed;
+        m_State = state;
+    }
+}
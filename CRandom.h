@@ -0,0 +1,33 @@
+//
+// Simple pseudo-random number generator.
+//
+// Unlike rand(), each CRandom has its own state, so a simulation that only
+// draws its random numbers from its own CRandom objects does exactly the
+// same thing every time it's run from the same seed, no matter what else
+// in the program is calling rand().
+//
+
+#ifndef CRANDOM_H
+#define CRANDOM_H
+
+class CRandom
+{
+public:
+    CRandom()                                   { SetSeed(1); }
+    CRandom(unsigned long seed)                 { SetSeed(seed); }
+    ~CRandom()                                  { }
+
+    void            SetSeed(unsigned long seed);
+    unsigned long   GetSeed()                   { return m_Seed; }
+
+    unsigned long   GetInt();                   // Returns a number between 0 and 2^32 - 1
+    float           GetFloat();                 // Returns a number between 0 and 1
+
+    void            Serialize(CArchive &archive);
+
+private:
+    unsigned long   m_Seed;                     // Seed we were last started from
+    unsigned long   m_State;                    // Current state of our generator. Never 0.
+};
+
+#endif
@@ -0,0 +1,224 @@
+//
+// Recursive least-squares estimator.
+//
+// With P the covariance, phi the regressor, y the observation and lambda
+// the forgetting factor for this step, each update is the usual
+//
+//      u       = P phi
+//      gain    = u / (lambda + phi . u)
+//      theta   = theta + gain (y - phi . theta)
+//      P       = (P - gain u') / lambda
+//
+// We only work out the upper triangle of the new P and mirror it, so it
+// stays exactly symmetric however much rounding builds up.
+//
+
+#include "stdafx.h"
+#include "math.h"
+#include "CMetrics.h"
+#include "CRecursiveLeastSquares.h"
+
+//
+// Tuning constants
+//
+
+const float RlsMinDenominator   = 1.0e-6f;      // Smallest lambda + phi . P phi we'll divide by
+
+CRecursiveLeastSquares::CRecursiveLeastSquares()
+{
+    for (int i = 0; i < RLS_NUM_PARAMETERS; i++)
+    {
+        m_Estimate[i] = 0.0f;
+    }
+
+    SetInitialCovariance(1.0f, 0.0f);
+    ResetCovariance();
+}
+
+//
+// Start the covariance of each parameter at initial_covariance from the
+// next reset on, and reset it whenever any parameter's falls below
+// reset_fraction of that. A reset_fraction of 0 never resets it.
+//
+
+void CRecursiveLeastSquares::SetInitialCovariance(float initial_covariance, float reset_fraction)
+{
+    ASSERT(initial_covariance > 0.0f);
+
+    m_InitialCovariance = initial_covariance;
+    m_ResetFraction     = reset_fraction;
+}
+
+//
+// Forget how sure we are of our estimate, so that the next observations
+// can move it as far as the first ones could
+//
+
+void CRecursiveLeastSquares::ResetCovariance()
+{
+    for (int i = 0; i < RLS_NUM_PARAMETERS; i++)
+    {
+        for (int j = 0; j < RLS_NUM_PARAMETERS; j++)
+        {
+            m_Covariance[i][j] = (i == j) ? m_InitialCovariance : 0.0f;
+        }
+    }
+}
+
+void CRecursiveLeastSquares::SetEstimate(const float *estimate)
+{
+    for (int i = 0; i < RLS_NUM_PARAMETERS; i++)
+    {
+        m_Estimate[i] = estimate[i];
+    }
+}
+
+float CRecursiveLeastSquares::GetCovarianceTrace() const
+{
+    float trace = 0.0f;
+
+    for (int i = 0; i < RLS_NUM_PARAMETERS; i++)
+    {
+        trace += m_Covariance[i][i];
+    }
+
+    return trace;
+}
+
+//
+// The forgetting factor to use for one step of timestep seconds, for
+// observations to keep forgetting_factor of their weight after a second
+//
+
+float CRecursiveLeastSquares::GetStepForgettingFactor(float forgetting_factor, float timestep)
+{
+    return (float)pow(forgetting_factor, timestep);
+}
+
+//
+// Move our estimate towards one that gives observation for regressor,
+// weighing every earlier observation down by step_forgetting_factor.
+// Returns how far off our estimate was beforehand.
+//
+
+float CRecursiveLeastSquares::Update(const float *regressor, float observation, float step_forgetting_factor)
+{
+    int     i               = 0;
+    int     j               = 0;
+    float   u[RLS_NUM_PARAMETERS];
+    float   denominator     = step_forgetting_factor;
+    float   prediction      = 0.0f;
+
+    for (i = 0; i < RLS_NUM_PARAMETERS; i++)
+    {
+        u[i] = 0.0f;
+
+        for (j = 0; j < RLS_NUM_PARAMETERS; j++)
+        {
+            u[i] += m_Covariance[i][j] * regressor[j];
+        }
+
+        denominator += regressor[i] * u[i];
+        prediction  += regressor[i] * m_Estimate[i];
+    }
+
+    float prediction_error = observation - prediction;
+
+    if (denominator < RlsMinDenominator)
+    {
+        // Only a covariance that's been pushed out of shape by rounding
+        // gets here, so start it again
+        ResetCovariance();
+
+        CMetrics::Increment(eMETRIC_RLS_COVARIANCE_RESETS);
+
+        return prediction_error;
+    }
+
+    float inverse_denominator   = 1.0f / denominator;
+    float inverse_forgetting    = 1.0f / step_forgetting_factor;
+
+    for (i = 0; i < RLS_NUM_PARAMETERS; i++)
+    {
+        m_Estimate[i] += u[i] * inverse_denominator * prediction_error;
+
+        for (j = i; j < RLS_NUM_PARAMETERS; j++)
+        {
+            m_Covariance[i][j] = (m_Covariance[i][j] - (u[i] * u[j] * inverse_denominator)) * inverse_forgetting;
+            m_Covariance[j][i] = m_Covariance[i][j];
+        }
+    }
+
+    // Keep the covariance from either winding up while the regressor is
+    // too small to tell us anything, or settling so far that a sudden
+    // change would take forever to follow
+
+    float trace             = GetCovarianceTrace();
+    float initial_trace     = m_InitialCovariance * RLS_NUM_PARAMETERS;
+    float min_covariance    = m_Covariance[0][0];
+
+    for (i = 1; i < RLS_NUM_PARAMETERS; i++)
+    {
+        min_covariance = min(min_covariance, m_Covariance[i][i]);
+    }
+
+    if (trace > initial_trace)
+    {
+        float scale = initial_trace / trace;
+
+        for (i = 0; i < RLS_NUM_PARAMETERS; i++)
+        {
+            for (j = 0; j < RLS_NUM_PARAMETERS; j++)
+            {
+                m_Covariance[i][j] *= scale;
+            }
+        }
+    }
+    else if (min_covariance < m_ResetFraction * m_InitialCovariance)
+    {
+        ResetCovariance();
+
+        CMetrics::Increment(eMETRIC_RLS_COVARIANCE_RESETS);
+    }
+
+    return prediction_error;
+}
+
+//
+// Save or load our estimate, covariance and tuning values
+//
+
+void CRecursiveLeastSquares::Serialize(CArchive &archive)
+{
+    int i = 0;
+    int j = 0;
+
+    if (archive.IsStoring())
+    {
+        archive << m_InitialCovariance << m_ResetFraction;
+
+        for (i = 0; i < RLS_NUM_PARAMETERS; i++)
+        {
+            archive << m_Estimate[i];
+
+            for (j = 0; j < RLS_NUM_PARAMETERS; j++)
+            {
+                archive << m_Covariance[i][j];
+            }
+        }
+    }
+    else
+    {
+        archive >> m_InitialCovariance >> m_ResetFraction;
+
+        for (i = 0; i < RLS_NUM_PARAMETERS; i++)
+        {
+            archive >> m_Estimate[i];
+
+            for (j = 0; j < RLS_NUM_PARAMETERS; j++)
+            {
+                archive >> m_Covariance[i][j];
+            }
+        }
+    }
+}
@@ -0,0 +1,52 @@
+//
+// Recursive least-squares estimator of the RLS_NUM_PARAMETERS parameters
+// of a linear model, observation = regressor . parameters.
+//
+// To use, set the starting covariance with SetInitialCovariance() and a
+// first guess at the parameters with SetEstimate(), then every timestep
+// call Update() with the regressor and the observation that went with it.
+// Each update weighs older observations down by the forgetting factor, so
+// the estimate can follow parameters that change over time.
+//
+// The covariance, which sets how far each update can move the estimate,
+// shrinks as observations come in. Once any parameter's has shrunk to a
+// fraction of where it started, it's all reset back, so that the estimate
+// can still move quickly after a sudden change. Its trace is also never
+// allowed to grow past where it started, which forgetting would otherwise
+// let it do whenever the regressor stays small.
+//
+
+#ifndef CRECURSIVELEASTSQUARES_H
+#define CRECURSIVELEASTSQUARES_H
+
+#define RLS_NUM_PARAMETERS  3
+
+class CRecursiveLeastSquares
+{
+public:
+    CRecursiveLeastSquares();
+    ~CRecursiveLeastSquares()                                       { }
+
+    void            SetInitialCovariance(float initial_covariance, float reset_fraction);
+    void            ResetCovariance();
+
+    void            SetEstimate(const float *estimate);
+    float           GetEstimate(int parameter) const                { return m_Estimate[parameter]; }
+    float           GetCovarianceTrace() const;
+
+    float           Update(const float *regressor, float observation, float step_forgetting_factor);
+
+    static float    GetStepForgettingFactor(float forgetting_factor, float timestep);
+
+    void            Serialize(CArchive &archive);
+
+private:
+    float           m_Estimate[RLS_NUM_PARAMETERS];
+    float           m_Covariance[RLS_NUM_PARAMETERS][RLS_NUM_PARAMETERS];  // Symmetric
+
+    // Tuning values
+    float           m_InitialCovariance;                            // Of each parameter, with none between them
+    float           m_ResetFraction;                                // Of the initial covariance, below which we reset it
+};
+
+#endif
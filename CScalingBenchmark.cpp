@@ -0,0 +1,329 @@
+//
+// Benchmark of how the cost of simulating our world grows with the number
+// of missiles and targets in it, and how well it spreads across threads.
+//
+// For each world size and number of threads, we first find out how many
+// runs of ScalingBenchmarkSimulatedSeconds it takes to fill at least
+// ScalingBenchmarkMinRunSeconds on one thread, then simulate that many
+// runs on every number of threads, so that they all do the same work.
+//
+
+#include "stdafx.h"
+#include "process.h"
+#include "psapi.h"
+#include "CScalingBenchmark.h"
+#include "CBenchmark.h"
+#include "CStopwatch.h"
+#include "CWorld.h"
+
+//
+// Tuning constants
+//
+
+const float     ScalingBenchmarkSimulatedSeconds    = 1.0f;         // Length of one run, in simulated seconds
+const float     ScalingBenchmarkTimestep            = 1.0f / 60.0f;
+const double    ScalingBenchmarkMinRunSeconds       = 0.1;          // Shortest total wall time we'll measure on one thread
+const int       ScalingBenchmarkMaxNumRuns          = 1 << 20;      // Most runs we'll repeat, in case something takes no time at all
+const int       ScalingBenchmarkMaxNumThreads       = MAXIMUM_WAIT_OBJECTS;
+
+// World sizes to try, in missile and target pairs
+static const int ScalingBenchmarkNumPairs[] = { 1, 100, 10000, 1000000 };
+
+const int NumScalingBenchmarkSizes = sizeof(ScalingBenchmarkNumPairs) / sizeof(ScalingBenchmarkNumPairs[0]);
+
+// What one of our worker threads has to do
+struct SScalingBenchmarkWorker
+{
+    CWorld*         m_pWorld;
+    int             m_FirstPair;                // Of this timestep's active pairs
+    int             m_NumPairs;
+    HANDLE          m_StartEvent;               // Set when there's a timestep to do
+    HANDLE          m_DoneEvent;                // Set by the worker when it's done it
+    volatile bool   m_Quit;                     // Set, along with m_StartEvent, when there are no more
+};
+
+//
+// Split world's active pairs as evenly as possible between num_threads
+// workers
+//
+
+static void SplitActivePairs(CWorld *world, int num_threads, SScalingBenchmarkWorker *worker)
+{
+    int num_active_pairs    = world->GetNumActivePairs();
+    int first_pair          = 0;
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        worker[i].m_FirstPair   = first_pair;
+        worker[i].m_NumPairs    = ((num_active_pairs * (i + 1)) / num_threads) - first_pair;
+
+        first_pair += worker[i].m_NumPairs;
+    }
+}
+
+//
+// Step one worker's range of active pairs whenever it's told to, until
+// it's told to quit
+//
+
+unsigned __stdcall CScalingBenchmark::WorkerThread(void *worker)
+{
+    SScalingBenchmarkWorker *scaling_worker = (SScalingBenchmarkWorker *)worker;
+
+    for (;;)
+    {
+        WaitForSingleObject(scaling_worker->m_StartEvent, INFINITE);
+
+        if (scaling_worker->m_Quit)
+        {
+            return 0;
+        }
+
+        scaling_worker->m_pWorld->StepPairs(scaling_worker->m_FirstPair, scaling_worker->m_NumPairs, ScalingBenchmarkTimestep);
+
+        SetEvent(scaling_worker->m_DoneEvent);
+    }
+}
+
+//
+// Simulate num_runs runs of steps_per_run timesteps of world, with the
+// active pairs of each split as evenly as possible across num_threads
+// threads, and time them. The first share is stepped on our own thread,
+// as is the share of any thread we couldn't start. The world is set up
+// again from config before each run, so that every run starts with all
+// of its pairs active.
+//
+
+void CScalingBenchmark::RunWorld(CWorld *world, const CConfig *config, int num_threads, int num_runs, int steps_per_run, SScalingBenchmarkResult *result)
+{
+    int                         i                   = 0;
+    int                         num_pairs           = world->GetNumPairs();
+    int                         num_done_events     = 0;
+    double                      active_pair_steps   = 0.0;
+    SScalingBenchmarkWorker     worker[ScalingBenchmarkMaxNumThreads];
+    HANDLE                      thread[ScalingBenchmarkMaxNumThreads];
+    HANDLE                      done_event[ScalingBenchmarkMaxNumThreads];
+    PROCESS_MEMORY_COUNTERS     memory_counters_before;
+    PROCESS_MEMORY_COUNTERS     memory_counters_after;
+    CStopwatch                  stopwatch;
+
+    ASSERT((num_threads > 0) && (num_threads <= ScalingBenchmarkMaxNumThreads));
+
+    GetProcessMemoryInfo(GetCurrentProcess(), &memory_counters_before, sizeof(memory_counters_before));
+
+    // Start our workers, which wait for their first timestep
+
+    for (i = 0; i < num_threads; i++)
+    {
+        worker[i].m_pWorld      = world;
+        worker[i].m_FirstPair   = 0;
+        worker[i].m_NumPairs    = 0;
+        worker[i].m_StartEvent  = NULL;
+        worker[i].m_DoneEvent   = NULL;
+        worker[i].m_Quit        = false;
+        thread[i]               = NULL;
+
+        if (i == 0)
+        {
+            continue;
+        }
+
+        worker[i].m_StartEvent  = CreateEvent(NULL, FALSE, FALSE, NULL);
+        worker[i].m_DoneEvent   = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+        if (worker[i].m_StartEvent && worker[i].m_DoneEvent)
+        {
+            thread[i] = (HANDLE)_beginthreadex(NULL, 0, WorkerThread, &worker[i], 0, NULL);
+        }
+
+        if (thread[i])
+        {
+            done_event[num_done_events++] = worker[i].m_DoneEvent;
+        }
+        else
+        {
+            TRACE("Unable to start scaling benchmark thread\n");
+        }
+    }
+
+    result->m_Seconds = 0.0;
+
+    for (int run = 0; run < num_runs; run++)
+    {
+        CBenchmarkSuite::SetupWorld(world, config);
+
+        stopwatch.Start();
+
+        for (int step = 0; step < steps_per_run; step++)
+        {
+            active_pair_steps += world->GetNumActivePairs();
+
+            world->AdvanceTime(ScalingBenchmarkTimestep);
+
+            SplitActivePairs(world, num_threads, worker);
+
+            for (i = 0; i < num_threads; i++)
+            {
+                if (thread[i])
+                {
+                    SetEvent(worker[i].m_StartEvent);
+                }
+            }
+
+            // Do our own share, and that of any thread that didn't start,
+            // rather than leave it out
+
+            for (i = 0; i < num_threads; i++)
+            {
+                if (!thread[i])
+                {
+                    world->StepPairs(worker[i].m_FirstPair, worker[i].m_NumPairs, ScalingBenchmarkTimestep);
+                }
+            }
+
+            if (num_done_events > 0)
+            {
+                WaitForMultipleObjects(num_done_events, done_event, TRUE, INFINITE);
+            }
+
+            world->UpdateSleepingPairs();
+        }
+
+        result->m_Seconds += stopwatch.GetElapsedSeconds();
+    }
+
+    for (i = 0; i < num_threads; i++)
+    {
+        if (thread[i])
+        {
+            worker[i].m_Quit = true;
+
+            SetEvent(worker[i].m_StartEvent);
+
+            WaitForSingleObject(thread[i], INFINITE);
+            CloseHandle(thread[i]);
+        }
+
+        if (worker[i].m_StartEvent)
+        {
+            CloseHandle(worker[i].m_StartEvent);
+        }
+
+        if (worker[i].m_DoneEvent)
+        {
+            CloseHandle(worker[i].m_DoneEvent);
+        }
+    }
+
+    GetProcessMemoryInfo(GetCurrentProcess(), &memory_counters_after, sizeof(memory_counters_after));
+
+    result->m_NumPairs                  = num_pairs;
+    result->m_NumThreads                = num_threads;
+    result->m_NumSteps                  = num_runs * steps_per_run;
+    result->m_PeakWorkingSetBytes       = memory_counters_after.PeakWorkingSetSize;
+    result->m_PageFaults                = memory_counters_after.PageFaultCount - memory_counters_before.PageFaultCount;
+    result->m_ActiveFraction            = active_pair_steps / ((double)result->m_NumSteps * num_pairs);
+
+    if (result->m_Seconds > 0.0)
+    {
+        result->m_StepsPerSecond            = result->m_NumSteps / result->m_Seconds;
+        result->m_NanosecondsPerEntityStep  = (result->m_Seconds * 1.0e9) / ((double)result->m_NumSteps * num_pairs * 2.0);
+    }
+    else
+    {
+        result->m_StepsPerSecond            = 0.0;
+        result->m_NanosecondsPerEntityStep  = 0.0;
+    }
+}
+
+//
+// Run every world size up to max_num_pairs on every number of threads,
+// and write the results to results_filename as JSON. Returns false if
+// the results file couldn't be written.
+//
+
+bool CScalingBenchmark::Run(const char *results_filename, int max_num_pairs)
+{
+    int         i               = 0;
+    int         num_processors  = 0;
+    int         steps_per_run   = (int)((ScalingBenchmarkSimulatedSeconds / ScalingBenchmarkTimestep) + 0.5f);
+    bool        first_result    = true;
+    SYSTEM_INFO system_info;
+    CConfig     config;
+    CWorld      world(false);
+
+    FILE *results_file = fopen(results_filename, "w");
+
+    if (!results_file)
+    {
+        TRACE("Unable to open scaling benchmark results file %s\n", results_filename);
+
+        return false;
+    }
+
+    GetSystemInfo(&system_info);
+
+    num_processors = min((int)system_info.dwNumberOfProcessors, ScalingBenchmarkMaxNumThreads);
+
+    fprintf(results_file, "{\n");
+    fprintf(results_file, "  \"simulated_seconds_per_run\": %g,\n", ScalingBenchmarkSimulatedSeconds);
+    fprintf(results_file, "  \"timestep\": %g,\n", ScalingBenchmarkTimestep);
+    fprintf(results_file, "  \"num_processors\": %lu,\n", (unsigned long)system_info.dwNumberOfProcessors);
+    fprintf(results_file, "  \"results\": [");
+
+    for (i = 0; i < NumScalingBenchmarkSizes; i++)
+    {
+        int num_pairs = ScalingBenchmarkNumPairs[i];
+
+        if (num_pairs > max_num_pairs)
+        {
+            break;
+        }
+
+        world.SetNumPairs(num_pairs);
+
+        // Find out how many runs fill enough time on one thread
+
+        SScalingBenchmarkResult result;
+        int                     num_runs = 1;
+
+        for (;;)
+        {
+            RunWorld(&world, &config, 1, num_runs, steps_per_run, &result);
+
+            if ((result.m_Seconds >= ScalingBenchmarkMinRunSeconds) || (num_runs >= ScalingBenchmarkMaxNumRuns))
+            {
+                break;
+            }
+
+            num_runs *= 2;
+        }
+
+        // Then do the same work on more and more threads. There's no point
+        // having more threads than pairs.
+
+        for (int num_threads = 1; (num_threads <= num_processors) && (num_threads <= num_pairs); num_threads *= 2)
+        {
+            if (num_threads > 1)
+            {
+                RunWorld(&world, &config, num_threads, num_runs, steps_per_run, &result);
+            }
+
+            fprintf(results_file, "%s\n    { \"pairs\": %d, \"entities\": %d, \"threads\": %d, \"steps\": %d, \"seconds\": %.6f, "
+                "\"steps_per_second\": %.2f, \"ns_per_entity_step\": %.3f, \"active_fraction\": %.4f, \"peak_working_set_bytes\": %I64u, \"page_faults\": %lu, \"cache_misses\": null }",
+                first_result ? "" : ",",
+                result.m_NumPairs, result.m_NumPairs * 2, result.m_NumThreads, result.m_NumSteps, result.m_Seconds,
+                result.m_StepsPerSecond, result.m_NanosecondsPerEntityStep, result.m_ActiveFraction, result.m_PeakWorkingSetBytes, result.m_PageFaults);
+            fflush(results_file);
+
+            first_result = false;
+
+            TRACE("%d pairs on %d threads: %.3f ns/entity-step\n", result.m_NumPairs, result.m_NumThreads, result.m_NanosecondsPerEntityStep);
+        }
+    }
+
+    fprintf(results_file, "\n  ]\n}\n");
+    fclose(results_file);
+
+    return true;
+}
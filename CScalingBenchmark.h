@@ -0,0 +1,62 @@
+//
+// Benchmark of how the cost of simulating our world grows with the number
+// of missiles and targets in it, and how well it spreads across threads.
+//
+// For each world size (1, 100, 10,000 and 1,000,000 missile and target
+// pairs, up to a limit) and each number of threads (1, 2, 4 and so on up
+// to the number of processors), we simulate ScalingBenchmarkSimulatedSeconds
+// of the world, repeating until the wall time is long enough to measure.
+// Every run starts from a freshly set up world, outside the timing.
+//
+// Each timestep is taken just as CWorld::DoTimestep() takes it: the
+// world's clock is moved on, each thread steps its own share of the
+// active pairs with CWorld::StepPairs(), and once they've all finished,
+// CWorld::UpdateSleepingPairs() puts the pairs that hit to sleep and
+// wakes the ones whose explosions are over. The worker threads are kept
+// for the whole of a run and woken for each timestep.
+//
+// We report steps per second, nanoseconds per entity per step, the mean
+// fraction of pairs that were active (rather than asleep) each step, and
+// the peak working set and page faults of the process, as JSON. Every
+// entity counts towards the nanoseconds per entity per step, asleep or
+// not, just as every entity is in the world whose cost it measures. There's no
+// portable way to read the CPU's cache miss counters on Windows, so
+// cache_misses is always null; run the same sizes under a profiler that
+// can read them if they're needed.
+//
+// Run the demo with /scalingbenchmark [<json file>] [<max pairs>]. Results
+// go to Scaling.json if no file is given.
+//
+
+#ifndef CSCALINGBENCHMARK_H
+#define CSCALINGBENCHMARK_H
+
+class CConfig;
+class CWorld;
+
+// Results of simulating one world size on one number of threads
+struct SScalingBenchmarkResult
+{
+    int                     m_NumPairs;
+    int                     m_NumThreads;
+    int                     m_NumSteps;                     // Total timesteps simulated, across all runs
+    double                  m_Seconds;                      // Total wall time
+    double                  m_StepsPerSecond;
+    double                  m_NanosecondsPerEntityStep;     // Each pair is 2 entities
+    double                  m_ActiveFraction;               // Mean fraction of the pairs that were active, rather than asleep, each step
+    unsigned __int64        m_PeakWorkingSetBytes;          // Of the whole process, so far
+    unsigned long           m_PageFaults;                   // While simulating
+};
+
+class CScalingBenchmark
+{
+public:
+    static bool             Run(const char *results_filename, int max_num_pairs);
+
+private:
+    static void             RunWorld(CWorld *world, const CConfig *config, int num_threads, int num_runs, int steps_per_run, SScalingBenchmarkResult *result);
+
+    static unsigned __stdcall   WorkerThread(void *worker);
+};
+
+#endif
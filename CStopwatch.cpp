@@ -0,0 +1,56 @@
+//
+// Class to time things with the high-resolution performance counter.
+//
+// Call Start(), then GetElapsedSeconds() as many times as needed.
+//
+
+#include "stdafx.h"
+#include "CStopwatch.h"
+
+void CStopwatch::Start()
+{
+    m_StartCounter = GetCounter();
+}
+
+//
+// Number of seconds since Start() was last called
+//
+
+double CStopwatch::GetElapsedSeconds()
+{
+    return (double)(GetCounter() - m_StartCounter) / GetCounterFrequency();
+}
+
+//
+// Current value of the performance counter, in ticks
+//
+
+__int64 CStopwatch::GetCounter()
+{
+    LARGE_INTEGER counter;
+
+    QueryPerformanceCounter(&counter);
+
+    return counter.QuadPart;
+}
+
+//
+// Number of performance counter ticks per second. This never changes
+// while the system is running, so we only ask for it once.
+//
+
+double CStopwatch::GetCounterFrequency()
+{
+    static double counter_frequency = 0.0;
+
+    if (counter_frequency == 0.0)
+    {
+        LARGE_INTEGER frequency;
+
+        QueryPerformanceFrequency(&frequency);
+
+        counter_frequency = (double)frequency.QuadPart;
+    }
+
+    return counter_frequency;
+}
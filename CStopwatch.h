@@ -0,0 +1,26 @@
+//
+// Class to time things with the high-resolution performance counter.
+//
+// Call Start(), then GetElapsedSeconds() as many times as needed.
+//
+
+#ifndef CSTOPWATCH_H
+#define CSTOPWATCH_H
+
+class CStopwatch
+{
+public:
+    CStopwatch()                                { Start(); }
+    ~CStopwatch()                               { }
+
+    void            Start();
+    double          GetElapsedSeconds();
+
+    static __int64  GetCounter();
+    static double   GetCounterFrequency();
+
+private:
+    __int64         m_StartCounter;             // Value of the performance counter when we were started
+};
+
+#endif
@@ -1,108 +1,136 @@
-//
-// Our target -- the thing the missile is trying to steer towards. 
-// It has 2 control modes: either keyboard or automatic. 
-//
-// The desired x and y velocities from the keyboard are passed 
-// into SetUserDesiredVelocityX() and SetUserDesiredVelocityY() every 
-// timestep. They're either used to set the target's actual velocity, or ignored,
-// depending on the target's current control mode.
-//
-// For automatic movement, the target follows a random path.
-//
-
-
-#ifndef CTARGET_H
-#define CTARGET_H
-
-#include "CVector2.h"
-#include "Texture.h"
-
-class CWorld;
-class CGlView;
-
-// Possible control modes for our target
-enum eTargetControlMode
-{
-    eTARGET_CONTROL_AUTOMATIC = 0,
-    eTARGET_CONTROL_KEYBOARD,
-
-    NUM_TARGET_MOVEMENT_MODES,
-};
-
-// Possible states our target can be in
-enum eTargetState
-{
-    eTARGET_STATE_MOVING = 0,
-    eTARGET_STATE_EXPLODING,
-    eTARGET_STATE_FINISHED_EXPLODING,
-
-    NUM_TARGET_STATES,
-};
-
-// Possible textures to use to draw our target
-enum eTargetTexture
-{
-    eTARGET_TEXTURE_NORMAL = 0,
-    eTARGET_TEXTURE_EXPLOSION,
-
-    NUM_TARGET_TEXTURES,
-};
-
-class CTarget
-{
-public:
-    CTarget();
-    ~CTarget()                                                                  { }
-
-    void                Reset();
-
-    void                SetCurrentWorld(CWorld *current_world)                  { m_pCurrentWorld = current_world; }
-
-    void                SetControlMode(eTargetControlMode new_control_mode)     { m_ControlMode = new_control_mode; }
-
-    void                SetPosition(float new_position_x, float new_position_y) { m_Position.x = new_position_x; m_Position.y = new_position_y; }
-    void                SetPosition(CVector2 *new_position)                     { m_Position = *new_position; }
-    CVector2*           GetPosition()                                           { return &m_Position; }
-
-    void                SetUserDesiredVelocityX(float new_velocity_x)           { m_UserDesiredVelocity.x = new_velocity_x; }
-    void                SetUserDesiredVelocityY(float new_velocity_y)           { m_UserDesiredVelocity.y = new_velocity_y; }
-
-    void                Move(float timestep);
-
-    void                SetTexture(const char *filename, int index, int width, int height, int bit_depth);
-    CTexture*           GetTexture(int index)                                   { return &m_Texture[index]; }
-
-    bool                NeedToBeReset()                                         { return (m_CurrentState == eTARGET_STATE_FINISHED_EXPLODING); }
-    eTargetState        GetCurrentState()                                       { return m_CurrentState; }
-
-    void                Explode();
-
-    float               GetSize();
-    float               GetMaxAngularVelocity();
-
-    void                SetMaxSpeed(float max_speed)                            { m_MaxSpeed = max_speed; }
-    float               GetMaxSpeed()                                           { return m_MaxSpeed; }
-
-    int                 Draw(CGlView *gl_view);
-
-private:                
-    float               GetNumSecondsToExplode();
-
-    CWorld*             m_pCurrentWorld;                // The world we exist in
-
-    CVector2            m_UserDesiredVelocity;          // Velocity desired from the user
-
-    CVector2            m_Direction;                    // The current direction we're headed
-    CVector2            m_Position;                     // Our current position
-
-    CTexture            m_Texture[NUM_TARGET_TEXTURES]; // Textures used to draw us
-
-    float               m_MaxSpeed;                     // Our maximum speed in world units/s
-
-    float               m_ExplosionTimeLeft;            // If m_CurrentState is eTARGET_STATE_EXPLODING, how many seconds are left before we're finished exploding?
-
-    eTargetControlMode  m_ControlMode;                  // Our current control mode -- either keyboard or automatic
-    eTargetState        m_CurrentState;                 // Our current state -- either moving, exploding, or finished exploding
-};
-
-#endif
+//
+// Our target -- the thing the missile is trying to steer towards. 
+// It has 4 control modes: keyboard, automatic, trajectory or path.
+//
+// The desired x and y velocities from the keyboard are passed 
+// into SetUserDesiredVelocityX() and SetUserDesiredVelocityY() every 
+// timestep. They're either used to set the target's actual velocity, or ignored,
+// depending on the target's current control mode.
+//
+// For automatic movement, the target follows a random path. It draws its
+// random numbers from its own CRandom, so the path only depends on the seed
+// passed to SetRandomSeed().
+//
+// A target can also play back a path from a CTargetTrajectoryTable, so
+// that many runs face exactly the same targets without moving them, or
+// follow a smooth scripted CTargetPath at whatever speed the path sets.
+// Either starts over whenever it's Reset().
+//
+
+
+#ifndef CTARGET_H
+#define CTARGET_H
+
+#include "CVector2.h"
+#include "CRandom.h"
+#include "CConfig.h"
+
+class CWorld;
+class CGlView;
+class CTargetTrajectoryTable;
+class CTargetPath;
+
+// Possible control modes for our target
+enum eTargetControlMode
+{
+    eTARGET_CONTROL_AUTOMATIC = 0,
+    eTARGET_CONTROL_KEYBOARD,
+    eTARGET_CONTROL_TRAJECTORY,
+    eTARGET_CONTROL_PATH,
+
+    NUM_TARGET_MOVEMENT_MODES,
+};
+
+// Possible states our target can be in
+enum eTargetState
+{
+    eTARGET_STATE_MOVING = 0,
+    eTARGET_STATE_EXPLODING,
+    eTARGET_STATE_FINISHED_EXPLODING,
+
+    NUM_TARGET_STATES,
+};
+
+// Possible textures to use to draw our target
+enum eTargetTexture
+{
+    eTARGET_TEXTURE_NORMAL = 0,
+    eTARGET_TEXTURE_EXPLOSION,
+
+    NUM_TARGET_TEXTURES,
+};
+
+class CTarget
+{
+public:
+    CTarget();
+    ~CTarget()                                                                  { }
+
+    void                Reset();
+
+    void                SetCurrentWorld(CWorld *current_world)                  { m_pCurrentWorld = current_world; }
+    void                SetConfig(const CConfig *config)                        { m_pConfig = config; }
+
+    void                SetRandomSeed(unsigned long seed)                       { m_Random.SetSeed(seed); }
+    void                SetTrajectory(const CTargetTrajectoryTable *table, int trajectory);
+    void                SetPath(const CTargetPath *path, double time_offset);
+
+    void                SetControlMode(eTargetControlMode new_control_mode)     { m_ControlMode = new_control_mode; }
+    eTargetControlMode  GetControlMode()                                        { return m_ControlMode; }
+
+    void                SetPosition(float new_position_x, float new_position_y) { m_Position.x = new_position_x; m_Position.y = new_position_y; }
+    void                SetPosition(CVector2 *new_position)                     { m_Position = *new_position; }
+    CVector2*           GetPosition()                                           { return &m_Position; }
+    CVector2            GetVelocity();
+
+    void                SetUserDesiredVelocityX(float new_velocity_x)           { m_UserDesiredVelocity.x = new_velocity_x; }
+    void                SetUserDesiredVelocityY(float new_velocity_y)           { m_UserDesiredVelocity.y = new_velocity_y; }
+
+    void                Move(float timestep);
+
+    bool                NeedToBeReset()                                         { return (m_CurrentState == eTARGET_STATE_FINISHED_EXPLODING); }
+    eTargetState        GetCurrentState()                                       { return m_CurrentState; }
+
+    void                Explode();
+    float               GetExplosionTimeLeft()                                  { return m_ExplosionTimeLeft; }
+    void                AdvanceExplosion(float seconds);
+
+    float               GetSize();
+    float               GetMaxAngularVelocity();
+
+    void                SetMaxSpeed(float max_speed)                            { m_MaxSpeed = max_speed; }
+    float               GetMaxSpeed()                                           { return m_MaxSpeed; }
+
+    int                 Draw(CGlView *gl_view);
+
+    void                Serialize(CArchive &archive);
+
+private:                
+    float               GetNumSecondsToExplode();
+
+    const CConfig*      m_pConfig;                      // Our tuning values
+    CWorld*             m_pCurrentWorld;                // The world we exist in
+
+    CVector2            m_UserDesiredVelocity;          // Velocity desired from the user
+
+    CVector2            m_Direction;                    // The current direction we're headed
+    CVector2            m_Position;                     // Our current position
+
+    CRandom             m_Random;                       // Where we get the random numbers for our automatic movement from
+
+    const CTargetTrajectoryTable*   m_pTrajectoryTable; // Where we get our path from in eTARGET_CONTROL_TRAJECTORY. Not ours.
+    int                 m_Trajectory;                   // Which of its trajectories we follow
+    const CTargetPath*  m_pPath;                        // The path we follow in eTARGET_CONTROL_PATH. Not ours.
+    double              m_PathTimeOffset;               // How many seconds along it we start
+
+    double              m_PlaybackTime;                 // How many seconds along our trajectory or path we are. A double, so that adding up timesteps doesn't drift off the samples.
+
+    float               m_MaxSpeed;                     // Our maximum speed in world units/s
+
+    float               m_ExplosionTimeLeft;            // If m_CurrentState is eTARGET_STATE_EXPLODING, how many seconds are left before we're finished exploding?
+
+    eTargetControlMode  m_ControlMode;                  // Our current control mode -- keyboard, automatic, trajectory or path
+    eTargetState        m_CurrentState;                 // Our current state -- either moving, exploding, or finished exploding
+};
+
+#endif
@@ -0,0 +1,249 @@
+//
+// A closed path for targets to follow, read in from a file of keyframes.
+//
+// The tangent at each keyframe is the Catmull-Rom one: the difference
+// between the keyframes either side of it, over the time between them,
+// wrapping around the ends of the loop. Each segment is then the cubic
+// Hermite curve between its two keyframes and their tangents, which we
+// turn into a plain cubic up front so that finding a position is one
+// search and a few multiply-adds.
+//
+
+#include "stdafx.h"
+#include "math.h"
+#include "CTargetPath.h"
+#include "CVector2Batch.h"
+
+//
+// Tuning constants
+//
+
+const int TargetPathMaxLineLength = 256;
+
+//
+// Read in our keyframes from filename, replacing any we had. Returns false
+// if the file couldn't be read or doesn't describe a path, in which case
+// we're left without one.
+//
+
+bool CTargetPath::Load(const char *filename)
+{
+    char        line[TargetPathMaxLineLength];
+    int         line_number     = 0;
+    int         num_keyframes   = 0;
+    double      time[TARGET_PATH_MAX_KEYFRAMES];
+    CVector2    position[TARGET_PATH_MAX_KEYFRAMES];
+
+    m_NumKeyframes = 0;
+
+    FILE *file = fopen(filename, "r");
+
+    if (!file)
+    {
+        TRACE("Unable to open target path file %s\n", filename);
+
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), file))
+    {
+        const char* start = line;
+
+        line_number++;
+
+        while ((*start == ' ') || (*start == '\t'))
+        {
+            start++;
+        }
+
+        if ((*start == ';') || (*start == '\r') || (*start == '\n') || (*start == '\0'))
+        {
+            continue;
+        }
+
+        if (num_keyframes == TARGET_PATH_MAX_KEYFRAMES)
+        {
+            TRACE("%s(%d): more than %d keyframes\n", filename, line_number, TARGET_PATH_MAX_KEYFRAMES);
+
+            fclose(file);
+
+            return false;
+        }
+
+        if (sscanf(start, "%lf %f %f", &time[num_keyframes], &position[num_keyframes].x, &position[num_keyframes].y) != 3)
+        {
+            TRACE("%s(%d): expected a time, x and y\n", filename, line_number);
+
+            fclose(file);
+
+            return false;
+        }
+
+        num_keyframes++;
+    }
+
+    fclose(file);
+
+    return SetKeyframes(num_keyframes, time, position);
+}
+
+//
+// Replace our keyframes with num_keyframes of them, at time[i] seconds
+// and position[i]. Returns false if they don't describe a path, in which
+// case we're left without one.
+//
+
+bool CTargetPath::SetKeyframes(int num_keyframes, const double *time, const CVector2 *position)
+{
+    m_NumKeyframes = 0;
+
+    if ((num_keyframes < 3) || (num_keyframes > TARGET_PATH_MAX_KEYFRAMES))
+    {
+        TRACE("A target path needs from 3 to %d keyframes, not %d\n", TARGET_PATH_MAX_KEYFRAMES, num_keyframes);
+
+        return false;
+    }
+
+    for (int i = 0; i < num_keyframes; i++)
+    {
+        if ((i == 0) ? (time[i] != 0.0) : (time[i] <= time[i - 1]))
+        {
+            TRACE("Target path keyframe %d is out of order: they have to start at time 0 and go forwards in time\n", i);
+
+            return false;
+        }
+
+        m_KeyframeTime[i]       = time[i];
+        m_KeyframePosition[i]   = position[i];
+    }
+
+    m_NumKeyframes = num_keyframes;
+
+    MakeSegments();
+
+    return true;
+}
+
+//
+// Work out the cubic for each segment from our keyframes
+//
+
+void CTargetPath::MakeSegments()
+{
+    int         i           = 0;
+    int         last        = m_NumKeyframes - 1;
+    double      period      = GetPeriod();
+    CVector2    tangent[TARGET_PATH_MAX_KEYFRAMES];
+
+    // The first and last keyframes are the same point on the loop, so
+    // they look past each other to find their neighbors
+
+    for (i = 0; i < m_NumKeyframes; i++)
+    {
+        int     previous        = (i == 0)      ? (last - 1)    : (i - 1);
+        int     next            = (i == last)   ? 1             : (i + 1);
+        double  previous_time   = m_KeyframeTime[previous]  - ((i == 0)     ? period : 0.0);
+        double  next_time       = m_KeyframeTime[next]      + ((i == last)  ? period : 0.0);
+
+        tangent[i] = (m_KeyframePosition[next] - m_KeyframePosition[previous]) * (float)(1.0 / (next_time - previous_time));
+    }
+
+    for (i = 0; i < last; i++)
+    {
+        float       length  = (float)(m_KeyframeTime[i + 1] - m_KeyframeTime[i]);
+        CVector2    change  = m_KeyframePosition[i + 1] - m_KeyframePosition[i];
+
+        m_SegmentA[i] = m_KeyframePosition[i];
+        m_SegmentB[i] = tangent[i];
+        m_SegmentC[i] = ((change * (3.0f / length)) - (tangent[i] * 2.0f) - tangent[i + 1]) * (1.0f / length);
+        m_SegmentD[i] = ((change * (-2.0f / length)) + tangent[i] + tangent[i + 1]) * (1.0f / (length * length));
+    }
+}
+
+//
+// Which segment we're on at time seconds, going around the loop as many
+// times as it takes, and how many seconds into it we are
+//
+
+int CTargetPath::FindSegment(double time, float *segment_time) const
+{
+    ASSERT(IsLoaded());
+
+    double loop_time = fmod(time, GetPeriod());
+
+    if (loop_time < 0.0)
+    {
+        loop_time += GetPeriod();
+    }
+
+    // Find the last keyframe at or before loop_time, leaving out the
+    // last keyframe, which only ends the last segment
+
+    int first   = 0;
+    int last    = m_NumKeyframes - 2;
+
+    while (first < last)
+    {
+        int middle = (first + last + 1) / 2;
+
+        if (m_KeyframeTime[middle] <= loop_time)
+        {
+            first = middle;
+        }
+        else
+        {
+            last = middle - 1;
+        }
+    }
+
+    *segment_time = (float)(loop_time - m_KeyframeTime[first]);
+
+    return first;
+}
+
+//
+// Where a target following us is time seconds after it started
+//
+
+CVector2 CTargetPath::GetPosition(double time) const
+{
+    float   t;
+    int     segment = FindSegment(time, &t);
+
+    return m_SegmentA[segment] + ((m_SegmentB[segment] + ((m_SegmentC[segment] + (m_SegmentD[segment] * t)) * t)) * t);
+}
+
+//
+// How fast, in world units/s, and which way a target following us is
+// moving time seconds after it started
+//
+
+CVector2 CTargetPath::GetVelocity(double time) const
+{
+    float   t;
+    int     segment = FindSegment(time, &t);
+
+    return m_SegmentB[segment] + (((m_SegmentC[segment] * 2.0f) + (m_SegmentD[segment] * (3.0f * t))) * t);
+}
+
+//
+// Set positions to where targets following us are at each of the
+// num_times times in times, all in one go
+//
+
+void CTargetPath::GetPositions(const double *times, int num_times, CVector2Batch *positions) const
+{
+    positions->SetSize(num_times);
+
+    float *x = positions->GetX();
+    float *y = positions->GetY();
+
+    for (int i = 0; i < num_times; i++)
+    {
+        float   t;
+        int     segment = FindSegment(times[i], &t);
+
+        x[i] = m_SegmentA[segment].x + ((m_SegmentB[segment].x + ((m_SegmentC[segment].x + (m_SegmentD[segment].x * t)) * t)) * t);
+        y[i] = m_SegmentA[segment].y + ((m_SegmentB[segment].y + ((m_SegmentC[segment].y + (m_SegmentD[segment].y * t)) * t)) * t);
+    }
+}
@@ -0,0 +1,64 @@
+//
+// A closed path for targets to follow, read in from a file of keyframes.
+//
+// Each line of the file is a keyframe: a time in seconds, then an x and y
+// position in world units. Lines starting with ; are comments. The first
+// keyframe has to be at time 0, and the rest in order after it. The path
+// loops: the time of the last keyframe is how long it takes to go around
+// once, so the last keyframe should be at the same position as the first.
+//
+// Positions in between keyframes come from a Catmull-Rom spline through
+// them, so a target following the path moves with no jumps in either its
+// position or its velocity, even where it wraps around. That keeps the
+// missile's heading error, and its derivative, free of the spikes that
+// make adaptation difficult.
+//
+// Keyframes can also be passed in directly with SetKeyframes(). They're
+// kept inside the path, up to TARGET_PATH_MAX_KEYFRAMES of them, like the
+// control points of a CGraph. GetPositions() finds where many targets are
+// along the path at once, and puts them in a CVector2Batch.
+//
+
+#ifndef CTARGETPATH_H
+#define CTARGETPATH_H
+
+#include "CVector2.h"
+
+class CVector2Batch;
+
+#define TARGET_PATH_MAX_KEYFRAMES 64
+
+class CTargetPath
+{
+public:
+    CTargetPath()                                           : m_NumKeyframes(0) { }
+    ~CTargetPath()                                          { }
+
+    bool            Load(const char *filename);
+    bool            SetKeyframes(int num_keyframes, const double *time, const CVector2 *position);
+
+    bool            IsLoaded() const                        { return (m_NumKeyframes > 0); }
+    double          GetPeriod() const                       { ASSERT(IsLoaded()); return m_KeyframeTime[m_NumKeyframes - 1]; }
+
+    CVector2        GetPosition(double time) const;
+    CVector2        GetVelocity(double time) const;
+    void            GetPositions(const double *times, int num_times, CVector2Batch *positions) const;
+
+private:
+    void            MakeSegments();
+    int             FindSegment(double time, float *segment_time) const;
+
+    int             m_NumKeyframes;
+    double          m_KeyframeTime[TARGET_PATH_MAX_KEYFRAMES];
+    CVector2        m_KeyframePosition[TARGET_PATH_MAX_KEYFRAMES];
+
+    // Each segment, from one keyframe to the next, is the cubic
+    // a + bt + ct^2 + dt^3, in the seconds t since the segment started
+
+    CVector2        m_SegmentA[TARGET_PATH_MAX_KEYFRAMES];
+    CVector2        m_SegmentB[TARGET_PATH_MAX_KEYFRAMES];
+    CVector2        m_SegmentC[TARGET_PATH_MAX_KEYFRAMES];
+    CVector2        m_SegmentD[TARGET_PATH_MAX_KEYFRAMES];
+};
+
+#endif
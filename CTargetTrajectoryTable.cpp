@@ -0,0 +1,381 @@
+//
+// A table of precomputed target paths.
+//
+// The file is laid out like this:
+//
+//      STargetTrajectoryFileHeader
+//      Start position of trajectory 0, as two LONGs counting m_Quantum
+//      Movement each timestep of trajectory 0, as two shorts counting m_Quantum
+//      Start position of trajectory 1
+//      ...
+//
+// so each sample after the first costs 4 bytes, rather than the 8 of a
+// pair of floats.
+//
+
+#include "stdafx.h"
+#include "math.h"
+#include "CTargetTrajectoryTable.h"
+#include "CWorld.h"
+
+const DWORD TargetTrajectoryFileVersion     = 1;
+
+//
+// Tuning constants
+//
+
+const float TargetTrajectoryQuantum         = 1.0f / 64.0f;     // Positions are rounded to this, in world units. A power of 2, so that rounded positions are exact floats.
+const int   TargetTrajectoryMaxCount        = 32767;            // Largest movement in one timestep that fits in the file, in quanta
+const DWORD TargetTrajectoryMaxSamples      = 1 << 26;          // Most samples, over every trajectory, that we'll load from a file
+
+//
+// Number of quanta nearest to value
+//
+
+static LONG Quantize(float value)
+{
+    return (LONG)floor((value / TargetTrajectoryQuantum) + 0.5f);
+}
+
+CTargetTrajectoryTable::CTargetTrajectoryTable()
+{
+    m_pX                = NULL;
+    m_pY                = NULL;
+    m_NumTrajectories   = 0;
+    m_NumSteps          = 0;
+    m_Timestep          = 0.0f;
+    m_FirstSeed         = 0;
+}
+
+//
+// Make room for num_trajectories trajectories of num_steps timesteps each,
+// throwing away whatever we had before
+//
+
+void CTargetTrajectoryTable::Allocate(int num_trajectories, int num_steps)
+{
+    ASSERT((num_trajectories > 0) && (num_steps > 0));
+
+    Free();
+
+    int num_samples = num_trajectories * (num_steps + 1);
+
+    m_pX                = new float[num_samples];
+    m_pY                = new float[num_samples];
+    m_NumTrajectories   = num_trajectories;
+    m_NumSteps          = num_steps;
+}
+
+void CTargetTrajectoryTable::Free()
+{
+    delete [] m_pX;
+    delete [] m_pY;
+
+    m_pX                = NULL;
+    m_pY                = NULL;
+    m_NumTrajectories   = 0;
+    m_NumSteps          = 0;
+}
+
+//
+// Record num_trajectories automatic target paths, num_steps timesteps
+// long, from a world with config restarted from first_seed, with its
+// targets moving at target_max_speed. Only the targets are moved; there's
+// nothing for them to be hit by.
+//
+
+void CTargetTrajectoryTable::Generate(const CConfig *config, float target_max_speed, unsigned long first_seed, int num_trajectories, float timestep, int num_steps)
+{
+    CWorld  world(false);
+    int     trajectory  = 0;
+
+    Allocate(num_trajectories, num_steps);
+
+    m_Timestep  = timestep;
+    m_FirstSeed = first_seed;
+
+    world.SetNumPairs(num_trajectories);
+    world.SetConfig(config);
+    world.Restart(first_seed);
+
+    world.SetSetting(eWORLD_SETTING_TARGET_CONTROL_MODE,   (float)eTARGET_CONTROL_AUTOMATIC);
+    world.SetSetting(eWORLD_SETTING_TARGET_MAX_SPEED,      target_max_speed);
+
+    for (int step = 0; step <= num_steps; step++)
+    {
+        for (trajectory = 0; trajectory < num_trajectories; trajectory++)
+        {
+            CTarget*    target  = world.GetTarget(trajectory);
+            int         sample  = (trajectory * (num_steps + 1)) + step;
+
+            if (step > 0)
+            {
+                target->Move(timestep);
+            }
+
+            m_pX[sample] = Quantize(target->GetPosition()->x) * TargetTrajectoryQuantum;
+            m_pY[sample] = Quantize(target->GetPosition()->y) * TargetTrajectoryQuantum;
+        }
+    }
+}
+
+//
+// Write the table to filename, replacing whatever was there. Returns
+// false if the file couldn't be written, or if a target moved too far in
+// one timestep to be stored.
+//
+
+bool CTargetTrajectoryTable::Save(const char *filename) const
+{
+    ASSERT(m_NumTrajectories > 0);
+
+    FILE *file = fopen(filename, "wb");
+
+    if (!file)
+    {
+        TRACE("Unable to open target trajectory file %s\n", filename);
+
+        return false;
+    }
+
+    STargetTrajectoryFileHeader header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_Magic, "TTRJ", sizeof(header.m_Magic));
+    header.m_Version            = TargetTrajectoryFileVersion;
+    header.m_NumTrajectories    = m_NumTrajectories;
+    header.m_NumSteps           = m_NumSteps;
+    header.m_Timestep           = m_Timestep;
+    header.m_FirstSeed          = m_FirstSeed;
+    header.m_Quantum            = TargetTrajectoryQuantum;
+
+    fwrite(&header, sizeof(header), 1, file);
+
+    short*  movement    = new short[m_NumSteps * 2];
+    bool    saved       = true;
+
+    for (int trajectory = 0; (trajectory < m_NumTrajectories) && saved; trajectory++)
+    {
+        const float*    x           = &m_pX[trajectory * (m_NumSteps + 1)];
+        const float*    y           = &m_pY[trajectory * (m_NumSteps + 1)];
+        LONG            start[2]    = { Quantize(x[0]), Quantize(y[0]) };
+
+        for (int step = 0; step < m_NumSteps; step++)
+        {
+            LONG movement_x = Quantize(x[step + 1]) - Quantize(x[step]);
+            LONG movement_y = Quantize(y[step + 1]) - Quantize(y[step]);
+
+            if ((labs(movement_x) > TargetTrajectoryMaxCount) || (labs(movement_y) > TargetTrajectoryMaxCount))
+            {
+                TRACE("Target trajectory %d moves too far at step %d to be saved\n", trajectory, step);
+
+                saved = false;
+
+                break;
+            }
+
+            movement[(step * 2) + 0] = (short)movement_x;
+            movement[(step * 2) + 1] = (short)movement_y;
+        }
+
+        if (!saved)
+        {
+            break;
+        }
+
+        fwrite(start, sizeof(start), 1, file);
+        fwrite(movement, sizeof(short) * 2, m_NumSteps, file);
+    }
+
+    delete [] movement;
+
+    if (ferror(file))
+    {
+        TRACE("Unable to write target trajectory file %s\n", filename);
+
+        saved = false;
+    }
+
+    fclose(file);
+
+    return saved;
+}
+
+//
+// Read in a table written by Save(), replacing the one we have. Returns
+// false if filename couldn't be read, in which case we're left empty.
+//
+
+bool CTargetTrajectoryTable::Load(const char *filename)
+{
+    Free();
+
+    FILE *file = fopen(filename, "rb");
+
+    if (!file)
+    {
+        TRACE("Unable to open target trajectory file %s\n", filename);
+
+        return false;
+    }
+
+    STargetTrajectoryFileHeader header;
+
+    if ((fread(&header, sizeof(header), 1, file) != 1)                 ||
+        (memcmp(header.m_Magic, "TTRJ", sizeof(header.m_Magic)) != 0)  ||
+        (header.m_Version != TargetTrajectoryFileVersion)              ||
+        (header.m_NumTrajectories == 0) || (header.m_NumSteps == 0)     ||
+        (header.m_Timestep <= 0.0f) || (header.m_Quantum <= 0.0f))
+    {
+        TRACE("%s is not a target trajectory file we can read\n", filename);
+
+        fclose(file);
+
+        return false;
+    }
+
+    // Don't trust the header's counts until we know the samples they ask
+    // for fit in memory and are all actually in the file. Worked out in 64
+    // bits, so that no count can overflow them.
+
+    unsigned __int64 num_samples    = (unsigned __int64)header.m_NumTrajectories * ((unsigned __int64)header.m_NumSteps + 1);
+    unsigned __int64 data_size      = (unsigned __int64)header.m_NumTrajectories * ((sizeof(LONG) * 2) + ((unsigned __int64)header.m_NumSteps * sizeof(short) * 2));
+    long             file_size      = -1;
+
+    if ((fseek(file, 0, SEEK_END) == 0) && ((file_size = ftell(file)) >= 0))
+    {
+        fseek(file, sizeof(header), SEEK_SET);
+    }
+
+    if ((header.m_NumTrajectories > TargetTrajectoryMaxSamples) || (header.m_NumSteps >= TargetTrajectoryMaxSamples) ||
+        (num_samples > TargetTrajectoryMaxSamples) || (file_size < 0) || (data_size > (unsigned __int64)(file_size - sizeof(header))))
+    {
+        TRACE("Target trajectory file %s is truncated, or asks for more than %lu samples\n", filename, (unsigned long)TargetTrajectoryMaxSamples);
+
+        fclose(file);
+
+        return false;
+    }
+
+    Allocate(header.m_NumTrajectories, header.m_NumSteps);
+
+    m_Timestep  = header.m_Timestep;
+    m_FirstSeed = header.m_FirstSeed;
+
+    short*  movement    = new short[m_NumSteps * 2];
+    bool    loaded      = true;
+
+    for (int trajectory = 0; trajectory < m_NumTrajectories; trajectory++)
+    {
+        float*  x           = &m_pX[trajectory * (m_NumSteps + 1)];
+        float*  y           = &m_pY[trajectory * (m_NumSteps + 1)];
+        LONG    position[2];
+
+        if ((fread(position, sizeof(position), 1, file) != 1) ||
+            (fread(movement, sizeof(short) * 2, m_NumSteps, file) != (size_t)m_NumSteps))
+        {
+            TRACE("Target trajectory file %s is truncated\n", filename);
+
+            loaded = false;
+
+            break;
+        }
+
+        // Add up the movements in whole quanta, so that rounding never builds up
+
+        x[0] = position[0] * header.m_Quantum;
+        y[0] = position[1] * header.m_Quantum;
+
+        for (int step = 0; step < m_NumSteps; step++)
+        {
+            position[0] += movement[(step * 2) + 0];
+            position[1] += movement[(step * 2) + 1];
+
+            x[step + 1] = position[0] * header.m_Quantum;
+            y[step + 1] = position[1] * header.m_Quantum;
+        }
+    }
+
+    delete [] movement;
+
+    fclose(file);
+
+    if (!loaded)
+    {
+        Free();
+    }
+
+    return loaded;
+}
+
+//
+// Index into m_pX and m_pY of the last sample of trajectory at or before
+// time seconds from its start, and how far time is towards the next
+// sample. Times past the end of the trajectory give its last sample.
+//
+
+int CTargetTrajectoryTable::GetSampleIndex(int trajectory, double time, float *fraction) const
+{
+    ASSERT((trajectory >= 0) && (trajectory < m_NumTrajectories));
+
+    double  sample_time = time / m_Timestep;
+    int     step        = 0;
+
+    *fraction = 0.0f;
+
+    if (sample_time >= m_NumSteps)
+    {
+        step = m_NumSteps;
+    }
+    else if (sample_time > 0.0)
+    {
+        step        = (int)sample_time;
+        *fraction   = (float)(sample_time - step);
+    }
+
+    return (trajectory * (m_NumSteps + 1)) + step;
+}
+
+//
+// Where the target following trajectory is, time seconds from its start.
+// Times between samples are interpolated, and times past the end stay at
+// the last sample.
+//
+
+CVector2 CTargetTrajectoryTable::GetPosition(int trajectory, double time) const
+{
+    float   fraction;
+    int     sample      = GetSampleIndex(trajectory, time, &fraction);
+
+    if (fraction == 0.0f)
+    {
+        return CVector2(m_pX[sample], m_pY[sample]);
+    }
+
+    return CVector2(m_pX[sample] + ((m_pX[sample + 1] - m_pX[sample]) * fraction),
+                    m_pY[sample] + ((m_pY[sample + 1] - m_pY[sample]) * fraction));
+}
+
+//
+// The velocity of the target following trajectory over the timestep
+// ending nearest to time seconds from its start, in world units/s, which
+// is what it's been moving at most recently. At the start, that's its
+// first timestep. It's stopped once it's gone past the end.
+//
+
+CVector2 CTargetTrajectoryTable::GetVelocity(int trajectory, double time) const
+{
+    ASSERT((trajectory >= 0) && (trajectory < m_NumTrajectories));
+
+    int step = max((int)((time / m_Timestep) + 0.5), 1);
+
+    if (step > m_NumSteps)
+    {
+        return CVector2(0.0f, 0.0f);
+    }
+
+    int sample = (trajectory * (m_NumSteps + 1)) + step;
+
+    return CVector2((m_pX[sample] - m_pX[sample - 1]) / m_Timestep,
+                    (m_pY[sample] - m_pY[sample - 1]) / m_Timestep);
+}
@@ -0,0 +1,80 @@
+//
+// A table of precomputed target paths, for studies that fly many missile
+// configurations against the same targets.
+//
+// Generate() moves the targets of a world restarted from some seed on
+// their automatic random paths, and records where each one is after every
+// timestep. Trajectory i is the path that the target of pair i takes in a
+// world restarted from GetFirstSeed(), so a table stands in exactly for
+// the automatic targets of such a world. Once generated, a table can be
+// saved to a file and loaded back as many times as needed, so the cost of
+// moving the targets is paid once rather than once per configuration.
+//
+// The file holds each trajectory's start position, followed by the
+// distance moved each timestep as a pair of 16 bit counts of
+// TargetTrajectoryQuantum. Positions are rounded to that quantum when the
+// table is generated, so a loaded table plays back exactly the same
+// positions as the one that was saved.
+//
+// Attach a table to a world with CWorld::SetTargetTrajectories(). A table
+// is only read while it's played back, so any number of worlds on any
+// number of threads can share one.
+//
+
+#ifndef CTARGETTRAJECTORYTABLE_H
+#define CTARGETTRAJECTORYTABLE_H
+
+#include "CVector2.h"
+
+class CConfig;
+
+// Header at the start of the file
+struct STargetTrajectoryFileHeader
+{
+    char            m_Magic[4];                     // Always "TTRJ"
+    DWORD           m_Version;                      // TargetTrajectoryFileVersion
+    DWORD           m_NumTrajectories;
+    DWORD           m_NumSteps;                     // Timesteps in each trajectory, after its start position
+    float           m_Timestep;                     // In seconds
+    DWORD           m_FirstSeed;                    // Random seed of the world that trajectory 0 came from
+    float           m_Quantum;                      // Size of one count of movement, in world units
+};
+
+class CTargetTrajectoryTable
+{
+public:
+    CTargetTrajectoryTable();
+    ~CTargetTrajectoryTable()                                   { Free(); }
+
+    void            Generate(const CConfig *config, float target_max_speed, unsigned long first_seed, int num_trajectories, float timestep, int num_steps);
+
+    bool            Save(const char *filename) const;
+    bool            Load(const char *filename);
+
+    int             GetNumTrajectories() const                  { return m_NumTrajectories; }
+    int             GetNumSteps() const                         { return m_NumSteps; }
+    float           GetTimestep() const                         { return m_Timestep; }
+    unsigned long   GetFirstSeed() const                        { return m_FirstSeed; }
+
+    CVector2        GetPosition(int trajectory, double time) const;
+    CVector2        GetVelocity(int trajectory, double time) const;
+
+private:
+    // Not copyable, since we own our arrays
+    CTargetTrajectoryTable(const CTargetTrajectoryTable &table);
+    CTargetTrajectoryTable& operator=(const CTargetTrajectoryTable &table);
+
+    void            Allocate(int num_trajectories, int num_steps);
+    void            Free();
+
+    int             GetSampleIndex(int trajectory, double time, float *fraction) const;
+
+    float*          m_pX;                           // x coordinate of each sample, one trajectory after another
+    float*          m_pY;                           // y coordinate of each sample
+    int             m_NumTrajectories;
+    int             m_NumSteps;                     // Each trajectory has one more sample than this
+    float           m_Timestep;
+    unsigned long   m_FirstSeed;
+};
+
+#endif
@@ -0,0 +1,193 @@
+//
+// Class to record the state of a missile's steering every timestep, for
+// looking at after the fact instead of printing it out with TRACE.
+//
+// Records are a fixed size and are copied into a ring buffer by Record(),
+// which never blocks or allocates: if the buffer is full the record is
+// dropped and counted. A background thread started by Start() drains the
+// ring buffer to a trace file (see CTraceFile.h) with one column per field,
+// and Stop() writes out whatever is left and closes the file.
+//
+
+#include "stdafx.h"
+#include "process.h"
+#include "CTelemetryRecorder.h"
+
+//
+// Tuning constants
+//
+
+const DWORD TelemetryWriterSleepMilliseconds    = 50;   // How long our writer thread waits for new records before checking again
+const int   TelemetryMinRingBufferSize          = 64;   // Smallest ring buffer we'll allocate, in records
+
+// Names of the columns in our trace file. The order here must match the
+// order of the fields in STelemetryRecord.
+static const char * const TelemetryColumnName[NUM_TELEMETRY_COLUMNS] =
+{
+    "time",
+    "timestep",
+    "heading_error",
+    "model_behavior_value",
+    "actual_behavior_value",
+    "p_coefficient",
+    "i_coefficient",
+    "d_coefficient",
+    "error",
+    "error_integral",
+    "error_derivative",
+    "output",
+    "position_x",
+    "position_y",
+    "speed",
+    "angular_velocity",
+};
+
+CTelemetryRecorder::CTelemetryRecorder()
+{
+    m_Buffer            = NULL;
+    m_IndexMask         = 0;
+    m_WriteIndex        = 0;
+    m_ReadIndex         = 0;
+    m_BlockWhenFull     = false;
+    m_StopRequested     = false;
+    m_WriterThread      = NULL;
+    m_WakeEvent         = NULL;
+    m_NumRecordsWritten = 0;
+    m_NumRecordsDropped = 0;
+}
+
+//
+// Open filename and start our writer thread. ring_buffer_size is the number
+// of records we can hold before we start dropping them, and is rounded up
+// to a power of 2. If compress is set, columns are compressed wherever that
+// makes them smaller.
+//
+
+bool CTelemetryRecorder::Start(const char *filename, int ring_buffer_size, bool compress)
+{
+    Stop();
+
+    if (!m_TraceWriter.Open(filename, NUM_TELEMETRY_COLUMNS, TelemetryColumnName, compress))
+    {
+        TRACE("Unable to open telemetry file %s\n", filename);
+
+        return false;
+    }
+
+    int buffer_size = TelemetryMinRingBufferSize;
+
+    while (buffer_size < ring_buffer_size)
+    {
+        buffer_size *= 2;
+    }
+
+    m_Buffer            = new STelemetryRecord[buffer_size];
+    m_IndexMask         = buffer_size - 1;
+    m_WriteIndex        = 0;
+    m_ReadIndex         = 0;
+    m_NumRecordsWritten = 0;
+    m_NumRecordsDropped = 0;
+    m_StopRequested     = false;
+
+    m_WakeEvent         = CreateEvent(NULL, FALSE, FALSE, NULL);
+    m_WriterThread      = (HANDLE)_beginthreadex(NULL, 0, WriterThread, this, 0, NULL);
+
+    if (!m_WriterThread)
+    {
+        TRACE("Unable to start telemetry writer thread\n");
+
+        Stop();
+
+        return false;
+    }
+
+    return true;
+}
+
+//
+// Wait for our writer thread to write out everything that's been
+// recorded so far, then close our file
+//
+
+void CTelemetryRecorder::Stop()
+{
+    if (m_WriterThread)
+    {
+        m_StopRequested = true;
+
+        SetEvent(m_WakeEvent);
+        WaitForSingleObject(m_WriterThread, INFINITE);
+        CloseHandle(m_WriterThread);
+
+        m_WriterThread = NULL;
+    }
+
+    if (m_WakeEvent)
+    {
+        CloseHandle(m_WakeEvent);
+
+        m_WakeEvent = NULL;
+    }
+
+    if (m_TraceWriter.IsOpen())
+    {
+        TRACE("Telemetry: %lu records written, %lu dropped\n", m_NumRecordsWritten, m_NumRecordsDropped);
+
+        m_TraceWriter.Close();
+    }
+
+    delete [] m_Buffer;
+
+    m_Buffer    = NULL;
+    m_IndexMask = 0;
+}
+
+//
+// Our writer thread: keep writing out records until we're asked to stop,
+// then write out any that are left
+//
+
+unsigned __stdcall CTelemetryRecorder::WriterThread(void *recorder)
+{
+    CTelemetryRecorder *telemetry_recorder = (CTelemetryRecorder *)recorder;
+
+    while (!telemetry_recorder->m_StopRequested)
+    {
+        WaitForSingleObject(telemetry_recorder->m_WakeEvent, TelemetryWriterSleepMilliseconds);
+
+        telemetry_recorder->WriteRecords();
+    }
+
+    telemetry_recorder->WriteRecords();
+
+    return 0;
+}
+
+//
+// Write out every record that's currently in the ring buffer. Only called
+// from our writer thread.
+//
+
+void CTelemetryRecorder::WriteRecords()
+{
+    LONG read_index     = m_ReadIndex;
+    LONG write_index    = m_WriteIndex;
+
+    // Don't read any records until we've seen the index that says they're there
+
+    _ReadWriteBarrier();
+
+    while (read_index != write_index)
+    {
+        m_TraceWriter.AddRow((const float *)&m_Buffer[read_index & m_IndexMask]);
+
+        read_index++;
+        m_NumRecordsWritten++;
+    }
+
+    // Don't let Record() reuse the slots until we've finished reading them
+
+    _ReadWriteBarrier();
+
+    m_ReadIndex = read_index;
+}
@@ -0,0 +1,131 @@
+//
+// Class to record the state of a missile's steering every timestep, for
+// looking at after the fact instead of printing it out with TRACE.
+//
+// Records are a fixed size and are copied into a ring buffer by Record(),
+// which never blocks or allocates: if the buffer is full the record is
+// dropped and counted. A background thread started by Start() drains the
+// ring buffer to a trace file (see CTraceFile.h) with one column per field,
+// and Stop() writes out whatever is left and closes the file.
+//
+// The ring buffer is lock-free, but only for a single thread calling
+// Record() and our single writer thread reading from it. Record() can
+// optionally wait for room instead of dropping records.
+//
+
+#ifndef CTELEMETRYRECORDER_H
+#define CTELEMETRYRECORDER_H
+
+#include "CModelReferenceAdaptiveController.h"
+#include "CTraceFile.h"
+
+// Compiler-only memory barrier, used to publish records to our writer thread
+extern "C" void _ReadWriteBarrier();
+#pragma intrinsic(_ReadWriteBarrier)
+
+// One timestep's worth of telemetry. Padded out to 64 bytes so that
+// records never straddle a cache line. Every field is a float, so that
+// each one can be written out as a column of our trace file.
+struct STelemetryRecord
+{
+    float   m_Time;                                     // Total simulated time elapsed, in seconds
+    float   m_Timestep;                                 // Length of this timestep, in seconds
+
+    float   m_HeadingError;                             // Process error, in degrees
+    float   m_ModelBehaviorValue;                       // What our model wanted the heading error derivative to be
+    float   m_ActualBehaviorValue;                      // What the heading error derivative actually was
+
+    float   m_Coefficient[NUM_PID_COEFFICIENTS];        // Current P, I and D coefficients
+    float   m_TermValue[NUM_PID_COEFFICIENTS];          // Current error, integral and derivative
+    float   m_Output;                                   // Output of the PID controller
+
+    float   m_PositionX;                                // Missile position, in world units
+    float   m_PositionY;
+    float   m_Speed;                                    // Missile speed, in world units/s
+    float   m_AngularVelocity;                          // Missile angular velocity, in degrees/s
+};
+
+#define NUM_TELEMETRY_COLUMNS (sizeof(STelemetryRecord) / sizeof(float))
+
+class CTelemetryRecorder
+{
+public:
+    CTelemetryRecorder();
+    ~CTelemetryRecorder()                               { Stop(); }
+
+    bool            Start(const char *filename, int ring_buffer_size, bool compress);
+    void            Stop();
+    bool            IsRecording()                       { return (m_Buffer != NULL); }
+
+    void            SetBlockWhenFull(bool block_when_full)  { m_BlockWhenFull = block_when_full; }
+
+    //
+    // Copy one record into the ring buffer. Returns false if the buffer was
+    // full and the record was dropped. Inline because it's called every
+    // timestep, and it only has to copy 64 bytes and publish a new index.
+    //
+    // If SetBlockWhenFull(true) has been called, we wait for room instead
+    // of dropping the record. That's for when the world is being simulated
+    // as fast as possible, such as when replaying a journal, and every
+    // record matters more than how long it takes.
+    //
+
+    bool            Record(const STelemetryRecord &record)
+    {
+        LONG write_index = m_WriteIndex;
+
+        while ((unsigned long)(write_index - m_ReadIndex) > m_IndexMask)
+        {
+            if (!m_BlockWhenFull)
+            {
+                m_NumRecordsDropped++;
+
+                return false;
+            }
+
+            // Wake our writer thread up and give it a chance to make room
+
+            SetEvent(m_WakeEvent);
+            Sleep(0);
+        }
+
+        m_Buffer[write_index & m_IndexMask] = record;
+
+        // The record has to be in the buffer before the writer thread can
+        // see the new index. x86 doesn't reorder stores, so all we need is
+        // to stop the compiler from doing it.
+
+        _ReadWriteBarrier();
+
+        m_WriteIndex = write_index + 1;
+
+        return true;
+    }
+
+    unsigned long   GetNumRecordsWritten()              { return m_NumRecordsWritten; }
+    unsigned long   GetNumRecordsDropped()              { return m_NumRecordsDropped; }
+
+private:
+    static unsigned __stdcall   WriterThread(void *recorder);
+
+    void            WriteRecords();
+
+    STelemetryRecord*   m_Buffer;                       // Our ring buffer. Its size is always a power of 2.
+    unsigned long       m_IndexMask;                    // Size of m_Buffer - 1, used to wrap our indices around
+
+    volatile LONG       m_WriteIndex;                   // Number of records that have been put into the buffer. Only changed by Record().
+    volatile LONG       m_ReadIndex;                    // Number of records that have been written out. Only changed by our writer thread.
+
+    bool                m_BlockWhenFull;                // Should Record() wait for room rather than drop records?
+
+    volatile bool       m_StopRequested;                // Set when our writer thread should finish up
+    HANDLE              m_WriterThread;                 // Our writer thread
+    HANDLE              m_WakeEvent;                    // Signalled to make our writer thread check for new records right away
+
+    CTraceWriter        m_TraceWriter;                  // The file we're writing to
+
+    unsigned long       m_NumRecordsWritten;            // Number of records written out so far
+    unsigned long       m_NumRecordsDropped;            // Number of records dropped because the buffer was full
+};
+
+#endif
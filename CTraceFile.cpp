@@ -0,0 +1,734 @@
+//
+// Classes to write and read simulation traces in a chunked, columnar format.
+//
+// The file is laid out like this:
+//
+//      STraceFileHeader
+//      STraceChunkHeader for chunk 0
+//      Data for column 0 of chunk 0
+//      Data for column 1 of chunk 0
+//      ...
+//      STraceChunkHeader for chunk 1
+//      ...
+//
+// Each chunk header says how big the chunk is, so a reader can find all of
+// the chunks by hopping from header to header without reading any column
+// data. There's no index at the end of the file, so a trace that was cut off
+// part way through is still readable up to its last complete chunk.
+//
+// Compressed columns use eTRACE_ENCODING_XOR_DELTA: each value's bits are
+// XORed with the previous value's bits. Values that change slowly share
+// their sign, exponent and top bits of mantissa with the previous value, so
+// the result has some number of leading zero bytes. We write out one byte
+// holding that number, followed by the remaining low bytes.
+//
+
+#include "stdafx.h"
+#include "float.h"
+#include "CTraceFile.h"
+
+const DWORD TraceFileVersion            = 1;
+
+const int   TraceMaxEncodedValueSize    = sizeof(float) + 1;   // Largest size of one value with eTRACE_ENCODING_XOR_DELTA
+
+//
+// Compress num_values values into encoded_data. Returns the number of
+// bytes written.
+//
+
+static DWORD EncodeXorDelta(const float *values, int num_values, BYTE *encoded_data)
+{
+    const DWORD*    value_bits          = (const DWORD *)values;
+    DWORD           previous_value_bits = 0;
+    BYTE*           current_byte        = encoded_data;
+
+    for (int i = 0; i < num_values; i++)
+    {
+        DWORD difference            = value_bits[i] ^ previous_value_bits;
+        int   num_leading_zeroes    = 0;
+
+        while ((num_leading_zeroes < (int)sizeof(DWORD)) && ((difference >> ((sizeof(DWORD) - 1 - num_leading_zeroes) * 8)) & 0xFF) == 0)
+        {
+            num_leading_zeroes++;
+        }
+
+        *current_byte++ = (BYTE)num_leading_zeroes;
+
+        for (int j = 0; j < (int)sizeof(DWORD) - num_leading_zeroes; j++)
+        {
+            *current_byte++ = (BYTE)(difference >> (j * 8));
+        }
+
+        previous_value_bits = value_bits[i];
+    }
+
+    return (DWORD)(current_byte - encoded_data);
+}
+
+//
+// Decompress num_values values that were compressed with EncodeXorDelta()
+// into encoded_size bytes. Never reads past the end of encoded_data; if it
+// runs out, the values it couldn't decode are set to zero and we return false.
+//
+
+static bool DecodeXorDelta(const BYTE *encoded_data, DWORD encoded_size, int num_values, float *values)
+{
+    DWORD*      value_bits          = (DWORD *)values;
+    DWORD       previous_value_bits = 0;
+    const BYTE* current_byte        = encoded_data;
+    const BYTE* end_byte            = encoded_data + encoded_size;
+    int         i                   = 0;
+
+    for (i = 0; i < num_values; i++)
+    {
+        if (current_byte >= end_byte)
+        {
+            break;
+        }
+
+        int     num_leading_zeroes  = *current_byte++;
+        int     num_bytes           = (int)sizeof(DWORD) - min(num_leading_zeroes, (int)sizeof(DWORD));
+        DWORD   difference          = 0;
+
+        if ((end_byte - current_byte) < num_bytes)
+        {
+            break;
+        }
+
+        for (int j = 0; j < num_bytes; j++)
+        {
+            difference |= ((DWORD)*current_byte++) << (j * 8);
+        }
+
+        value_bits[i]       = difference ^ previous_value_bits;
+        previous_value_bits = value_bits[i];
+    }
+
+    if (i < num_values)
+    {
+        memset(&values[i], 0, (num_values - i) * sizeof(float));
+
+        return false;
+    }
+
+    return true;
+}
+
+//
+// Returns true if the chunk whose header is at offset in data, of file_size
+// bytes, has no more rows than we allow and the data of each of its
+// num_columns columns lies within it
+//
+
+static bool IsChunkIntact(const BYTE *data, DWORD file_size, DWORD offset, int num_columns)
+{
+    const STraceChunkHeader* chunk_header = (const STraceChunkHeader *)(data + offset);
+
+    if ((memcmp(chunk_header->m_Magic, "CHNK", sizeof(chunk_header->m_Magic)) != 0) ||
+        (chunk_header->m_Size < sizeof(STraceChunkHeader)) || (chunk_header->m_Size > (file_size - offset)) ||
+        (chunk_header->m_NumRows > TRACE_CHUNK_NUM_ROWS))
+    {
+        return false;
+    }
+
+    DWORD data_start    = offset + sizeof(STraceChunkHeader);
+    DWORD data_end      = offset + chunk_header->m_Size;
+
+    for (int i = 0; i < num_columns; i++)
+    {
+        const STraceColumnHeader* column_header = &chunk_header->m_Column[i];
+
+        if ((column_header->m_Offset < data_start) || (column_header->m_Offset > data_end) ||
+            (column_header->m_Size > (data_end - column_header->m_Offset)))
+        {
+            return false;
+        }
+
+        if ((column_header->m_Encoding == eTRACE_ENCODING_RAW) && (column_header->m_Size < (chunk_header->m_NumRows * sizeof(float))))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//////////////////////////////////////////////
+// CTraceWriter
+//////////////////////////////////////////////
+
+CTraceWriter::CTraceWriter()
+{
+    m_File              = NULL;
+    m_NumColumns        = 0;
+    m_Compress          = false;
+    m_ChunkValues       = NULL;
+    m_EncodedColumn     = NULL;
+    m_NumRowsInChunk    = 0;
+    m_FileOffset        = 0;
+    m_NumRowsWritten    = 0;
+}
+
+//
+// Create filename, with num_columns columns named column_name[0] to
+// column_name[num_columns - 1]
+//
+
+bool CTraceWriter::Open(const char *filename, int num_columns, const char * const *column_name, bool compress)
+{
+    ASSERT((num_columns > 0) && (num_columns <= TRACE_MAX_COLUMNS));
+
+    Close();
+
+    m_File = fopen(filename, "wb");
+
+    if (!m_File)
+    {
+        TRACE("Unable to open trace file %s\n", filename);
+
+        return false;
+    }
+
+    STraceFileHeader header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_Magic, "TRCE", sizeof(header.m_Magic));
+    header.m_Version    = TraceFileVersion;
+    header.m_NumColumns = num_columns;
+
+    for (int i = 0; i < num_columns; i++)
+    {
+        strncpy(header.m_ColumnName[i], column_name[i], TRACE_MAX_COLUMN_NAME_LENGTH - 1);
+    }
+
+    fwrite(&header, sizeof(header), 1, m_File);
+
+    m_NumColumns        = num_columns;
+    m_Compress          = compress;
+    m_ChunkValues       = new float[num_columns * TRACE_CHUNK_NUM_ROWS];
+    m_EncodedColumn     = compress ? new BYTE[TraceMaxEncodedValueSize * TRACE_CHUNK_NUM_ROWS] : NULL;
+    m_NumRowsInChunk    = 0;
+    m_FileOffset        = sizeof(header);
+    m_NumRowsWritten    = 0;
+
+    return true;
+}
+
+//
+// Write out any rows that haven't been written yet, and close the file
+//
+
+void CTraceWriter::Close()
+{
+    if (m_File)
+    {
+        WriteChunk();
+
+        fclose(m_File);
+
+        m_File = NULL;
+    }
+
+    delete [] m_ChunkValues;
+    delete [] m_EncodedColumn;
+
+    m_ChunkValues   = NULL;
+    m_EncodedColumn = NULL;
+}
+
+//
+// Add one row. values must hold one value for each of our columns.
+//
+
+void CTraceWriter::AddRow(const float *values)
+{
+    ASSERT(m_File);
+
+    for (int i = 0; i < m_NumColumns; i++)
+    {
+        m_ChunkValues[(i * TRACE_CHUNK_NUM_ROWS) + m_NumRowsInChunk] = values[i];
+    }
+
+    m_NumRowsInChunk++;
+
+    if (m_NumRowsInChunk == TRACE_CHUNK_NUM_ROWS)
+    {
+        WriteChunk();
+    }
+}
+
+//
+// Write out the rows we've collected so far as one chunk. Its header is
+// written last, so that a chunk that didn't get finished has no valid header.
+//
+
+void CTraceWriter::WriteChunk()
+{
+    if (m_NumRowsInChunk == 0)
+    {
+        return;
+    }
+
+    STraceChunkHeader chunk_header;
+
+    memset(&chunk_header, 0, sizeof(chunk_header));
+
+    DWORD chunk_offset  = m_FileOffset;
+    DWORD data_offset   = chunk_offset + sizeof(chunk_header);
+
+    fwrite(&chunk_header, sizeof(chunk_header), 1, m_File);
+
+    for (int i = 0; i < m_NumColumns; i++)
+    {
+        const float*        values          = &m_ChunkValues[i * TRACE_CHUNK_NUM_ROWS];
+        STraceColumnHeader* column_header   = &chunk_header.m_Column[i];
+
+        // Find this column's range, ignoring NaNs
+
+        column_header->m_MinValue = FLT_MAX;
+        column_header->m_MaxValue = -FLT_MAX;
+
+        for (int j = 0; j < m_NumRowsInChunk; j++)
+        {
+            if (values[j] == values[j])
+            {
+                column_header->m_MinValue = min(column_header->m_MinValue, values[j]);
+                column_header->m_MaxValue = max(column_header->m_MaxValue, values[j]);
+            }
+        }
+
+        // Store the column compressed if we've been asked to and if it helps
+
+        DWORD raw_size      = m_NumRowsInChunk * sizeof(float);
+        DWORD encoded_size  = m_Compress ? EncodeXorDelta(values, m_NumRowsInChunk, m_EncodedColumn) : raw_size;
+
+        if (encoded_size < raw_size)
+        {
+            column_header->m_Encoding   = eTRACE_ENCODING_XOR_DELTA;
+            column_header->m_Size       = encoded_size;
+
+            fwrite(m_EncodedColumn, encoded_size, 1, m_File);
+        }
+        else
+        {
+            column_header->m_Encoding   = eTRACE_ENCODING_RAW;
+            column_header->m_Size       = raw_size;
+
+            fwrite(values, raw_size, 1, m_File);
+        }
+
+        column_header->m_Offset = data_offset;
+        data_offset             += column_header->m_Size;
+    }
+
+    // Now we can go back and fill in the chunk header
+
+    memcpy(chunk_header.m_Magic, "CHNK", sizeof(chunk_header.m_Magic));
+    chunk_header.m_NumRows  = m_NumRowsInChunk;
+    chunk_header.m_Size     = data_offset - chunk_offset;
+
+    fseek(m_File, chunk_offset, SEEK_SET);
+    fwrite(&chunk_header, sizeof(chunk_header), 1, m_File);
+    fseek(m_File, data_offset, SEEK_SET);
+
+    m_FileOffset        = data_offset;
+    m_NumRowsWritten    += m_NumRowsInChunk;
+    m_NumRowsInChunk    = 0;
+}
+
+//////////////////////////////////////////////
+// CTraceReader
+//////////////////////////////////////////////
+
+CTraceReader::CTraceReader()
+{
+    m_File          = INVALID_HANDLE_VALUE;
+    m_FileMapping   = NULL;
+    m_pData         = NULL;
+    m_FileSize      = 0;
+    m_NumColumns    = 0;
+    m_ChunkOffset   = NULL;
+    m_NumChunks     = 0;
+    m_NumRows       = 0;
+}
+
+//
+// Map filename into memory and find all of its chunks
+//
+
+bool CTraceReader::Open(const char *filename)
+{
+    Close();
+
+    m_File = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (m_File == INVALID_HANDLE_VALUE)
+    {
+        TRACE("Unable to open trace file %s\n", filename);
+
+        return false;
+    }
+
+    m_FileSize = GetFileSize(m_File, NULL);
+
+    if (m_FileSize < sizeof(STraceFileHeader))
+    {
+        TRACE("Trace file %s is too small\n", filename);
+
+        Close();
+
+        return false;
+    }
+
+    m_FileMapping   = CreateFileMapping(m_File, NULL, PAGE_READONLY, 0, 0, NULL);
+    m_pData         = m_FileMapping ? (const BYTE *)MapViewOfFile(m_FileMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+    if (!m_pData)
+    {
+        TRACE("Unable to map trace file %s\n", filename);
+
+        Close();
+
+        return false;
+    }
+
+    const STraceFileHeader* header = (const STraceFileHeader *)m_pData;
+
+    if ((memcmp(header->m_Magic, "TRCE", sizeof(header->m_Magic)) != 0) ||
+        (header->m_Version != TraceFileVersion)                        ||
+        (header->m_NumColumns == 0) || (header->m_NumColumns > TRACE_MAX_COLUMNS))
+    {
+        TRACE("%s is not a trace file we can read\n", filename);
+
+        Close();
+
+        return false;
+    }
+
+    m_NumColumns = header->m_NumColumns;
+
+    memcpy(m_ColumnName, header->m_ColumnName, sizeof(m_ColumnName));
+
+    // Hop through the chunk headers twice: once to count them,
+    // and once to remember where they are
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        DWORD offset = sizeof(STraceFileHeader);
+
+        m_NumChunks = 0;
+        m_NumRows   = 0;
+
+        while ((offset + sizeof(STraceChunkHeader)) <= m_FileSize)
+        {
+            const STraceChunkHeader* chunk_header = (const STraceChunkHeader *)(m_pData + offset);
+
+            if (!IsChunkIntact(m_pData, m_FileSize, offset, m_NumColumns))
+            {
+                // The trace was cut off part way through this chunk, or
+                // it's been damaged, so treat it as the end of the trace
+                break;
+            }
+
+            if (m_ChunkOffset)
+            {
+                m_ChunkOffset[m_NumChunks] = offset;
+            }
+
+            m_NumChunks++;
+            m_NumRows   += chunk_header->m_NumRows;
+            offset      += chunk_header->m_Size;
+        }
+
+        if (!m_ChunkOffset)
+        {
+            m_ChunkOffset = new DWORD[max(m_NumChunks, 1)];
+        }
+    }
+
+    return true;
+}
+
+//
+// Unmap and close our file
+//
+
+void CTraceReader::Close()
+{
+    if (m_pData)
+    {
+        UnmapViewOfFile(m_pData);
+
+        m_pData = NULL;
+    }
+
+    if (m_FileMapping)
+    {
+        CloseHandle(m_FileMapping);
+
+        m_FileMapping = NULL;
+    }
+
+    if (m_File != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_File);
+
+        m_File = INVALID_HANDLE_VALUE;
+    }
+
+    delete [] m_ChunkOffset;
+
+    m_ChunkOffset   = NULL;
+    m_NumChunks     = 0;
+    m_NumRows       = 0;
+    m_NumColumns    = 0;
+    m_FileSize      = 0;
+}
+
+const char *CTraceReader::GetColumnName(int column)
+{
+    ASSERT((column >= 0) && (column < m_NumColumns));
+
+    return m_ColumnName[column];
+}
+
+//
+// Returns the index of the column called column_name, or -1 if there isn't one
+//
+
+int CTraceReader::FindColumn(const char *column_name)
+{
+    for (int i = 0; i < m_NumColumns; i++)
+    {
+        if (strncmp(m_ColumnName[i], column_name, TRACE_MAX_COLUMN_NAME_LENGTH) == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+const STraceChunkHeader *CTraceReader::GetChunkHeader(int chunk)
+{
+    ASSERT((chunk >= 0) && (chunk < m_NumChunks));
+
+    return (const STraceChunkHeader *)(m_pData + m_ChunkOffset[chunk]);
+}
+
+int CTraceReader::GetChunkNumRows(int chunk)
+{
+    return GetChunkHeader(chunk)->m_NumRows;
+}
+
+//
+// Gets the smallest and largest values of one column in one chunk,
+// without reading any of the column's data
+//
+
+void CTraceReader::GetChunkRange(int chunk, int column, float *min_value, float *max_value)
+{
+    ASSERT((column >= 0) && (column < m_NumColumns));
+
+    const STraceColumnHeader* column_header = &GetChunkHeader(chunk)->m_Column[column];
+
+    *min_value = column_header->m_MinValue;
+    *max_value = column_header->m_MaxValue;
+}
+
+//
+// Read every value of one column in one chunk into values, which must have
+// room for GetChunkNumRows(chunk) values
+//
+
+void CTraceReader::ReadChunkColumn(int chunk, int column, float *values)
+{
+    ASSERT((column >= 0) && (column < m_NumColumns));
+
+    const STraceChunkHeader*    chunk_header    = GetChunkHeader(chunk);
+    const STraceColumnHeader*   column_header   = &chunk_header->m_Column[column];
+    const BYTE*                 column_data     = m_pData + column_header->m_Offset;
+
+    switch (column_header->m_Encoding)
+    {
+        case eTRACE_ENCODING_RAW:
+        {
+            memcpy(values, column_data, chunk_header->m_NumRows * sizeof(float));
+
+            break;
+        }
+
+        case eTRACE_ENCODING_XOR_DELTA:
+        {
+            if (!DecodeXorDelta(column_data, column_header->m_Size, chunk_header->m_NumRows, values))
+            {
+                TRACE("Column %d of trace chunk %d is shorter than its rows\n", column, chunk);
+            }
+
+            break;
+        }
+
+        default:
+        {
+            TRACE("Unknown trace encoding %d\n", column_header->m_Encoding);
+
+            memset(values, 0, chunk_header->m_NumRows * sizeof(float));
+
+            break;
+        }
+    }
+}
+
+//
+// Gets the smallest and largest values in a whole column. Only the chunk
+// headers are read. Returns false if there are no values.
+//
+
+bool CTraceReader::GetColumnRange(int column, float *min_value, float *max_value)
+{
+    *min_value = FLT_MAX;
+    *max_value = -FLT_MAX;
+
+    for (int i = 0; i < m_NumChunks; i++)
+    {
+        float chunk_min_value;
+        float chunk_max_value;
+
+        GetChunkRange(i, column, &chunk_min_value, &chunk_max_value);
+
+        *min_value = min(*min_value, chunk_min_value);
+        *max_value = max(*max_value, chunk_max_value);
+    }
+
+    return (*min_value <= *max_value);
+}
+
+//
+// Average of every value in a column
+//
+
+double CTraceReader::GetColumnMean(int column)
+{
+    if (m_NumRows == 0)
+    {
+        return 0.0;
+    }
+
+    float*  values  = new float[TRACE_CHUNK_NUM_ROWS];
+    double  total   = 0.0;
+
+    for (int i = 0; i < m_NumChunks; i++)
+    {
+        int num_rows = GetChunkNumRows(i);
+
+        ReadChunkColumn(i, column, values);
+
+        for (int j = 0; j < num_rows; j++)
+        {
+            total += values[j];
+        }
+    }
+
+    delete [] values;
+
+    return (total / (double)m_NumRows);
+}
+
+//
+// Count the values in a column that are larger than threshold. Chunks
+// that are entirely above or below threshold are counted from their
+// headers alone.
+//
+
+unsigned long CTraceReader::CountValuesAbove(int column, float threshold)
+{
+    float*          values      = NULL;
+    unsigned long   num_values  = 0;
+
+    for (int i = 0; i < m_NumChunks; i++)
+    {
+        float   chunk_min_value;
+        float   chunk_max_value;
+        int     num_rows = GetChunkNumRows(i);
+
+        GetChunkRange(i, column, &chunk_min_value, &chunk_max_value);
+
+        if (chunk_max_value <= threshold)
+        {
+            continue;
+        }
+
+        if (values == NULL)
+        {
+            values = new float[TRACE_CHUNK_NUM_ROWS];
+        }
+
+        ReadChunkColumn(i, column, values);
+
+        for (int j = 0; j < num_rows; j++)
+        {
+            if (values[j] > threshold)
+            {
+                num_values++;
+            }
+        }
+    }
+
+    delete [] values;
+
+    return num_values;
+}
+
+//
+// Write out the whole trace as comma-separated values, with the
+// column names on the first line
+//
+
+bool CTraceReader::ExportCSV(const char *filename)
+{
+    FILE* csv_file = fopen(filename, "w");
+
+    if (!csv_file)
+    {
+        TRACE("Unable to open CSV file %s\n", filename);
+
+        return false;
+    }
+
+    int i = 0;
+
+    for (i = 0; i < m_NumColumns; i++)
+    {
+        fprintf(csv_file, (i == 0) ? "%s" : ",%s", GetColumnName(i));
+    }
+
+    fprintf(csv_file, "\n");
+
+    float* values = new float[m_NumColumns * TRACE_CHUNK_NUM_ROWS];
+
+    for (int chunk = 0; chunk < m_NumChunks; chunk++)
+    {
+        int num_rows = GetChunkNumRows(chunk);
+
+        for (i = 0; i < m_NumColumns; i++)
+        {
+            ReadChunkColumn(chunk, i, &values[i * TRACE_CHUNK_NUM_ROWS]);
+        }
+
+        for (int row = 0; row < num_rows; row++)
+        {
+            for (i = 0; i < m_NumColumns; i++)
+            {
+                fprintf(csv_file, (i == 0) ? "%.9g" : ",%.9g", values[(i * TRACE_CHUNK_NUM_ROWS) + row]);
+            }
+
+            fprintf(csv_file, "\n");
+        }
+    }
+
+    delete [] values;
+
+    fclose(csv_file);
+
+    return true;
+}
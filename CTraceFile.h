@@ -0,0 +1,134 @@
+//
+// Classes to write and read simulation traces in a chunked, columnar format.
+//
+// A trace is a table of float values with a fixed set of named columns, such
+// as the fields of an STelemetryRecord. Rows are added one at a time with
+// CTraceWriter::AddRow(), and are written out in chunks of TRACE_CHUNK_NUM_ROWS.
+// Within a chunk each column is stored contiguously along with its minimum and
+// maximum values, so a reader can pull out one column, such as the heading
+// error, without touching the bytes of any of the others, and can skip whole
+// chunks based on their range.
+//
+// Columns can optionally be compressed (see CTraceFile.cpp for the encoding).
+// A column is only stored compressed in a chunk if that actually makes it smaller.
+//
+// CTraceReader maps the whole file into memory, so the operating system only
+// reads in the pages of the columns that are asked for.
+//
+
+#ifndef CTRACEFILE_H
+#define CTRACEFILE_H
+
+#define TRACE_CHUNK_NUM_ROWS            65536
+#define TRACE_MAX_COLUMNS               32
+#define TRACE_MAX_COLUMN_NAME_LENGTH    32
+
+// Ways that a column can be stored within a chunk
+enum eTraceEncoding
+{
+    eTRACE_ENCODING_RAW = 0,
+    eTRACE_ENCODING_XOR_DELTA,
+
+    NUM_TRACE_ENCODINGS,
+};
+
+// Header at the start of the file
+struct STraceFileHeader
+{
+    char            m_Magic[4];                                                 // Always "TRCE"
+    DWORD           m_Version;                                                  // TraceFileVersion
+    DWORD           m_NumColumns;
+    char            m_ColumnName[TRACE_MAX_COLUMNS][TRACE_MAX_COLUMN_NAME_LENGTH];
+};
+
+// Describes one column within a chunk
+struct STraceColumnHeader
+{
+    DWORD           m_Encoding;                                                 // An eTraceEncoding
+    DWORD           m_Offset;                                                   // Offset of the column's data from the start of the file
+    DWORD           m_Size;                                                     // Size of the column's data in bytes
+    float           m_MinValue;                                                 // Smallest value in this column in this chunk
+    float           m_MaxValue;                                                 // Largest value in this column in this chunk
+};
+
+// Header at the start of each chunk, followed by the data for each column in order
+struct STraceChunkHeader
+{
+    char            m_Magic[4];                                                 // Always "CHNK"
+    DWORD           m_NumRows;
+    DWORD           m_Size;                                                     // Size of the whole chunk, including this header
+    STraceColumnHeader  m_Column[TRACE_MAX_COLUMNS];
+};
+
+class CTraceWriter
+{
+public:
+    CTraceWriter();
+    ~CTraceWriter()                                                             { Close(); }
+
+    bool            Open(const char *filename, int num_columns, const char * const *column_name, bool compress);
+    void            Close();
+    bool            IsOpen()                                                    { return (m_File != NULL); }
+
+    void            AddRow(const float *values);
+
+    unsigned long   GetNumRowsWritten()                                         { return m_NumRowsWritten; }
+
+private:
+    void            WriteChunk();
+
+    FILE*           m_File;
+    int             m_NumColumns;
+    bool            m_Compress;
+
+    float*          m_ChunkValues;                                              // TRACE_CHUNK_NUM_ROWS rows for each column, one column after another
+    BYTE*           m_EncodedColumn;                                            // Scratch space for compressing one column
+    int             m_NumRowsInChunk;
+
+    DWORD           m_FileOffset;                                               // Where the next chunk will be written
+    unsigned long   m_NumRowsWritten;
+};
+
+class CTraceReader
+{
+public:
+    CTraceReader();
+    ~CTraceReader()                                                             { Close(); }
+
+    bool            Open(const char *filename);
+    void            Close();
+
+    int             GetNumColumns()                                             { return m_NumColumns; }
+    const char*     GetColumnName(int column);
+    int             FindColumn(const char *column_name);
+
+    unsigned long   GetNumRows()                                                { return m_NumRows; }
+    int             GetNumChunks()                                              { return m_NumChunks; }
+    int             GetChunkNumRows(int chunk);
+    void            GetChunkRange(int chunk, int column, float *min_value, float *max_value);
+
+    void            ReadChunkColumn(int chunk, int column, float *values);
+
+    bool            GetColumnRange(int column, float *min_value, float *max_value);
+    double          GetColumnMean(int column);
+    unsigned long   CountValuesAbove(int column, float threshold);
+
+    bool            ExportCSV(const char *filename);
+
+private:
+    const STraceChunkHeader*    GetChunkHeader(int chunk);
+
+    HANDLE          m_File;
+    HANDLE          m_FileMapping;
+    const BYTE*     m_pData;                                                    // The whole file, mapped into memory
+    DWORD           m_FileSize;
+
+    int             m_NumColumns;
+    char            m_ColumnName[TRACE_MAX_COLUMNS][TRACE_MAX_COLUMN_NAME_LENGTH];
+
+    DWORD*          m_ChunkOffset;                                              // Offset of each chunk's header from the start of the file
+    int             m_NumChunks;
+    unsigned long   m_NumRows;
+};
+
+#endif
@@ -1,175 +1,364 @@
-//
-// Simple 2D vector class
-//
-
-#include "stdafx.h"
-#include "math.h"
-#include "CVector2.h"
-
-#define PI 3.14159265f
-
-#define RAD2DEG(x) ((x) * 180.0f / PI)  // Convert radians to degrees
-#define DEG2RAD(x) ((x) * PI / 180.0f)  // Convert degrees to radians
-
-CVector2::CVector2(float initial_x, float initial_y) : x(initial_x), y(initial_y)
-{
-
-}
-
-CVector2 CVector2::operator+(const CVector2 &v1)
-{
-    CVector2 v2(x + v1.x, y + v1.y);
-
-    return v2;
-}
-
-CVector2 &CVector2::operator+=(const CVector2 &v1)
-{
-    x += v1.x;
-    y += v1.y;
-
-    return *this;
-}
-
-CVector2 CVector2::operator-(const CVector2 &v1)
-{
-    CVector2 v2(x - v1.x, y - v1.y);
-
-    return v2;
-}
-
-CVector2 CVector2::operator-()
-{
-    CVector2 v1(-x, -y);
-
-    return v1;
-}
-
-CVector2 CVector2::operator*(float scale)
-{
-    CVector2 v1(x * scale, y * scale);
-
-    return v1;
-}
-
-CVector2 &CVector2::operator*=(float scale)
-{
-    x *= scale;
-    y *= scale;
-
-    return *this;
-}
-
-float CVector2::GetLength()
-{
-    return (float)sqrt(GetDotProduct(this, this));
-}
-
-//
-// Returns the angle this vector is pointing at, between 0.0 and 359.9 degrees.
-// 0.0 means pointing fully along the x axis. 
-//
-
-float CVector2::GetAngle()
-{
-    return RAD2DEG((float)atan2(x, y));
-}
-
-//
-// Rotate this vector by angle_in_degrees. Positive values are counterclockwise,
-// negative values are clockwise
-//
-
-void CVector2::Rotate(float angle_in_degrees)
-{
-    float angle_in_radians  = DEG2RAD(angle_in_degrees);
-
-    float cosine            = (float)cos(angle_in_radians);
-    float sine              = (float)sin(angle_in_radians);
-
-    float new_x             = (x * cosine)  - (y * sine);
-    float new_y             = (x * sine)    + (y * cosine);
-
-    x                       = new_x;
-    y                       = new_y;
-}
-
-//
-// Make this vector have length new_length
-//
-
-void CVector2::Normalize(float new_length)
-{
-    float current_length = GetLength();
-
-    if (fabs(current_length) > 0.0001f)
-    {
-        float scale = new_length / current_length;
-
-        x *= scale;
-        y *= scale;
-    }
-    else
-    {
-        x = new_length;
-        y = 0.0f;
-    }
-}
-
-//
-// Returns the distance between two position vectors
-//
-
-float GetDistanceBetween(CVector2 *v1, CVector2 *v2)
-{
-    CVector2 difference = *v1 - *v2;
-
-    return difference.GetLength();
-}
-
-//
-// Returns the dot product of two vectors
-//
-
-float GetDotProduct(CVector2 *v1, CVector2 *v2)
-{
-    return (v1->x * v2->x) + (v1->y * v2->y);
-}
-
-//
-// Clamp current_value to be between min_value and max_value
-//
-
-float Clamp(float current_value, float min_value, float max_value)
-{
-    return min(max(current_value, min_value), max_value);
-}
-
-//
-// Return the sign of x
-//
-
-float Sign(float x)
-{
-    if (x > 0.0f)
-    {
-        return 1.0f;
-    }
-    else if (x < 0.0f)
-    {
-        return -1.0f;
-    }
-    else
-    {
-        return 0.0f;
-    }
-}
-
-//
-// Return true if x1 is within some epsilon of x2
-//
-
-bool Equal(float x1, float x2)
-{
-    return (fabs(x1 - x2) < 0.001f);
+//
+// Simple 2D vector class
+//
+// The fast trigonometry functions are polynomials that are accurate to
+// within:
+//
+//      FastAtan2()     1.2e-5 radians (0.0007 degrees)
+//      FastSinCos()    3.7e-6 for the sine, and 9.1e-7 for the cosine
+//
+// which is well under the size of a pixel at the distances we steer over.
+// They have no table lookups, and their only branches just pick between
+// two values, so the loops in the batch functions below can be turned
+// into straight-line code by the compiler.
+//
+
+#include "stdafx.h"
+#include "math.h"
+#include "CVector2.h"
+
+#define PI 3.14159265f
+
+#define RAD2DEG(x) ((x) * 180.0f / PI)  // Convert radians to degrees
+#define DEG2RAD(x) ((x) * PI / 180.0f)  // Convert degrees to radians
+
+//
+// Tuning constants
+//
+
+const float SmallRotationAngle  = 0.25f;    // Largest angle, in radians, that GetRotation() uses its short series for
+
+#ifdef FAST_TRIGONOMETRY
+static bool UseFastTrigonometry = true;
+#else
+static bool UseFastTrigonometry = false;
+#endif
+
+//
+// The fast trigonometry itself, inline so that the batch functions can
+// use it without a call per vector
+//
+
+static inline float InlineFastAtan2(float y, float x)
+{
+    float abs_x     = (float)fabs(x);
+    float abs_y     = (float)fabs(y);
+    float max_value = max(abs_x, abs_y);
+
+    if (max_value == 0.0f)
+    {
+        return 0.0f;
+    }
+
+    // atan() of a ratio between 0 and 1, from Hastings' "Approximations
+    // for Digital Computers", then moved to the right octant
+
+    float ratio     = min(abs_x, abs_y) / max_value;
+    float square    = ratio * ratio;
+    float angle     = ratio * (0.9998660f + square * (-0.3302995f + square * (0.1801410f + square * (-0.0851330f + square * 0.0208351f))));
+
+    if (abs_y > abs_x)
+    {
+        angle = (PI / 2.0f) - angle;
+    }
+
+    if (x < 0.0f)
+    {
+        angle = PI - angle;
+    }
+
+    return (y < 0.0f) ? -angle : angle;
+}
+
+static inline void InlineFastSinCos(float angle_in_radians, float *sine, float *cosine)
+{
+    // Bring the angle into -pi..pi, then fold it into -pi/2..pi/2, where
+    // the Taylor series are accurate enough. Folding flips the sign of
+    // the cosine but not the sine.
+
+    float   turns       = angle_in_radians * (1.0f / (2.0f * PI));
+    int     whole_turns = (int)((turns >= 0.0f) ? (turns + 0.5f) : (turns - 0.5f));
+    float   angle       = angle_in_radians - ((2.0f * PI) * (float)whole_turns);
+    float cosine_sign   = 1.0f;
+
+    if (angle > (PI / 2.0f))
+    {
+        angle       = PI - angle;
+        cosine_sign = -1.0f;
+    }
+    else if (angle < -(PI / 2.0f))
+    {
+        angle       = -PI - angle;
+        cosine_sign = -1.0f;
+    }
+
+    float square    = angle * angle;
+
+    *sine           = angle * (1.0f + square * (-1.0f / 6.0f + square * (1.0f / 120.0f + square * (-1.0f / 5040.0f + square * (1.0f / 362880.0f)))));
+    *cosine         = cosine_sign * (1.0f + square * (-1.0f / 2.0f + square * (1.0f / 24.0f + square * (-1.0f / 720.0f + square * (1.0f / 40320.0f + square * (-1.0f / 3628800.0f))))));
+}
+
+//
+// Returns the angle this vector is pointing at, between 0.0 and 359.9 degrees.
+// 0.0 means pointing fully along the x axis. 
+//
+
+float CVector2::GetAngle() const
+{
+    if (UseFastTrigonometry)
+    {
+        return RAD2DEG(InlineFastAtan2(x, y));
+    }
+
+    return RAD2DEG((float)atan2(x, y));
+}
+
+//
+// Rotate this vector by angle_in_degrees. Positive values are counterclockwise,
+// negative values are clockwise
+//
+
+void CVector2::Rotate(float angle_in_degrees)
+{
+    float angle_in_radians  = DEG2RAD(angle_in_degrees);
+    float cosine;
+    float sine;
+
+    if (UseFastTrigonometry)
+    {
+        InlineFastSinCos(angle_in_radians, &sine, &cosine);
+    }
+    else
+    {
+        cosine              = (float)cos(angle_in_radians);
+        sine                = (float)sin(angle_in_radians);
+    }
+
+    float new_x             = (x * cosine)  - (y * sine);
+    float new_y             = (x * sine)    + (y * cosine);
+
+    x                       = new_x;
+    y                       = new_y;
+}
+
+//
+// Make this vector have length new_length
+//
+
+void CVector2::Normalize(float new_length)
+{
+    float current_length = GetLength();
+
+    if (fabs(current_length) > 0.0001f)
+    {
+        float scale = new_length / current_length;
+
+        x *= scale;
+        y *= scale;
+    }
+    else
+    {
+        x = new_length;
+        y = 0.0f;
+    }
+}
+
+//
+// Save or load our coordinates
+//
+
+void CVector2::Serialize(CArchive &archive)
+{
+    if (archive.IsStoring())
+    {
+        archive << x << y;
+    }
+    else
+    {
+        archive >> x >> y;
+    }
+}
+
+//
+// Same as calling GetAngle() on each of count vectors
+//
+
+void GetAngles(const CVector2 *vectors, float *angles_in_degrees, int count)
+{
+    int i = 0;
+
+    if (UseFastTrigonometry)
+    {
+        for (i = 0; i < count; i++)
+        {
+            angles_in_degrees[i] = RAD2DEG(InlineFastAtan2(vectors[i].x, vectors[i].y));
+        }
+    }
+    else
+    {
+        for (i = 0; i < count; i++)
+        {
+            angles_in_degrees[i] = RAD2DEG((float)atan2(vectors[i].x, vectors[i].y));
+        }
+    }
+}
+
+//
+// Same as calling Rotate() on each of count vectors, by the matching
+// angle in angles_in_degrees
+//
+
+void RotateVectors(CVector2 *vectors, const float *angles_in_degrees, int count)
+{
+    int     i = 0;
+    float   cosine;
+    float   sine;
+
+    if (UseFastTrigonometry)
+    {
+        for (i = 0; i < count; i++)
+        {
+            InlineFastSinCos(DEG2RAD(angles_in_degrees[i]), &sine, &cosine);
+
+            float new_x     = (vectors[i].x * cosine)   - (vectors[i].y * sine);
+            float new_y     = (vectors[i].x * sine)     + (vectors[i].y * cosine);
+
+            vectors[i].x    = new_x;
+            vectors[i].y    = new_y;
+        }
+    }
+    else
+    {
+        for (i = 0; i < count; i++)
+        {
+            cosine          = (float)cos(DEG2RAD(angles_in_degrees[i]));
+            sine            = (float)sin(DEG2RAD(angles_in_degrees[i]));
+
+            float new_x     = (vectors[i].x * cosine)   - (vectors[i].y * sine);
+            float new_y     = (vectors[i].x * sine)     + (vectors[i].y * cosine);
+
+            vectors[i].x    = new_x;
+            vectors[i].y    = new_y;
+        }
+    }
+}
+
+//
+// Choose between the fast trigonometry and the C library's from now on.
+// The default is set by whether the build defines FAST_TRIGONOMETRY.
+//
+
+void SetFastTrigonometry(bool fast_trigonometry)
+{
+    UseFastTrigonometry = fast_trigonometry;
+}
+
+bool GetFastTrigonometry()
+{
+    return UseFastTrigonometry;
+}
+
+//
+// Fast approximations of atan2(y, x), and of sin() and cos() of the same
+// angle, whichever trigonometry is selected. See the top of this file for
+// their accuracy.
+//
+
+float FastAtan2(float y, float x)
+{
+    return InlineFastAtan2(y, x);
+}
+
+void FastSinCos(float angle_in_radians, float *sine, float *cosine)
+{
+    InlineFastSinCos(angle_in_radians, sine, cosine);
+}
+
+//
+// Returns the unit vector that rotates a vector by angle_in_degrees when
+// passed to RotateBy(). Small angles, such as a timestep's worth of
+// turning, use a short series that's as accurate as sin() and cos() are
+// in floats, whichever trigonometry is selected.
+//
+
+CVector2 GetRotation(float angle_in_degrees)
+{
+    float       angle_in_radians    = DEG2RAD(angle_in_degrees);
+    CVector2    rotation;
+
+    if (fabs(angle_in_radians) < SmallRotationAngle)
+    {
+        float square    = angle_in_radians * angle_in_radians;
+
+        rotation.x      = 1.0f + square * (-1.0f / 2.0f + square * (1.0f / 24.0f + square * (-1.0f / 720.0f)));
+        rotation.y      = angle_in_radians * (1.0f + square * (-1.0f / 6.0f + square * (1.0f / 120.0f)));
+    }
+    else if (UseFastTrigonometry)
+    {
+        InlineFastSinCos(angle_in_radians, &rotation.y, &rotation.x);
+    }
+    else
+    {
+        rotation.x      = (float)cos(angle_in_radians);
+        rotation.y      = (float)sin(angle_in_radians);
+    }
+
+    return rotation;
+}
+
+//
+// Returns v1->GetAngle() - v2->GetAngle(), between -180 and 180 degrees,
+// but with one atan2() of their cross and dot products rather than one
+// for each vector, and no wrapping afterwards
+//
+
+float GetAngleBetween(const CVector2 *v1, const CVector2 *v2)
+{
+    float cross_product = GetCrossProduct(v1, v2);
+    float dot_product   = GetDotProduct(v1, v2);
+
+    if (UseFastTrigonometry)
+    {
+        return RAD2DEG(InlineFastAtan2(cross_product, dot_product));
+    }
+
+    return RAD2DEG((float)atan2(cross_product, dot_product));
+}
+
+//
+// Clamp current_value to be between min_value and max_value
+//
+
+float Clamp(float current_value, float min_value, float max_value)
+{
+    return min(max(current_value, min_value), max_value);
+}
+
+//
+// Return the sign of x
+//
+
+float Sign(float x)
+{
+    if (x > 0.0f)
+    {
+        return 1.0f;
+    }
+    else if (x < 0.0f)
+    {
+        return -1.0f;
+    }
+    else
+    {
+        return 0.0f;
+    }
+}
+
+//
+// Return true if x1 is within some epsilon of x2
+//
+
+bool Equal(float x1, float x2)
+{
+    return (fabs(x1 - x2) < 0.001f);
 }
\ No newline at end of file
@@ -1,37 +1,120 @@
-//
-// Simple 2D vector class
-//
-
-#ifndef CVECTOR2_H
-#define CVECTOR2_H
-
-class CVector2
-{
-public:
-    CVector2()  { }
-    CVector2(float initial_x, float initial_y);
-    ~CVector2() { }
-
-    CVector2    operator+(const CVector2 &v1);
-    CVector2&   operator+=(const CVector2 &v1);
-    CVector2    operator-(const CVector2 &v1);
-    CVector2    operator-();
-    CVector2    operator*(float scale);
-    CVector2&   operator*=(float scale);
-
-    float       GetLength();
-    float       GetAngle();     // Returns angle in degrees
-    void        Rotate(float angle_in_degrees);
-    void        Normalize(float new_length = 1.0f);
-
-    float       x;
-    float       y;
-};
-
-extern float    GetDistanceBetween(CVector2 *v1, CVector2 *v2);
-extern float    GetDotProduct(CVector2 *v1, CVector2 *v2);
-extern float    Clamp(float current_value, float min_value, float max_value);
-extern float    Sign(float x);
-extern bool     Equal(float x1, float x2);
-
-#endif
\ No newline at end of file
+//
+// Simple 2D vector class
+//
+// GetAngle() and Rotate() can use fast polynomial approximations of atan2(),
+// sin() and cos() instead of the C library's. They're used if the build
+// defines FAST_TRIGONOMETRY, or after SetFastTrigonometry(true). See
+// CVector2.cpp for how accurate they are.
+//
+// The arithmetic is all inline, so that it costs no more than writing out
+// the x and y sums by hand. To do the same thing to a lot of vectors at
+// once, use a CVector2Batch instead.
+//
+
+#ifndef CVECTOR2_H
+#define CVECTOR2_H
+
+#include "math.h"
+
+class CVector2
+{
+public:
+    CVector2()                                          { }
+    CVector2(float initial_x, float initial_y)          : x(initial_x), y(initial_y) { }
+    ~CVector2()                                         { }
+
+    CVector2    operator+(const CVector2 &v1) const     { return CVector2(x + v1.x, y + v1.y); }
+    CVector2&   operator+=(const CVector2 &v1)          { x += v1.x; y += v1.y; return *this; }
+    CVector2    operator-(const CVector2 &v1) const     { return CVector2(x - v1.x, y - v1.y); }
+    CVector2    operator-() const                       { return CVector2(-x, -y); }
+    CVector2    operator*(float scale) const            { return CVector2(x * scale, y * scale); }
+    CVector2&   operator*=(float scale)                 { x *= scale; y *= scale; return *this; }
+
+    float       GetLength() const                       { return (float)sqrt((x * x) + (y * y)); }
+    float       GetAngle() const;   // Returns angle in degrees
+    void        Rotate(float angle_in_degrees);
+    void        RotateBy(const CVector2 &rotation);
+    void        Normalize(float new_length = 1.0f);
+    void        Renormalize();
+
+    void        Serialize(CArchive &archive);
+
+    float       x;
+    float       y;
+};
+
+extern void     GetAngles(const CVector2 *vectors, float *angles_in_degrees, int count);
+extern void     RotateVectors(CVector2 *vectors, const float *angles_in_degrees, int count);
+
+extern void     SetFastTrigonometry(bool fast_trigonometry);
+extern bool     GetFastTrigonometry();
+extern float    FastAtan2(float y, float x);
+extern void     FastSinCos(float angle_in_radians, float *sine, float *cosine);
+
+extern CVector2 GetRotation(float angle_in_degrees);
+
+extern float    GetAngleBetween(const CVector2 *v1, const CVector2 *v2);
+extern float    Clamp(float current_value, float min_value, float max_value);
+extern float    Sign(float x);
+extern bool     Equal(float x1, float x2);
+
+//
+// Returns the dot product of two vectors
+//
+
+inline float GetDotProduct(const CVector2 *v1, const CVector2 *v2)
+{
+    return (v1->x * v2->x) + (v1->y * v2->y);
+}
+
+//
+// Returns the z component of the cross product of two vectors, which is
+// +ve if v2 is counterclockwise of v1
+//
+
+inline float GetCrossProduct(const CVector2 *v1, const CVector2 *v2)
+{
+    return (v1->x * v2->y) - (v1->y * v2->x);
+}
+
+//
+// Returns the distance between two position vectors
+//
+
+inline float GetDistanceBetween(const CVector2 *v1, const CVector2 *v2)
+{
+    return (*v1 - *v2).GetLength();
+}
+
+//
+// Rotate this vector by a unit vector made by GetRotation(). This is the
+// same as multiplying them as complex numbers, and so needs no
+// trigonometry at all.
+//
+
+inline void CVector2::RotateBy(const CVector2 &rotation)
+{
+    float new_x = (x * rotation.x)  - (y * rotation.y);
+    float new_y = (x * rotation.y)  + (y * rotation.x);
+
+    x           = new_x;
+    y           = new_y;
+}
+
+//
+// Pull a vector that should have a length of 1, but has drifted a little
+// from it through rounding, back to a length of 1. This is one Newton step
+// towards 1 / sqrt() of its squared length, so it needs no sqrt(), but is
+// only good for vectors whose length is already very close to 1. Use
+// Normalize() for anything else.
+//
+
+inline void CVector2::Renormalize()
+{
+    float scale = 0.5f * (3.0f - GetDotProduct(this, this));
+
+    x *= scale;
+    y *= scale;
+}
+
+#endif
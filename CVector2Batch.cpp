@@ -0,0 +1,210 @@
+//
+// A batch of 2D vectors, kept as separate x and y arrays for SIMD.
+//
+// Each kernel is written in terms of the VECTOR_ macros below, which map
+// onto SSE, the widest instruction set VC7.1 can generate. Every kernel
+// works on VECTOR_WIDTH vectors at a time, across the whole padded batch.
+//
+
+#include "stdafx.h"
+#include "malloc.h"
+#include "CVector2Batch.h"
+
+#include <xmmintrin.h>
+
+typedef __m128 SVectorFloats;
+
+#define VECTOR_WIDTH                4
+#define VECTOR_LOAD(p)              _mm_load_ps(p)
+#define VECTOR_STORE(p, a)          _mm_store_ps(p, a)
+#define VECTOR_STORE_UNALIGNED(p, a) _mm_storeu_ps(p, a)
+#define VECTOR_SET(x)               _mm_set1_ps(x)
+#define VECTOR_ADD(a, b)            _mm_add_ps(a, b)
+#define VECTOR_SUBTRACT(a, b)       _mm_sub_ps(a, b)
+#define VECTOR_MULTIPLY(a, b)       _mm_mul_ps(a, b)
+#define VECTOR_DIVIDE(a, b)         _mm_div_ps(a, b)
+#define VECTOR_SQRT(a)              _mm_sqrt_ps(a)
+#define VECTOR_GREATER(a, b)        _mm_cmpgt_ps(a, b)
+#define VECTOR_AND(a, b)            _mm_and_ps(a, b)
+#define VECTOR_AND_NOT(a, b)        _mm_andnot_ps(a, b)
+#define VECTOR_OR(a, b)             _mm_or_ps(a, b)
+
+//
+// Tuning constants
+//
+
+const int   Vector2BatchAlignment           = 16;       // Alignment of our arrays, in bytes. Enough for SSE.
+const int   Vector2BatchPadding             = 4;        // We pad to a multiple of this many vectors. Must be a multiple of VECTOR_WIDTH.
+const float Vector2BatchMinNormalizeLength  = 0.0001f;  // Same as CVector2::Normalize()
+
+//
+// Make room for size vectors, all zero. The padding after them starts out
+// zero too, but the kernels write whatever they like to it afterwards, so
+// it should never be read.
+//
+
+void CVector2Batch::SetSize(int size)
+{
+    ASSERT(size >= 0);
+
+    int padded_size = ((size + Vector2BatchPadding - 1) / Vector2BatchPadding) * Vector2BatchPadding;
+
+    if (padded_size > m_PaddedSize)
+    {
+        Free();
+
+        m_pX = (float *)_aligned_malloc(padded_size * sizeof(float), Vector2BatchAlignment);
+        m_pY = (float *)_aligned_malloc(padded_size * sizeof(float), Vector2BatchAlignment);
+
+        if (!m_pX || !m_pY)
+        {
+            TRACE("Unable to allocate a batch of %d vectors\n", size);
+
+            Free();
+
+            AfxThrowMemoryException();
+        }
+
+        m_PaddedSize = padded_size;
+    }
+
+    memset(m_pX, 0, m_PaddedSize * sizeof(float));
+    memset(m_pY, 0, m_PaddedSize * sizeof(float));
+
+    m_Size = size;
+}
+
+void CVector2Batch::Free()
+{
+    _aligned_free(m_pX);
+    _aligned_free(m_pY);
+
+    m_pX            = NULL;
+    m_pY            = NULL;
+    m_Size          = 0;
+    m_PaddedSize    = 0;
+}
+
+//
+// Add each vector of batch to the matching one of ours. Both batches must
+// be the same size.
+//
+
+void CVector2Batch::Add(const CVector2Batch &batch)
+{
+    ASSERT(batch.m_Size == m_Size);
+
+    for (int i = 0; i < m_PaddedSize; i += VECTOR_WIDTH)
+    {
+        VECTOR_STORE(&m_pX[i], VECTOR_ADD(VECTOR_LOAD(&m_pX[i]), VECTOR_LOAD(&batch.m_pX[i])));
+        VECTOR_STORE(&m_pY[i], VECTOR_ADD(VECTOR_LOAD(&m_pY[i]), VECTOR_LOAD(&batch.m_pY[i])));
+    }
+}
+
+//
+// Subtract each vector of batch from the matching one of ours. Both
+// batches must be the same size.
+//
+
+void CVector2Batch::Subtract(const CVector2Batch &batch)
+{
+    ASSERT(batch.m_Size == m_Size);
+
+    for (int i = 0; i < m_PaddedSize; i += VECTOR_WIDTH)
+    {
+        VECTOR_STORE(&m_pX[i], VECTOR_SUBTRACT(VECTOR_LOAD(&m_pX[i]), VECTOR_LOAD(&batch.m_pX[i])));
+        VECTOR_STORE(&m_pY[i], VECTOR_SUBTRACT(VECTOR_LOAD(&m_pY[i]), VECTOR_LOAD(&batch.m_pY[i])));
+    }
+}
+
+//
+// Multiply every vector by scale
+//
+
+void CVector2Batch::Scale(float scale)
+{
+    SVectorFloats scale_vector = VECTOR_SET(scale);
+
+    for (int i = 0; i < m_PaddedSize; i += VECTOR_WIDTH)
+    {
+        VECTOR_STORE(&m_pX[i], VECTOR_MULTIPLY(VECTOR_LOAD(&m_pX[i]), scale_vector));
+        VECTOR_STORE(&m_pY[i], VECTOR_MULTIPLY(VECTOR_LOAD(&m_pY[i]), scale_vector));
+    }
+}
+
+//
+// Make every vector have length new_length. Just like
+// CVector2::Normalize(), vectors that are too short to have a direction
+// are set to point along the x axis.
+//
+
+void CVector2Batch::Normalize(float new_length)
+{
+    SVectorFloats new_length_vector = VECTOR_SET(new_length);
+    SVectorFloats min_length_vector = VECTOR_SET(Vector2BatchMinNormalizeLength);
+
+    for (int i = 0; i < m_PaddedSize; i += VECTOR_WIDTH)
+    {
+        SVectorFloats x         = VECTOR_LOAD(&m_pX[i]);
+        SVectorFloats y         = VECTOR_LOAD(&m_pY[i]);
+        SVectorFloats length    = VECTOR_SQRT(VECTOR_ADD(VECTOR_MULTIPLY(x, x), VECTOR_MULTIPLY(y, y)));
+        SVectorFloats long_mask = VECTOR_GREATER(length, min_length_vector);
+        SVectorFloats scale     = VECTOR_DIVIDE(new_length_vector, length);
+
+        // Pick the scaled vector where it was long enough, and
+        // (new_length, 0) where it wasn't
+
+        x = VECTOR_OR(VECTOR_AND(long_mask, VECTOR_MULTIPLY(x, scale)), VECTOR_AND_NOT(long_mask, new_length_vector));
+        y = VECTOR_AND(long_mask, VECTOR_MULTIPLY(y, scale));
+
+        VECTOR_STORE(&m_pX[i], x);
+        VECTOR_STORE(&m_pY[i], y);
+    }
+}
+
+//
+// Rotate each vector by the matching unit vector in rotations, made by
+// GetRotation(), just like CVector2::RotateBy(). Both batches must be the
+// same size.
+//
+
+void CVector2Batch::RotateBy(const CVector2Batch &rotations)
+{
+    ASSERT(rotations.m_Size == m_Size);
+
+    for (int i = 0; i < m_PaddedSize; i += VECTOR_WIDTH)
+    {
+        SVectorFloats x         = VECTOR_LOAD(&m_pX[i]);
+        SVectorFloats y         = VECTOR_LOAD(&m_pY[i]);
+        SVectorFloats cosine    = VECTOR_LOAD(&rotations.m_pX[i]);
+        SVectorFloats sine      = VECTOR_LOAD(&rotations.m_pY[i]);
+
+        VECTOR_STORE(&m_pX[i], VECTOR_SUBTRACT(VECTOR_MULTIPLY(x, cosine), VECTOR_MULTIPLY(y, sine)));
+        VECTOR_STORE(&m_pY[i], VECTOR_ADD(VECTOR_MULTIPLY(x, sine), VECTOR_MULTIPLY(y, cosine)));
+    }
+}
+
+//
+// Write the length of every vector to lengths, which needs room for
+// GetSize() floats and doesn't have to be aligned
+//
+
+void CVector2Batch::GetLengths(float *lengths) const
+{
+    int i = 0;
+
+    for (i = 0; i + VECTOR_WIDTH <= m_Size; i += VECTOR_WIDTH)
+    {
+        SVectorFloats x = VECTOR_LOAD(&m_pX[i]);
+        SVectorFloats y = VECTOR_LOAD(&m_pY[i]);
+
+        VECTOR_STORE_UNALIGNED(&lengths[i], VECTOR_SQRT(VECTOR_ADD(VECTOR_MULTIPLY(x, x), VECTOR_MULTIPLY(y, y))));
+    }
+
+    // Whatever's left over doesn't fill a whole register
+
+    for (; i < m_Size; i++)
+    {
+        lengths[i] = (float)sqrt((m_pX[i] * m_pX[i]) + (m_pY[i] * m_pY[i]));
+    }
+}
@@ -0,0 +1,57 @@
+//
+// A batch of 2D vectors, kept as one array of x coordinates and another of
+// y coordinates, so that the same operation can be done to several of them
+// at once with SIMD instructions. Use it for working on the positions of
+// every missile or target in a world at once, gathered with
+// CWorld::GetMissilePositions() and GetTargetPositions(), rather than
+// looping over CVector2s. Stepping the world itself still moves each pair
+// with CVector2s, since each missile's steering depends on its own state.
+//
+// The kernels use SSE. Both arrays are aligned and padded up to a whole
+// number of SSE registers, so the kernels never need a separate loop for
+// the last few vectors. The padding is never part of GetSize().
+//
+
+#ifndef CVECTOR2BATCH_H
+#define CVECTOR2BATCH_H
+
+#include "CVector2.h"
+
+class CVector2Batch
+{
+public:
+    CVector2Batch()                                     : m_pX(NULL), m_pY(NULL), m_Size(0), m_PaddedSize(0) { }
+    ~CVector2Batch()                                    { Free(); }
+
+    void                SetSize(int size);
+    int                 GetSize() const                 { return m_Size; }
+
+    float*              GetX()                          { return m_pX; }
+    float*              GetY()                          { return m_pY; }
+    const float*        GetX() const                    { return m_pX; }
+    const float*        GetY() const                    { return m_pY; }
+
+    void                Set(int index, const CVector2 &v)   { ASSERT((index >= 0) && (index < m_Size)); m_pX[index] = v.x; m_pY[index] = v.y; }
+    CVector2            Get(int index) const                { ASSERT((index >= 0) && (index < m_Size)); return CVector2(m_pX[index], m_pY[index]); }
+
+    void                Add(const CVector2Batch &batch);
+    void                Subtract(const CVector2Batch &batch);
+    void                Scale(float scale);
+    void                Normalize(float new_length = 1.0f);
+    void                RotateBy(const CVector2Batch &rotations);
+    void                GetLengths(float *lengths) const;
+
+private:
+    // Not copyable, since we own our arrays
+    CVector2Batch(const CVector2Batch &batch);
+    CVector2Batch&      operator=(const CVector2Batch &batch);
+
+    void                Free();
+
+    float*              m_pX;                       // x coordinates, aligned and padded
+    float*              m_pY;                       // y coordinates, aligned and padded
+    int                 m_Size;                     // Number of vectors in the batch
+    int                 m_PaddedSize;               // Number of vectors we have room for, including the padding
+};
+
+#endif
@@ -1,263 +1,957 @@
-//
-// Class to represent our world: just a missile and a target for it to
-// steer towards
-//
-
-#include "stdafx.h"
-#include "Resource.h"
-#include "GlView.h"
-#include "CWorld.h"
-
-//
-// Tuning constants
-//
-
-const float MissileStartPositionFactor  = 0.25f;        // Where to start the missile from, as a fraction along our y axis
-const float TargetStartPositionFactor   = -0.25f;       // Where to start the target from, as a fraction along our y axis
-
-const float WorldSize                   = 7500.0f;//10000.0f;       // Size of the world in world units
-
-const float BackgroundZDepth            = -2.0f;        // Z depth to draw the background at
-
-// Extents of the textures used for the missile and target
-const int   MissileTextureHeight        = 64;
-const int   MissileTextureWidth         = 32;
-const int   MissileTextureBitDepth      = 32;
-
-const int   TargetTextureHeight         = 32;
-const int   TargetTextureWidth          = 32;
-const int   TargetTextureBitDepth       = 32;
-
-const int   ExplosionTextureHeight      = 64;
-const int   ExplosionTextureWidth       = 64;
-const int   ExplosionTextureBitDepth    = 32;
-
-CWorld::CWorld()
-{
-    int i = 0;
-
-    CString texture_directory;
-    CString missile_texture_filename[NUM_MISSILE_TEXTURES];
-    CString target_texture_filename[NUM_TARGET_TEXTURES];
-
-    texture_directory.LoadString(IDS_TEXTURE_DIRECTORY);
-    missile_texture_filename[eMISSILE_TEXTURE_NO_FLAME].LoadString(IDS_MISSILE_TEXTURE_NO_FLAME);
-    missile_texture_filename[eMISSILE_TEXTURE_FLAME_1].LoadString(IDS_MISSILE_TEXTURE_FLAME_1);
-    missile_texture_filename[eMISSILE_TEXTURE_FLAME_2].LoadString(IDS_MISSILE_TEXTURE_FLAME_2);
-    missile_texture_filename[eMISSILE_TEXTURE_FLAME_3].LoadString(IDS_MISSILE_TEXTURE_FLAME_3);
-    missile_texture_filename[eMISSILE_TEXTURE_EXPLOSION].LoadString(IDS_EXPLOSION_TEXTURE);
-
-    target_texture_filename[eTARGET_TEXTURE_NORMAL].LoadString(IDS_TARGET_TEXTURE);
-    target_texture_filename[eTARGET_TEXTURE_EXPLOSION].LoadString(IDS_EXPLOSION_TEXTURE);
-
-    m_Center.x  = 0.0f;
-    m_Center.y  = 0.0f;
-
-    m_Missile.SetCurrentWorld(this);
-    m_Target.SetCurrentWorld(this);
-
-    for (i = 0; i <= eMISSILE_TEXTURE_FLAME_3; i++)
-    {
-        m_Missile.SetTexture(texture_directory + missile_texture_filename[i], i, MissileTextureWidth, MissileTextureHeight, MissileTextureBitDepth);
-    }
-
-    for (i = 0; i <= eTARGET_TEXTURE_NORMAL; i++)
-    {
-        m_Target.SetTexture(texture_directory + target_texture_filename[i], i, TargetTextureWidth, TargetTextureHeight, TargetTextureBitDepth);
-    }
-
-    m_Missile.SetTexture(texture_directory  + missile_texture_filename[eMISSILE_TEXTURE_EXPLOSION], eMISSILE_TEXTURE_EXPLOSION, ExplosionTextureWidth,  ExplosionTextureHeight, ExplosionTextureBitDepth);
-    m_Target.SetTexture(texture_directory   + target_texture_filename[eTARGET_TEXTURE_EXPLOSION],   eTARGET_TEXTURE_EXPLOSION,  ExplosionTextureWidth,  ExplosionTextureHeight, ExplosionTextureBitDepth);
-
-    m_Missile.SetTarget(&m_Target);
-
-    ResetMissileAndTarget();
-}
-
-CWorld::~CWorld()
-{
-
-}
-
-//
-// Put the missile and target back at their start positions
-//
-
-void CWorld::ResetMissileAndTarget()
-{
-    m_Missile.Reset();
-    m_Target.Reset();
-
-    m_Missile.SetPosition(0.0f, GetSize()   * MissileStartPositionFactor);
-    m_Target.SetPosition(0.0f,  GetSize()   * TargetStartPositionFactor);
-}
-
-//
-// Handle anything that needs to be done before our current timestep
-// begins
-//
-
-void CWorld::BeginTimestep()
-{
-    // Reset all of our user desired inputs so that they can be
-    // set again by HandleKeyboardState() based on the current
-    // state of the keyboard
-
-    m_Missile.SetUserDesiredAcceleration(0.0f);
-    m_Missile.SetUserDesiredAngularAcceleration(0.0f);
-
-    m_Target.SetUserDesiredVelocityX(0.0f);
-    m_Target.SetUserDesiredVelocityY(0.0f);
-}
-
-//
-// Move all of our components by timestep seconds.
-//
-
-void CWorld::DoTimestep(float timestep)
-{
-    if (m_Missile.NeedToBeReset() && m_Target.NeedToBeReset())
-    {
-        ResetMissileAndTarget();
-    }
-
-    m_Target.Move(timestep);
-
-    m_Missile.Steer(timestep);
-    m_Missile.Move(timestep);
-
-    m_Missile.CheckCollisionWithTarget();
-}
-
-//
-// Handle anything that needs to be done after our current timestep
-// ends
-//
-
-void CWorld::EndTimestep()
-{
-
-}
-
-//
-// Width and height of our world in world units
-//
-
-float CWorld::GetSize()
-{
-    return WorldSize;
-}
-
-//
-// Returns the location of the center of the world
-//
-
-CVector2 *CWorld::GetCenter()
-{
-    return &m_Center;
-}
-
-//
-// Handles the effects of the state of one key at a time
-//
-
-void CWorld::HandleKeyboardState(eKey key, bool state)
-{
-    switch (key)
-    {
-        case eKEY_MISSILE_THRUST:
-        {
-            if (state)
-            {
-                m_Missile.SetUserDesiredAcceleration(m_Missile.GetMaxAcceleration());
-            }
-
-            break;
-        }
-
-        case eKEY_MISSILE_TURN_LEFT:
-        {
-            if (state)
-            {
-                m_Missile.SetUserDesiredAngularAcceleration(m_Missile.GetMaxAngularAcceleration());
-            }
-
-            break;
-        }
-
-        case eKEY_MISSILE_TURN_RIGHT:
-        {
-            if (state)
-            {
-                m_Missile.SetUserDesiredAngularAcceleration(-m_Missile.GetMaxAngularAcceleration());
-            }
-
-            break;
-        }
-
-        case eKEY_TARGET_MOVE_LEFT:
-        {
-            if (state)
-            {
-                m_Target.SetUserDesiredVelocityX(-m_Target.GetMaxSpeed());
-            }
-
-            break;
-        }
-
-        case eKEY_TARGET_MOVE_RIGHT:
-        {
-            if (state)
-            {
-                m_Target.SetUserDesiredVelocityX(m_Target.GetMaxSpeed());
-            }
-
-            break;
-        }
-
-        case eKEY_TARGET_MOVE_UP:
-        {
-            if (state)
-            {
-                m_Target.SetUserDesiredVelocityY(m_Target.GetMaxSpeed());
-            }
-
-            break;
-        }
-
-        case eKEY_TARGET_MOVE_DOWN:
-        {
-            if (state)
-            {
-                m_Target.SetUserDesiredVelocityY(-m_Target.GetMaxSpeed());
-            }
-
-            break;
-        }
-
-        default:
-        {
-            TRACE("Unknown key %d passed into CWorld::HandleKeyboardState()\n", key);
-
-            break;
-        }
-    }
-}
-
-//
-// Draw all of the components of our world on the specified view
-//
-// We've disabled depth testing, so the drawing order matters
-//
-
-int CWorld::Draw(CGlView *gl_view)
-{
-    gl_view->BeginDrawGLScene();
-
-    m_Target.Draw(gl_view);
-    m_Missile.Draw(gl_view);
-
-    gl_view->EndDrawGLScene();
-
-    return TRUE;
+//
+// Class to represent our world: just a missile and a target for it to
+// steer towards, or any number of missile and target pairs
+//
+
+#include "stdafx.h"
+#include "Resource.h"
+#include "GlView.h"
+#include "CWorld.h"
+#include "CVector2Batch.h"
+#include "CProfiler.h"
+#include "CMetrics.h"
+#include "CAllocationCounter.h"
+#include "CTargetTrajectoryTable.h"
+#include "CTargetPath.h"
+
+//
+// Tuning constants
+//
+// Our size and the start positions of the missile and target are read
+// from our CConfig. See CConfig.cpp for their default values.
+//
+
+const float BackgroundZDepth            = -2.0f;        // Z depth to draw the background at
+
+// Extents of the textures used for the missile and target
+const int   MissileTextureHeight        = 64;
+const int   MissileTextureWidth         = 32;
+const int   MissileTextureBitDepth      = 32;
+
+const int   TargetTextureHeight         = 32;
+const int   TargetTextureWidth          = 32;
+const int   TargetTextureBitDepth       = 32;
+
+const int   ExplosionTextureHeight      = 64;
+const int   ExplosionTextureWidth       = 64;
+const int   ExplosionTextureBitDepth    = 32;
+
+// Snapshots
+const DWORD WorldSnapshotMagic          = 0x504E5357;   // "WSNP"
+const DWORD WorldSnapshotVersion        = 10;
+
+//
+// Make a world with one missile and target pair. Worlds that will never
+// be drawn, such as those used for sweeps and benchmarks, can skip
+// loading their textures by passing false for load_textures; they'll be
+// loaded the first time the world is drawn, if it ever is.
+//
+
+CWorld::CWorld(bool load_textures)
+{
+    m_Center.x      = 0.0f;
+    m_Center.y      = 0.0f;
+
+    m_TimeElapsed   = 0.0f;
+
+    m_pMissile              = NULL;
+    m_pTarget               = NULL;
+    m_NumPairs              = 0;
+    m_pTelemetryRecorder    = NULL;
+
+    m_pActivePair           = NULL;
+    m_NumActivePairs        = 0;
+    m_pPairFellAsleep       = NULL;
+    m_pSleepingPair         = NULL;
+    m_FirstSleepingPair     = 0;
+    m_NumSleepingPairs      = 0;
+
+    m_TexturesLoaded        = false;
+
+    if (load_textures)
+    {
+        LoadTextures();
+    }
+
+    SetNumPairs(1);
+}
+
+CWorld::~CWorld()
+{
+    // Everything we allocated is freed along with our arena
+}
+
+//
+// Read the textures shared by all of our missiles and targets
+//
+
+void CWorld::LoadTextures()
+{
+    int i = 0;
+
+    CString texture_directory;
+    CString missile_texture_filename[NUM_MISSILE_TEXTURES];
+    CString target_texture_filename[NUM_TARGET_TEXTURES];
+
+    texture_directory.LoadString(IDS_TEXTURE_DIRECTORY);
+    missile_texture_filename[eMISSILE_TEXTURE_NO_FLAME].LoadString(IDS_MISSILE_TEXTURE_NO_FLAME);
+    missile_texture_filename[eMISSILE_TEXTURE_FLAME_1].LoadString(IDS_MISSILE_TEXTURE_FLAME_1);
+    missile_texture_filename[eMISSILE_TEXTURE_FLAME_2].LoadString(IDS_MISSILE_TEXTURE_FLAME_2);
+    missile_texture_filename[eMISSILE_TEXTURE_FLAME_3].LoadString(IDS_MISSILE_TEXTURE_FLAME_3);
+    missile_texture_filename[eMISSILE_TEXTURE_EXPLOSION].LoadString(IDS_EXPLOSION_TEXTURE);
+
+    target_texture_filename[eTARGET_TEXTURE_NORMAL].LoadString(IDS_TARGET_TEXTURE);
+    target_texture_filename[eTARGET_TEXTURE_EXPLOSION].LoadString(IDS_EXPLOSION_TEXTURE);
+
+    for (i = 0; i <= eMISSILE_TEXTURE_FLAME_3; i++)
+    {
+        m_MissileTexture[i].ReadFile(texture_directory + missile_texture_filename[i], MissileTextureWidth, MissileTextureHeight, MissileTextureBitDepth);
+    }
+
+    for (i = 0; i <= eTARGET_TEXTURE_NORMAL; i++)
+    {
+        m_TargetTexture[i].ReadFile(texture_directory + target_texture_filename[i], TargetTextureWidth, TargetTextureHeight, TargetTextureBitDepth);
+    }
+
+    m_MissileTexture[eMISSILE_TEXTURE_EXPLOSION].ReadFile(texture_directory + missile_texture_filename[eMISSILE_TEXTURE_EXPLOSION], ExplosionTextureWidth, ExplosionTextureHeight, ExplosionTextureBitDepth);
+    m_TargetTexture[eTARGET_TEXTURE_EXPLOSION].ReadFile(texture_directory   + target_texture_filename[eTARGET_TEXTURE_EXPLOSION],   ExplosionTextureWidth, ExplosionTextureHeight, ExplosionTextureBitDepth);
+
+    m_TexturesLoaded = true;
+}
+
+//
+// Throw away all of our missiles and targets, and replace them with
+// num_pairs new ones at their start positions. Only goes to the heap if
+// we've never had this many pairs before.
+//
+
+void CWorld::SetNumPairs(int num_pairs)
+{
+    ASSERT(num_pairs > 0);
+
+    m_Arena.Reserve(CArena::GetArraySize(sizeof(CMissile),         num_pairs) +
+                    CArena::GetArraySize(sizeof(CTarget),          num_pairs) +
+                    CArena::GetArraySize(sizeof(int),              num_pairs) +
+                    CArena::GetArraySize(sizeof(bool),             num_pairs) +
+                    CArena::GetArraySize(sizeof(SSleepingPair),    num_pairs));
+
+    m_pMissile          = m_Arena.AllocateArray<CMissile>(num_pairs);
+    m_pTarget           = m_Arena.AllocateArray<CTarget>(num_pairs);
+    m_NumPairs          = num_pairs;
+
+    m_pActivePair       = m_Arena.AllocateArray<int>(num_pairs);
+    m_pPairFellAsleep   = m_Arena.AllocateArray<bool>(num_pairs);
+    m_pSleepingPair     = m_Arena.AllocateArray<SSleepingPair>(num_pairs);
+
+    for (int pair = 0; pair < m_NumPairs; pair++)
+    {
+        m_pMissile[pair].SetCurrentWorld(this);
+        m_pTarget[pair].SetCurrentWorld(this);
+
+        m_pMissile[pair].SetConfig(&m_Config);
+        m_pTarget[pair].SetConfig(&m_Config);
+
+        m_pMissile[pair].SetTarget(&m_pTarget[pair]);
+
+        ResetMissileAndTarget(pair);
+    }
+
+    m_pMissile[0].SetTelemetryRecorder(m_pTelemetryRecorder);
+
+    ResetPairLists();
+}
+
+//
+// Wake every pair up
+//
+
+void CWorld::ResetPairLists()
+{
+    for (int pair = 0; pair < m_NumPairs; pair++)
+    {
+        m_pActivePair[pair]     = pair;
+        m_pPairFellAsleep[pair] = false;
+    }
+
+    m_NumActivePairs    = m_NumPairs;
+    m_FirstSleepingPair = 0;
+    m_NumSleepingPairs  = 0;
+}
+
+//
+// Set where our first missile records its steering state every timestep.
+// Pass in NULL to stop recording.
+//
+
+void CWorld::SetTelemetryRecorder(CTelemetryRecorder *recorder)
+{
+    m_pTelemetryRecorder = recorder;
+
+    m_pMissile[0].SetTelemetryRecorder(recorder);
+}
+
+//
+// Put one missile and target back at their start positions
+//
+
+void CWorld::ResetMissileAndTarget(int pair)
+{
+    m_pMissile[pair].Reset();
+    m_pTarget[pair].Reset();
+
+    m_pMissile[pair].SetPosition(0.0f, GetSize()    * m_Config.Get(eCONFIG_MISSILE_START_POSITION_FACTOR));
+    m_pTarget[pair].SetPosition(0.0f,  GetSize()    * m_Config.Get(eCONFIG_TARGET_START_POSITION_FACTOR));
+}
+
+//
+// Start everything over from scratch. All of the randomness in our world
+// comes from random_seed, so restarting from the same seed with the same
+// config, and then making the same calls, always gives the same results.
+// Each target gets its own seed, so that they don't all move in lockstep.
+//
+
+void CWorld::Restart(unsigned long random_seed)
+{
+    m_TimeElapsed = 0.0f;
+
+    for (int pair = 0; pair < m_NumPairs; pair++)
+    {
+        m_pTarget[pair].SetRandomSeed(random_seed + pair);
+
+        ResetMissileAndTarget(pair);
+
+        m_pMissile[pair].ResetSteering();
+    }
+
+    ResetPairLists();
+}
+
+//
+// Have the target of each pair follow a trajectory of table instead of
+// moving on its own, with pair i following trajectory i, wrapping around
+// if there are more pairs than trajectories. Passing NULL puts them back
+// under automatic control. Call this after Restart() from
+// table->GetFirstSeed() for targets that start where the table does, and
+// again after any SetNumPairs(). table has to outlast us, or be replaced.
+//
+
+void CWorld::SetTargetTrajectories(const CTargetTrajectoryTable *table)
+{
+    for (int pair = 0; pair < m_NumPairs; pair++)
+    {
+        if (table)
+        {
+            m_pTarget[pair].SetTrajectory(table, pair % table->GetNumTrajectories());
+            m_pTarget[pair].SetControlMode(eTARGET_CONTROL_TRAJECTORY);
+        }
+        else
+        {
+            m_pTarget[pair].SetTrajectory(NULL, 0);
+            m_pTarget[pair].SetControlMode(eTARGET_CONTROL_AUTOMATIC);
+        }
+    }
+}
+
+//
+// Give the target of each pair path to follow whenever it's under
+// eTARGET_CONTROL_PATH. The targets are spread out evenly around the loop,
+// so that they don't all move in lockstep. Passing NULL takes it away
+// again. Call this again after any SetNumPairs(). path has to outlast us,
+// or be replaced.
+//
+
+void CWorld::SetTargetPath(const CTargetPath *path)
+{
+    for (int pair = 0; pair < m_NumPairs; pair++)
+    {
+        m_pTarget[pair].SetPath(path, path ? ((path->GetPeriod() * pair) / m_NumPairs) : 0.0);
+    }
+}
+
+//
+// Take a copy of all of the tuning values in config, and pass them
+// along to our missile and target
+//
+
+void CWorld::SetConfig(const CConfig *config)
+{
+    m_Config = *config;
+
+    for (int pair = 0; pair < m_NumPairs; pair++)
+    {
+        m_pMissile[pair].SetConfig(&m_Config);
+        m_pTarget[pair].SetConfig(&m_Config);
+    }
+}
+
+//
+// Handle anything that needs to be done before our current timestep
+// begins
+//
+
+void CWorld::BeginTimestep()
+{
+    // Reset all of our user desired inputs so that they can be
+    // set again by HandleKeyboardState() based on the current
+    // state of the keyboard
+
+    for (int pair = 0; pair < m_NumPairs; pair++)
+    {
+        m_pMissile[pair].SetUserDesiredAcceleration(0.0f);
+        m_pMissile[pair].SetUserDesiredAngularAcceleration(0.0f);
+
+        m_pTarget[pair].SetUserDesiredVelocityX(0.0f);
+        m_pTarget[pair].SetUserDesiredVelocityY(0.0f);
+    }
+}
+
+//
+// Move all of our components by timestep seconds.
+//
+
+void CWorld::DoTimestep(float timestep)
+{
+    PROFILE_ZONE("World.DoTimestep");
+
+    LONG num_allocations = CAllocationCounter::GetCount();
+
+    AdvanceTime(timestep);
+
+    StepPairs(0, m_NumActivePairs, timestep);
+
+    UpdateSleepingPairs();
+
+    num_allocations = CAllocationCounter::GetCount() - num_allocations;
+
+    if (num_allocations != 0)
+    {
+        CMetrics::Add(eMETRIC_STEP_HEAP_ALLOCATIONS, num_allocations);
+    }
+}
+
+//
+// Move num_active_pairs of our active missiles and targets, starting with
+// the one at first_active_pair in our list of them, by timestep seconds.
+// Doesn't touch anything shared between pairs, so it's safe to call from
+// several threads at once as long as their ranges don't overlap.
+// DoTimestep() does all of them at once.
+//
+// Pairs whose missile hits its target are only marked as having fallen
+// asleep, and are skipped from then on. They're taken out of the list by
+// the next UpdateSleepingPairs(), which must be called between steps, and
+// never while StepPairs() is running.
+//
+
+void CWorld::StepPairs(int first_active_pair, int num_active_pairs, float timestep)
+{
+    PROFILE_ZONE("World.StepPairs");
+
+    ASSERT((first_active_pair >= 0) && (first_active_pair + num_active_pairs <= m_NumActivePairs));
+
+    for (int i = first_active_pair; i < first_active_pair + num_active_pairs; i++)
+    {
+        int pair = m_pActivePair[i];
+
+        if (m_pPairFellAsleep[pair])
+        {
+            continue;
+        }
+
+        CMissile    *missile    = &m_pMissile[pair];
+        CTarget     *target     = &m_pTarget[pair];
+
+        target->Move(timestep);
+
+        missile->Steer(timestep);
+        missile->Move(timestep);
+
+        missile->CheckCollisionWithTarget();
+
+        if (missile->GetCurrentState() != eMISSILE_STATE_FLYING)
+        {
+            m_pPairFellAsleep[pair] = true;
+        }
+    }
+}
+
+//
+// Move the pairs that fell asleep during the last step out of our active
+// list and onto the end of our sleeping ring, and wake up the ones at the
+// front of the ring whose explosions have finished, putting them back at
+// their start positions.
+//
+// Every pair sleeps for as long as the longer of its two explosions, so
+// pairs wake in the order they fell asleep, and we only ever need to look
+// at the front of the ring. If the explosion lengths are changed in our
+// config, a pair might sleep for a little longer than it needs to while
+// it waits for the one in front of it.
+//
+
+void CWorld::UpdateSleepingPairs()
+{
+    int i = 0;
+
+    for (i = 0; i < m_NumActivePairs; )
+    {
+        int pair = m_pActivePair[i];
+
+        if (!m_pPairFellAsleep[pair])
+        {
+            i++;
+
+            continue;
+        }
+
+        SSleepingPair *sleeping_pair = &m_pSleepingPair[(m_FirstSleepingPair + m_NumSleepingPairs) % m_NumPairs];
+
+        sleeping_pair->m_Pair       = pair;
+        sleeping_pair->m_SleepTime  = m_TimeElapsed;
+        sleeping_pair->m_WakeTime   = m_TimeElapsed + max(m_pMissile[pair].GetExplosionTimeLeft(), m_pTarget[pair].GetExplosionTimeLeft());
+
+        m_NumSleepingPairs++;
+
+        m_pPairFellAsleep[pair] = false;
+
+        // Fill the gap with the last active pair
+        m_pActivePair[i] = m_pActivePair[--m_NumActivePairs];
+    }
+
+    while ((m_NumSleepingPairs > 0) && (m_pSleepingPair[m_FirstSleepingPair].m_WakeTime <= m_TimeElapsed))
+    {
+        int pair = m_pSleepingPair[m_FirstSleepingPair].m_Pair;
+
+        ResetMissileAndTarget(pair);
+
+        m_pActivePair[m_NumActivePairs++] = pair;
+
+        m_FirstSleepingPair = (m_FirstSleepingPair + 1) % m_NumPairs;
+        m_NumSleepingPairs--;
+    }
+}
+
+//
+// Count down the explosions of our sleeping pairs to the current time,
+// for anything that needs to see them as they are now
+//
+
+void CWorld::CatchUpSleepingPairs()
+{
+    for (int i = 0; i < m_NumSleepingPairs; i++)
+    {
+        SSleepingPair *sleeping_pair = &m_pSleepingPair[(m_FirstSleepingPair + i) % m_NumPairs];
+
+        m_pMissile[sleeping_pair->m_Pair].AdvanceExplosion(m_TimeElapsed - sleeping_pair->m_SleepTime);
+        m_pTarget[sleeping_pair->m_Pair].AdvanceExplosion(m_TimeElapsed - sleeping_pair->m_SleepTime);
+
+        sleeping_pair->m_SleepTime = m_TimeElapsed;
+    }
+}
+
+//
+// Fill positions with the position of every missile, or every target, in
+// pair order, so that they can all be worked on at once
+//
+
+void CWorld::GetMissilePositions(CVector2Batch *positions)
+{
+    positions->SetSize(m_NumPairs);
+
+    for (int pair = 0; pair < m_NumPairs; pair++)
+    {
+        positions->Set(pair, *m_pMissile[pair].GetPosition());
+    }
+}
+
+void CWorld::GetTargetPositions(CVector2Batch *positions)
+{
+    positions->SetSize(m_NumPairs);
+
+    for (int pair = 0; pair < m_NumPairs; pair++)
+    {
+        positions->Set(pair, *m_pTarget[pair].GetPosition());
+    }
+}
+
+//
+// Handle anything that needs to be done after our current timestep
+// ends
+//
+
+void CWorld::EndTimestep()
+{
+
+}
+
+//
+// Width and height of our world in world units
+//
+
+float CWorld::GetSize()
+{
+    return m_Config.Get(eCONFIG_WORLD_SIZE);
+}
+
+//
+// Returns the location of the center of the world
+//
+
+CVector2 *CWorld::GetCenter()
+{
+    return &m_Center;
+}
+
+//
+// Handles the effects of the state of one key at a time, on all of our
+// missiles and targets
+//
+
+void CWorld::HandleKeyboardState(eKey key, bool state)
+{
+    for (int pair = 0; pair < m_NumPairs; pair++)
+    {
+        CMissile    *missile    = &m_pMissile[pair];
+        CTarget     *target     = &m_pTarget[pair];
+
+        switch (key)
+        {
+            case eKEY_MISSILE_THRUST:
+            {
+                if (state)
+                {
+                    missile->SetUserDesiredAcceleration(missile->GetMaxAcceleration());
+                }
+
+                break;
+            }
+
+            case eKEY_MISSILE_TURN_LEFT:
+            {
+                if (state)
+                {
+                    missile->SetUserDesiredAngularAcceleration(missile->GetMaxAngularAcceleration());
+                }
+
+                break;
+            }
+
+            case eKEY_MISSILE_TURN_RIGHT:
+            {
+                if (state)
+                {
+                    missile->SetUserDesiredAngularAcceleration(-missile->GetMaxAngularAcceleration());
+                }
+
+                break;
+            }
+
+            case eKEY_TARGET_MOVE_LEFT:
+            {
+                if (state)
+                {
+                    target->SetUserDesiredVelocityX(-target->GetMaxSpeed());
+                }
+
+                break;
+            }
+
+            case eKEY_TARGET_MOVE_RIGHT:
+            {
+                if (state)
+                {
+                    target->SetUserDesiredVelocityX(target->GetMaxSpeed());
+                }
+
+                break;
+            }
+
+            case eKEY_TARGET_MOVE_UP:
+            {
+                if (state)
+                {
+                    target->SetUserDesiredVelocityY(target->GetMaxSpeed());
+                }
+
+                break;
+            }
+
+            case eKEY_TARGET_MOVE_DOWN:
+            {
+                if (state)
+                {
+                    target->SetUserDesiredVelocityY(-target->GetMaxSpeed());
+                }
+
+                break;
+            }
+
+            default:
+            {
+                TRACE("Unknown key %d passed into CWorld::HandleKeyboardState()\n", key);
+
+                break;
+            }
+        }
+    }
+}
+
+//
+// Change one setting of all of our missiles or targets
+//
+
+void CWorld::SetSetting(eWorldSetting setting, float new_value)
+{
+    for (int pair = 0; pair < m_NumPairs; pair++)
+    {
+        CMissile    *missile    = &m_pMissile[pair];
+        CTarget     *target     = &m_pTarget[pair];
+
+        switch (setting)
+        {
+            case eWORLD_SETTING_MISSILE_CONTROL_MODE:
+            {
+                missile->SetControlMode((eMissileControlMode)(int)new_value);
+
+                break;
+            }
+
+            case eWORLD_SETTING_TARGET_CONTROL_MODE:
+            {
+                target->SetControlMode((eTargetControlMode)(int)new_value);
+
+                break;
+            }
+
+            case eWORLD_SETTING_MISSILE_STEERING_P_COEFFICIENT:
+            {
+                missile->SetSteeringCoefficient(eP_COEFFICIENT, new_value);
+
+                break;
+            }
+
+            case eWORLD_SETTING_MISSILE_STEERING_I_COEFFICIENT:
+            {
+                missile->SetSteeringCoefficient(eI_COEFFICIENT, new_value);
+
+                break;
+            }
+
+            case eWORLD_SETTING_MISSILE_STEERING_D_COEFFICIENT:
+            {
+                missile->SetSteeringCoefficient(eD_COEFFICIENT, new_value);
+
+                break;
+            }
+
+            case eWORLD_SETTING_MISSILE_MAX_ACCELERATION:
+            {
+                missile->SetMaxAcceleration(new_value);
+
+                break;
+            }
+
+            case eWORLD_SETTING_MISSILE_MAX_ANGULAR_ACCELERATION:
+            {
+                missile->SetMaxAngularAcceleration(new_value);
+
+                break;
+            }
+
+            case eWORLD_SETTING_MISSILE_ROTATIONAL_DRAG_FACTOR:
+            {
+                missile->SetRotationalDragFactor(new_value);
+
+                break;
+            }
+
+            case eWORLD_SETTING_MISSILE_PID_OUTPUT_SCALE:
+            {
+                missile->SetPIDOutputScale(new_value);
+
+                break;
+            }
+
+            case eWORLD_SETTING_TARGET_MAX_SPEED:
+            {
+                target->SetMaxSpeed(new_value);
+
+                break;
+            }
+
+            default:
+            {
+                TRACE("Unknown setting %d passed into CWorld::SetSetting()\n", setting);
+
+                break;
+            }
+        }
+    }
+}
+
+//
+// Returns the current value of one setting of our missiles or targets.
+// They're all changed together, so we just look at the first pair.
+//
+
+float CWorld::GetSetting(eWorldSetting setting)
+{
+    switch (setting)
+    {
+        case eWORLD_SETTING_MISSILE_CONTROL_MODE:               return (float)m_pMissile[0].GetControlMode();
+        case eWORLD_SETTING_TARGET_CONTROL_MODE:                return (float)m_pTarget[0].GetControlMode();
+        case eWORLD_SETTING_MISSILE_STEERING_P_COEFFICIENT:     return m_pMissile[0].GetSteeringCoefficient(eP_COEFFICIENT);
+        case eWORLD_SETTING_MISSILE_STEERING_I_COEFFICIENT:     return m_pMissile[0].GetSteeringCoefficient(eI_COEFFICIENT);
+        case eWORLD_SETTING_MISSILE_STEERING_D_COEFFICIENT:     return m_pMissile[0].GetSteeringCoefficient(eD_COEFFICIENT);
+        case eWORLD_SETTING_MISSILE_MAX_ACCELERATION:           return m_pMissile[0].GetMaxAcceleration();
+        case eWORLD_SETTING_MISSILE_MAX_ANGULAR_ACCELERATION:   return m_pMissile[0].GetMaxAngularAcceleration();
+        case eWORLD_SETTING_MISSILE_ROTATIONAL_DRAG_FACTOR:     return m_pMissile[0].GetRotationalDragFactor();
+        case eWORLD_SETTING_MISSILE_PID_OUTPUT_SCALE:           return m_pMissile[0].GetPIDOutputScale();
+        case eWORLD_SETTING_TARGET_MAX_SPEED:                   return m_pTarget[0].GetMaxSpeed();
+
+        default:
+        {
+            TRACE("Unknown setting %d passed into CWorld::GetSetting()\n", setting);
+
+            return 0.0f;
+        }
+    }
+}
+
+//
+// Write a snapshot of the whole state of our simulation to file
+//
+
+void CWorld::SaveSnapshot(CFile *file)
+{
+    CArchive archive(file, CArchive::store);
+
+    archive << WorldSnapshotMagic << WorldSnapshotVersion;
+
+    Serialize(archive);
+
+    archive.Close();
+}
+
+//
+// Put our simulation back to the state saved in a snapshot by
+// SaveSnapshot(). Returns false if file doesn't hold a snapshot we can
+// read, in which case we're left just as we were.
+//
+
+bool CWorld::RestoreSnapshot(CFile *file)
+{
+    // A snapshot can turn out to be bad halfway through loading it, so
+    // keep our own state to go back to
+
+    CMemFile previous_state;
+
+    SaveSnapshot(&previous_state);
+
+    if (ReadSnapshot(file))
+    {
+        return true;
+    }
+
+    previous_state.SeekToBegin();
+
+    VERIFY(ReadSnapshot(&previous_state));
+
+    return false;
+}
+
+//
+// Load a snapshot from file over our state. Returns false if it isn't one
+// we can read, or it can't be read to the end.
+//
+
+bool CWorld::ReadSnapshot(CFile *file)
+{
+    CArchive archive(file, CArchive::load);
+
+    try
+    {
+        DWORD magic;
+        DWORD version;
+
+        archive >> magic >> version;
+
+        if ((magic != WorldSnapshotMagic) || (version != WorldSnapshotVersion))
+        {
+            TRACE("Not a world snapshot we can read\n");
+
+            archive.Close();
+
+            return false;
+        }
+
+        Serialize(archive);
+
+        archive.Close();
+    }
+    catch (CException *exception)
+    {
+        // Truncated or corrupt snapshots throw a CArchiveException, and
+        // files that can't be read a CFileException
+
+        TRACE("World snapshot is truncated, corrupt or unreadable\n");
+
+        exception->Delete();
+
+        archive.Abort();
+
+        return false;
+    }
+
+    return true;
+}
+
+//
+// Save or load the state of our simulation. Textures aren't included,
+// since they never change.
+//
+
+void CWorld::Serialize(CArchive &archive)
+{
+    if (archive.IsStoring())
+    {
+        archive << m_TimeElapsed;
+    }
+    else
+    {
+        archive >> m_TimeElapsed;
+    }
+
+    // Our missile's steering controller is set up from our config, so
+    // that has to be loaded first
+
+    m_Config.Serialize(archive);
+
+    if (archive.IsStoring())
+    {
+        archive << m_NumPairs;
+    }
+    else
+    {
+        int num_pairs;
+
+        archive >> num_pairs;
+
+        if (num_pairs <= 0)
+        {
+            AfxThrowArchiveException(CArchiveException::badIndex);
+        }
+
+        if (num_pairs != m_NumPairs)
+        {
+            SetNumPairs(num_pairs);
+        }
+
+        SetConfig(&m_Config);
+    }
+
+    int pair = 0;
+    int i    = 0;
+
+    if (archive.IsStoring())
+    {
+        CatchUpSleepingPairs();
+    }
+
+    for (pair = 0; pair < m_NumPairs; pair++)
+    {
+        m_pMissile[pair].Serialize(archive);
+        m_pTarget[pair].Serialize(archive);
+    }
+
+    // Our sleeping pairs, oldest first. Every other pair is active.
+
+    if (archive.IsStoring())
+    {
+        archive << m_NumSleepingPairs;
+
+        for (i = 0; i < m_NumSleepingPairs; i++)
+        {
+            const SSleepingPair *sleeping_pair = &m_pSleepingPair[(m_FirstSleepingPair + i) % m_NumPairs];
+
+            archive << sleeping_pair->m_Pair << sleeping_pair->m_SleepTime << sleeping_pair->m_WakeTime;
+        }
+    }
+    else
+    {
+        int num_sleeping_pairs;
+
+        archive >> num_sleeping_pairs;
+
+        if ((num_sleeping_pairs < 0) || (num_sleeping_pairs > m_NumPairs))
+        {
+            AfxThrowArchiveException(CArchiveException::badIndex);
+        }
+
+        ResetPairLists();
+
+        for (i = 0; i < num_sleeping_pairs; i++)
+        {
+            SSleepingPair *sleeping_pair = &m_pSleepingPair[i];
+
+            archive >> sleeping_pair->m_Pair >> sleeping_pair->m_SleepTime >> sleeping_pair->m_WakeTime;
+
+            if ((sleeping_pair->m_Pair < 0) || (sleeping_pair->m_Pair >= m_NumPairs) || m_pPairFellAsleep[sleeping_pair->m_Pair])
+            {
+                AfxThrowArchiveException(CArchiveException::badIndex);
+            }
+
+            // Borrow the fell asleep flags to mark which pairs are sleeping
+            m_pPairFellAsleep[sleeping_pair->m_Pair] = true;
+        }
+
+        m_NumSleepingPairs  = num_sleeping_pairs;
+        m_NumActivePairs    = 0;
+
+        for (pair = 0; pair < m_NumPairs; pair++)
+        {
+            if (m_pPairFellAsleep[pair])
+            {
+                m_pPairFellAsleep[pair] = false;
+            }
+            else
+            {
+                m_pActivePair[m_NumActivePairs++] = pair;
+            }
+        }
+    }
+}
+
+//
+// Draw all of the components of our world on the specified view
+//
+// We've disabled depth testing, so the drawing order matters
+//
+
+int CWorld::Draw(CGlView *gl_view)
+{
+    PROFILE_ZONE("World.Draw");
+
+    if (!m_TexturesLoaded)
+    {
+        LoadTextures();
+    }
+
+    gl_view->BeginDrawGLScene();
+
+    CatchUpSleepingPairs();
+
+    int pair = 0;
+
+    for (pair = 0; pair < m_NumPairs; pair++)
+    {
+        m_pTarget[pair].Draw(gl_view);
+    }
+
+    for (pair = 0; pair < m_NumPairs; pair++)
+    {
+        m_pMissile[pair].Draw(gl_view);
+    }
+
+    gl_view->EndDrawGLScene();
+
+    return TRUE;
 }
\ No newline at end of file
@@ -1,59 +1,183 @@
-//
-// Class to represent our world: just a missile and a target for it to
-// steer towards
-//
-
-#ifndef CWORLD_H
-#define CWORLD_H
-
-#include "CMissile.h"
-#include "CTarget.h"
-#include "Texture.h"
-
-class CGlView;
-
-// List of all of the keys that we're interested in
-enum eKey
-{
-    eKEY_MISSILE_THRUST = 0,
-    eKEY_MISSILE_TURN_LEFT,
-    eKEY_MISSILE_TURN_RIGHT,
-
-    eKEY_TARGET_MOVE_LEFT,
-    eKEY_TARGET_MOVE_RIGHT,
-    eKEY_TARGET_MOVE_UP,
-    eKEY_TARGET_MOVE_DOWN,
-
-    NUM_KEYS,
-};
-
-class CWorld
-{
-public:
-    CWorld();
-    ~CWorld();
-
-    void                BeginTimestep();
-    void                DoTimestep(float timestep);
-    void                EndTimestep();
-
-    void                HandleKeyboardState(eKey key, bool state);
-
-    float               GetSize();
-    CVector2*           GetCenter();
-
-    CMissile*           GetMissile()                                { return &m_Missile; }
-    CTarget*            GetTarget()                                 { return &m_Target; }
-
-    int                 Draw(CGlView *gl_view);
-
-private:
-    void                ResetMissileAndTarget();
-
-    CVector2            m_Center;                   // Location of the center of our world
-
-    CMissile            m_Missile;                  // Our missile
-    CTarget             m_Target;                   // The target the missile is steering towards
-};
-
-#endif
+//
+// Class to represent our world: just a missile and a target for it to
+// steer towards
+//
+// There's normally only one missile and target, but SetNumPairs() can
+// fill the world with any number of missile and target pairs, where each
+// missile steers towards its own target and ignores all of the others.
+// Pairs never affect each other, so StepPairs() can move different
+// ranges of them on different threads at the same time. To take a
+// timestep that way, call AdvanceTime(), then StepPairs() on every active
+// pair, then UpdateSleepingPairs() once they've all finished, which is all
+// DoTimestep() does on one thread. Only the first missile records telemetry.
+//
+// Once a missile hits its target, neither needs to move again until both
+// have finished exploding and are put back at their start positions. Such
+// pairs are put to sleep: taken out of the compact list of active pairs
+// that StepPairs() works through, and woken up again when their
+// explosions would have finished, so that stepping costs nothing for
+// them in between. Their explosions are only brought up to date when
+// they're drawn or saved.
+//
+// For comparing many configurations against the same targets, the
+// targets can play back a CTargetTrajectoryTable, generated once and
+// shared between worlds, with SetTargetTrajectories(). Or they can follow
+// a smooth scripted CTargetPath, given to them with SetTargetPath().
+//
+// Our missiles, targets and the lists of which pairs are asleep all live
+// in one arena, so setting up a world, or changing its number of pairs,
+// is a few pointer bumps once the arena is big enough, and freeing it is
+// one call. Stepping the world never allocates; in Debug builds, any heap
+// allocation made while it's stepped is counted in our metrics.
+//
+// The whole state of the simulation can be saved with SaveSnapshot() and
+// put back later with RestoreSnapshot(), to checkpoint long runs, or to
+// try out many different what-ifs from the same moment. Snapshots are
+// usually kept in a CMemFile, which can be seeked back to the beginning
+// and restored from again as many times as needed. A snapshot that can't
+// be read leaves the world as it was.
+//
+
+#ifndef CWORLD_H
+#define CWORLD_H
+
+#include "CArena.h"
+#include "CConfig.h"
+#include "CMissile.h"
+#include "CTarget.h"
+#include "Texture.h"
+
+class CGlView;
+class CTargetTrajectoryTable;
+class CTargetPath;
+class CVector2Batch;
+
+// A pair that's asleep because its missile hit its target
+struct SSleepingPair
+{
+    int                 m_Pair;
+    float               m_SleepTime;                // World time up to which their explosions have been counted down
+    float               m_WakeTime;                 // World time at which both will have finished exploding
+};
+
+// List of all of the keys that we're interested in
+enum eKey
+{
+    eKEY_MISSILE_THRUST = 0,
+    eKEY_MISSILE_TURN_LEFT,
+    eKEY_MISSILE_TURN_RIGHT,
+
+    eKEY_TARGET_MOVE_LEFT,
+    eKEY_TARGET_MOVE_RIGHT,
+    eKEY_TARGET_MOVE_UP,
+    eKEY_TARGET_MOVE_DOWN,
+
+    NUM_KEYS,
+};
+
+// Settings of the missile and target that can be changed from outside
+// the world, such as from the sliders on the dialog box. Control modes
+// are passed in as floats, cast from their enums.
+enum eWorldSetting
+{
+    eWORLD_SETTING_MISSILE_CONTROL_MODE = 0,
+    eWORLD_SETTING_TARGET_CONTROL_MODE,
+
+    eWORLD_SETTING_MISSILE_STEERING_P_COEFFICIENT,
+    eWORLD_SETTING_MISSILE_STEERING_I_COEFFICIENT,
+    eWORLD_SETTING_MISSILE_STEERING_D_COEFFICIENT,
+
+    eWORLD_SETTING_MISSILE_MAX_ACCELERATION,
+    eWORLD_SETTING_MISSILE_MAX_ANGULAR_ACCELERATION,
+    eWORLD_SETTING_MISSILE_ROTATIONAL_DRAG_FACTOR,
+    eWORLD_SETTING_MISSILE_PID_OUTPUT_SCALE,
+
+    eWORLD_SETTING_TARGET_MAX_SPEED,
+
+    NUM_WORLD_SETTINGS,
+};
+
+class CWorld
+{
+public:
+    CWorld(bool load_textures = true);
+    ~CWorld();
+
+    void                Restart(unsigned long random_seed);
+
+    void                BeginTimestep();
+    void                DoTimestep(float timestep);
+    void                EndTimestep();
+
+    void                HandleKeyboardState(eKey key, bool state);
+
+    void                SetSetting(eWorldSetting setting, float new_value);
+    float               GetSetting(eWorldSetting setting);
+
+    void                SetConfig(const CConfig *config);
+    const CConfig*      GetConfig()                                 { return &m_Config; }
+
+    void                SetTelemetryRecorder(CTelemetryRecorder *recorder);
+
+    float               GetTimeElapsed()                            { return m_TimeElapsed; }
+
+    float               GetSize();
+    CVector2*           GetCenter();
+
+    void                SetNumPairs(int num_pairs);
+    int                 GetNumPairs()                               { return m_NumPairs; }
+    int                 GetNumActivePairs()                         { return m_NumActivePairs; }
+    void                AdvanceTime(float timestep)                 { m_TimeElapsed += timestep; }
+    void                StepPairs(int first_active_pair, int num_active_pairs, float timestep);
+    void                UpdateSleepingPairs();
+
+    void                SetTargetTrajectories(const CTargetTrajectoryTable *table);
+    void                SetTargetPath(const CTargetPath *path);
+
+    CMissile*           GetMissile(int pair = 0)                    { ASSERT((pair >= 0) && (pair < m_NumPairs)); return &m_pMissile[pair]; }
+    CTarget*            GetTarget(int pair = 0)                     { ASSERT((pair >= 0) && (pair < m_NumPairs)); return &m_pTarget[pair]; }
+
+    void                GetMissilePositions(CVector2Batch *positions);
+    void                GetTargetPositions(CVector2Batch *positions);
+
+    CTexture*           GetMissileTexture(int index)                { ASSERT((index >= 0) && (index < NUM_MISSILE_TEXTURES)); return &m_MissileTexture[index]; }
+    CTexture*           GetTargetTexture(int index)                 { ASSERT((index >= 0) && (index < NUM_TARGET_TEXTURES)); return &m_TargetTexture[index]; }
+
+    int                 Draw(CGlView *gl_view);
+
+    void                SaveSnapshot(CFile *file);
+    bool                RestoreSnapshot(CFile *file);
+    void                Serialize(CArchive &archive);
+
+private:
+    void                LoadTextures();
+    void                ResetMissileAndTarget(int pair);
+    void                ResetPairLists();
+    void                CatchUpSleepingPairs();
+    bool                ReadSnapshot(CFile *file);
+
+    CConfig             m_Config;                   // Our tuning values
+    CVector2            m_Center;                   // Location of the center of our world
+    float               m_TimeElapsed;              // Total number of seconds that have been simulated
+
+    CArena              m_Arena;                    // Where everything below that there's one of per pair lives
+
+    CMissile*           m_pMissile;                 // Our missiles, one per pair
+    CTarget*            m_pTarget;                  // The targets the missiles are steering towards, one per pair
+    int                 m_NumPairs;                 // Number of missiles and targets
+
+    int*                m_pActivePair;              // Pairs that aren't asleep, in no particular order
+    int                 m_NumActivePairs;
+    bool*               m_pPairFellAsleep;          // Set by StepPairs() for each pair whose missile hits its target, until UpdateSleepingPairs() puts it to sleep
+    SSleepingPair*      m_pSleepingPair;            // Ring of sleeping pairs, oldest first
+    int                 m_FirstSleepingPair;        // Index in m_pSleepingPair of the oldest
+    int                 m_NumSleepingPairs;
+
+    CTelemetryRecorder* m_pTelemetryRecorder;       // Where our first missile records its steering. NULL if we're not recording.
+
+    CTexture            m_MissileTexture[NUM_MISSILE_TEXTURES];     // Textures shared by all of our missiles
+    CTexture            m_TargetTexture[NUM_TARGET_TEXTURES];       // Textures shared by all of our targets
+    bool                m_TexturesLoaded;                           // Have we read them in yet?
+};
+
+#endif
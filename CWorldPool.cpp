@@ -0,0 +1,138 @@
+//
+// A pool of worlds for sweeps and other parameter studies
+//
+
+#include "stdafx.h"
+#include "CWorldPool.h"
+#include "CWorld.h"
+
+CWorldPool::CWorldPool()
+{
+    m_pWorld            = NULL;
+    m_NumWorlds         = 0;
+    m_pCheckedInWorld   = NULL;
+    m_NumCheckedIn      = 0;
+
+    InitializeCriticalSection(&m_Lock);
+}
+
+CWorldPool::~CWorldPool()
+{
+    Destroy();
+
+    DeleteCriticalSection(&m_Lock);
+}
+
+//
+// Throw away any worlds we already have, and build num_worlds new ones,
+// all checked in. Don't call this while any worlds are checked out.
+//
+
+void CWorldPool::Create(int num_worlds)
+{
+    ASSERT(num_worlds > 0);
+
+    Destroy();
+
+    m_pWorld            = new CWorld*[num_worlds];
+    m_pCheckedInWorld   = new CWorld*[num_worlds];
+    m_NumWorlds         = num_worlds;
+
+    for (int i = 0; i < m_NumWorlds; i++)
+    {
+        m_pWorld[i]             = new CWorld(false);
+        m_pCheckedInWorld[i]    = m_pWorld[i];
+    }
+
+    m_NumCheckedIn = m_NumWorlds;
+}
+
+void CWorldPool::Destroy()
+{
+    ASSERT(m_NumCheckedIn == m_NumWorlds);
+
+    for (int i = 0; i < m_NumWorlds; i++)
+    {
+        delete m_pWorld[i];
+    }
+
+    delete [] m_pWorld;
+    delete [] m_pCheckedInWorld;
+
+    m_pWorld            = NULL;
+    m_NumWorlds         = 0;
+    m_pCheckedInWorld   = NULL;
+    m_NumCheckedIn      = 0;
+}
+
+//
+// Take one of our worlds, and set it up with num_pairs pairs at their
+// start positions, using config and random_seed, exactly as a new world
+// set up the same way would be. Returns NULL if every world is already
+// checked out.
+//
+
+CWorld* CWorldPool::CheckOut(int num_pairs, const CConfig *config, unsigned long random_seed)
+{
+    CWorld *world = NULL;
+
+    EnterCriticalSection(&m_Lock);
+
+    if (m_NumCheckedIn > 0)
+    {
+        world = m_pCheckedInWorld[--m_NumCheckedIn];
+    }
+
+    LeaveCriticalSection(&m_Lock);
+
+    if (!world)
+    {
+        TRACE("All %d worlds in the pool are checked out\n", m_NumWorlds);
+
+        return NULL;
+    }
+
+    // Nothing from whoever had it before survives this, since
+    // SetNumPairs() builds every missile and target afresh
+
+    world->SetNumPairs(num_pairs);
+    world->SetConfig(config);
+    world->Restart(random_seed);
+
+    return world;
+}
+
+//
+// Give back a world from CheckOut(), for someone else to use
+//
+
+void CWorldPool::CheckIn(CWorld *world)
+{
+    ASSERT(world);
+
+    // Whoever checks it out next won't expect to be recorded
+    world->SetTelemetryRecorder(NULL);
+
+    EnterCriticalSection(&m_Lock);
+
+    ASSERT(m_NumCheckedIn < m_NumWorlds);
+
+    m_pCheckedInWorld[m_NumCheckedIn++] = world;
+
+    LeaveCriticalSection(&m_Lock);
+}
+
+//
+// Number of worlds that are free to be checked out right now
+//
+
+int CWorldPool::GetNumCheckedIn()
+{
+    EnterCriticalSection(&m_Lock);
+
+    int num_checked_in = m_NumCheckedIn;
+
+    LeaveCriticalSection(&m_Lock);
+
+    return num_checked_in;
+}
@@ -0,0 +1,53 @@
+//
+// A pool of worlds for sweeps and other parameter studies, so that the
+// threads running them can check out a ready-made world for each
+// evaluation instead of building a new one.
+//
+// Every world in the pool is built once, up front, without loading its
+// textures. CheckOut() hands one over reset in place with the number of
+// pairs, config and random seed that the evaluation needs, which costs no
+// more than a Restart() once the world's arena is big enough. Hand it back
+// with CheckIn() when the evaluation is finished.
+//
+// Any thread can check worlds out and in at any time. Make the pool at
+// least as big as the number of threads using it; CheckOut() returns NULL
+// if every world is already checked out.
+//
+
+#ifndef CWORLDPOOL_H
+#define CWORLDPOOL_H
+
+class CConfig;
+class CWorld;
+
+class CWorldPool
+{
+public:
+    CWorldPool();
+    ~CWorldPool();
+
+    void                Create(int num_worlds);
+
+    CWorld*             CheckOut(int num_pairs, const CConfig *config, unsigned long random_seed);
+    void                CheckIn(CWorld *world);
+
+    int                 GetNumWorlds()                  { return m_NumWorlds; }
+    int                 GetNumCheckedIn();
+
+private:
+    // Not copyable, since we own our worlds
+    CWorldPool(const CWorldPool &pool);
+    CWorldPool&         operator=(const CWorldPool &pool);
+
+    void                Destroy();
+
+    CWorld**            m_pWorld;                   // Every world in the pool
+    int                 m_NumWorlds;
+
+    CWorld**            m_pCheckedInWorld;          // Stack of the worlds that aren't checked out, with room for all of them
+    int                 m_NumCheckedIn;
+
+    CRITICAL_SECTION    m_Lock;                     // Guards m_pCheckedInWorld and m_NumCheckedIn
+};
+
+#endif